@@ -0,0 +1,113 @@
+/******************************************************************************
+ Copyright (c) 2014 Gorka Surez Garca
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ DEALINGS IN THE SOFTWARE.
+******************************************************************************/
+
+#include "CheckersBitboard.h"
+
+//********************************************************************************
+// Constants
+//********************************************************************************
+
+const int DIRECTION_OFFSETS[CheckersBitboard::MAX_DIRECTIONS][2] = {
+    { -1, 1 }, { 1, 1 }, { 1, -1 }, { -1, -1 }
+};
+
+const CheckersBitboard::Bitboard DE_BRUIJN_MAGIC = 0x03F79D71B4CB0A89ULL;
+
+const int DE_BRUIJN_INDEX[64] = {
+     0, 47,  1, 56, 48, 27,  2, 60, 57, 49, 41, 37, 28, 16,  3, 61,
+    54, 58, 35, 52, 50, 42, 21, 44, 38, 32, 29, 23, 17, 11,  4, 62,
+    46, 55, 26, 59, 40, 36, 15, 53, 34, 51, 20, 43, 31, 22, 10, 45,
+    25, 39, 14, 33, 19, 30,  9, 24, 13, 18,  8, 12,  7,  6,  5, 63
+};
+
+//********************************************************************************
+// Static
+//********************************************************************************
+
+const int CheckersBitboard::SHIFTS[MAX_DIRECTIONS] = { 5, 6, -5, -6 };
+
+bool CheckersBitboard::initialized_ = false;
+
+int CheckersBitboard::neighbors_[MAX_SQUARES][MAX_DIRECTIONS][BOARD_SIZE];
+CheckersBitboard::Bitboard CheckersBitboard::rays_[MAX_SQUARES][MAX_DIRECTIONS][BOARD_SIZE];
+
+//********************************************************************************
+// Methods
+//********************************************************************************
+
+void CheckersBitboard::Initialize() {
+    if (initialized_) return;
+
+    // Walk each direction of each square until the border of the board.
+    for (int square = 0; square < MAX_SQUARES; ++square) {
+        auto coords = GetCoords(square);
+        bool valid = IsSet(FULL, square);
+        for (int i = 0; i < MAX_DIRECTIONS; ++i) {
+            neighbors_[square][i][0] = valid ? square : NO_SQUARE;
+            rays_[square][i][0] = EMPTY;
+            for (int distance = 1; distance < BOARD_SIZE; ++distance) {
+                int next = NO_SQUARE;
+                if (valid && neighbors_[square][i][distance - 1] != NO_SQUARE) {
+                    next = GetSquare(coords.y + DIRECTION_OFFSETS[i][1] * distance,
+                        coords.x + DIRECTION_OFFSETS[i][0] * distance);
+                }
+                neighbors_[square][i][distance] = next;
+                rays_[square][i][distance] = rays_[square][i][distance - 1] |
+                    (next != NO_SQUARE ? GetMask(next) : EMPTY);
+            }
+        }
+    }
+
+    initialized_ = true;
+}
+
+//--------------------------------------------------------------------------------
+
+int CheckersBitboard::Count(Bitboard victim) {
+    // Parallel bit count without any intrinsic, so it works in any platform.
+    victim = victim - ((victim >> 1) & 0x5555555555555555ULL);
+    victim = (victim & 0x3333333333333333ULL) + ((victim >> 2) & 0x3333333333333333ULL);
+    victim = (victim + (victim >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+    return static_cast<int>((victim * 0x0101010101010101ULL) >> 56);
+}
+
+//--------------------------------------------------------------------------------
+
+int CheckersBitboard::First(Bitboard victim) {
+    // De Bruijn multiplication over the bits until the first set one.
+    if (victim == EMPTY) return NO_SQUARE;
+    return DE_BRUIJN_INDEX[((victim ^ (victim - 1)) * DE_BRUIJN_MAGIC) >> 58];
+}
+
+//--------------------------------------------------------------------------------
+
+int CheckersBitboard::Last(Bitboard victim) {
+    // Fill all the bits under the last set one, then find the last one.
+    if (victim == EMPTY) return NO_SQUARE;
+    victim |= victim >> 1;
+    victim |= victim >> 2;
+    victim |= victim >> 4;
+    victim |= victim >> 8;
+    victim |= victim >> 16;
+    victim |= victim >> 32;
+    return DE_BRUIJN_INDEX[(victim * DE_BRUIJN_MAGIC) >> 58];
+}
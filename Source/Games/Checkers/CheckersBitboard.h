@@ -0,0 +1,171 @@
+/******************************************************************************
+ Copyright (c) 2014 Gorka Surez Garca
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ DEALINGS IN THE SOFTWARE.
+******************************************************************************/
+
+#ifndef __CHECKERS_BITBOARD_HEADER__
+#define __CHECKERS_BITBOARD_HEADER__
+
+#include <SFML/System/Vector2.hpp>
+
+/**
+ * This static class is a collection of board utility functions for the 50 dark
+ * cells of the checkers board. Each pair of rows uses 11 bits, with a ghost bit
+ * between the rows, so the diagonal steps are shifts of 5 and 6 bits and the steps
+ * that leave the board fall into a ghost bit or out of the 55 bits used.
+ */
+class CheckersBitboard {
+private:
+    CheckersBitboard() {}
+    ~CheckersBitboard() {}
+
+public:
+    //--------------------------------------------------------------------------------
+    // Types
+    //--------------------------------------------------------------------------------
+
+    typedef unsigned long long Bitboard;
+
+    //--------------------------------------------------------------------------------
+    // Constants
+    //--------------------------------------------------------------------------------
+
+    static const int BOARD_SIZE  = 10;
+    static const int MAX_SQUARES = 55;
+    static const int NO_SQUARE   = -1;
+
+    static const int UP_LEFT_DIRECTION    = 0;
+    static const int UP_RIGHT_DIRECTION   = 1;
+    static const int DOWN_RIGHT_DIRECTION = 2;
+    static const int DOWN_LEFT_DIRECTION  = 3;
+    static const int MAX_DIRECTIONS       = 4;
+
+    static const Bitboard EMPTY = 0ULL;
+    static const Bitboard FULL  = 0x007DFFBFF7FEFFDFULL;
+
+    static const Bitboard ROW_0 = 0x000000000000001FULL;
+    static const Bitboard ROW_9 = 0x007C000000000000ULL;
+
+    //--------------------------------------------------------------------------------
+    // Methods
+    //--------------------------------------------------------------------------------
+
+    static void Initialize();
+
+    /**
+     * Gets the square index of a cell, or NO_SQUARE when the cell isn't dark.
+     */
+    static int GetSquare(int row, int col) {
+        if (row < 0 || BOARD_SIZE <= row || col < 0 || BOARD_SIZE <= col ||
+            ((row + col) & 1) != 0) {
+            return NO_SQUARE;
+        }
+        return (row / 2) * 11 + ((row & 1) ? 5 + (col + 1) / 2 : col / 2);
+    }
+
+    /**
+     * Gets the square index of a cell, or NO_SQUARE when the cell isn't dark.
+     */
+    static int GetSquare(const sf::Vector2i & coords) {
+        return GetSquare(coords.y, coords.x);
+    }
+
+    /**
+     * Gets the cell coordinates of a square index.
+     */
+    static sf::Vector2i GetCoords(int square) {
+        int row = (square / 11) * 2, col = square % 11;
+        return col < 5 ? sf::Vector2i(col * 2, row) : sf::Vector2i((col - 5) * 2 - 1, row + 1);
+    }
+
+    /**
+     * Gets the board with only one square set.
+     */
+    static Bitboard GetMask(int square) {
+        return 1ULL << square;
+    }
+
+    /**
+     * Checks if a square is set inside a board.
+     */
+    static bool IsSet(Bitboard victim, int square) {
+        return (victim & (1ULL << square)) != EMPTY;
+    }
+
+    static int Count(Bitboard victim);
+    static int First(Bitboard victim);
+    static int Last(Bitboard victim);
+
+    /**
+     * Gets the first square of a board and removes it.
+     */
+    static int PopFirst(Bitboard & victim) {
+        int square = First(victim);
+        victim &= victim - 1;
+        return square;
+    }
+
+    /**
+     * Moves all the squares of a board one step in a direction.
+     */
+    static Bitboard Shift(Bitboard victim, int direction) {
+        int shift = SHIFTS[direction];
+        return (shift > 0 ? victim << shift : victim >> -shift) & FULL;
+    }
+
+    /**
+     * Checks if a direction goes to the higher squares of the board.
+     */
+    static bool IsForward(int direction) {
+        return SHIFTS[direction] > 0;
+    }
+
+    /**
+     * Gets the square at some distance in a direction, or NO_SQUARE.
+     */
+    static int Neighbor(int square, int direction, int distance) {
+        return neighbors_[square][direction][distance];
+    }
+
+    /**
+     * Gets the squares in a direction, from the next one to some distance.
+     */
+    static Bitboard Ray(int square, int direction, int distance) {
+        return rays_[square][direction][distance];
+    }
+
+private:
+    //--------------------------------------------------------------------------------
+    // Constants
+    //--------------------------------------------------------------------------------
+
+    static const int SHIFTS[MAX_DIRECTIONS];
+
+    //--------------------------------------------------------------------------------
+    // Fields
+    //--------------------------------------------------------------------------------
+
+    static bool initialized_;
+
+    static int neighbors_[MAX_SQUARES][MAX_DIRECTIONS][BOARD_SIZE];
+    static Bitboard rays_[MAX_SQUARES][MAX_DIRECTIONS][BOARD_SIZE];
+};
+
+#endif
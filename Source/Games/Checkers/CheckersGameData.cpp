@@ -21,6 +21,7 @@
 ******************************************************************************/
 
 #include "CheckersGameData.h"
+#include <algorithm>
 #include <System/MathUtil.h>
 #include <System/ForEach.h>
 
@@ -28,11 +29,36 @@
 // Constants
 //********************************************************************************
 
-const int LAST_WHITE_ROW = 9;
-const int LAST_BLACK_ROW = 0;
+const CheckersBitboard::Bitboard LAST_WHITE_ROW = CheckersBitboard::ROW_9;
+const CheckersBitboard::Bitboard LAST_BLACK_ROW = CheckersBitboard::ROW_0;
+
+const int MAX_QUEEN_DISTANCE = 7;
 
 const sf::Vector2i CheckersGameData::NO_CELL = sf::Vector2i(-1, -1);
 
+const int NORMAL_OFFSETS_SIZE = 6;
+const int QUEEN_OFFSETS_SIZE  = 28;
+
+const sf::Vector2i WHITE_OFFSETS[NORMAL_OFFSETS_SIZE] = {
+    sf::Vector2i(-1,  1), sf::Vector2i( 1,  1),
+    sf::Vector2i(-2,  2), sf::Vector2i( 2,  2), sf::Vector2i( 2, -2), sf::Vector2i(-2, -2)
+};
+
+const sf::Vector2i BLACK_OFFSETS[NORMAL_OFFSETS_SIZE] = {
+    sf::Vector2i( 1, -1), sf::Vector2i(-1, -1),
+    sf::Vector2i(-2,  2), sf::Vector2i( 2,  2), sf::Vector2i( 2, -2), sf::Vector2i(-2, -2)
+};
+
+const sf::Vector2i QUEEN_OFFSETS[QUEEN_OFFSETS_SIZE] = {
+    sf::Vector2i(-1,  1), sf::Vector2i( 1,  1), sf::Vector2i( 1, -1), sf::Vector2i(-1, -1),
+    sf::Vector2i(-2,  2), sf::Vector2i( 2,  2), sf::Vector2i( 2, -2), sf::Vector2i(-2, -2),
+    sf::Vector2i(-3,  3), sf::Vector2i( 3,  3), sf::Vector2i( 3, -3), sf::Vector2i(-3, -3),
+    sf::Vector2i(-4,  4), sf::Vector2i( 4,  4), sf::Vector2i( 4, -4), sf::Vector2i(-4, -4),
+    sf::Vector2i(-5,  5), sf::Vector2i( 5,  5), sf::Vector2i( 5, -5), sf::Vector2i(-5, -5),
+    sf::Vector2i(-6,  6), sf::Vector2i( 6,  6), sf::Vector2i( 6, -6), sf::Vector2i(-6, -6),
+    sf::Vector2i(-7,  7), sf::Vector2i( 7,  7), sf::Vector2i( 7, -7), sf::Vector2i(-7, -7)
+};
+
 //********************************************************************************
 // General Methods
 //********************************************************************************
@@ -50,14 +76,13 @@ void CheckersGameData::Start(bool singlePlayer, int difficulty, int playerSide)
 
 void CheckersGameData::Reset() {
     // Initialize the game board.
-    for (int i = 0, k = 1; i < BOARD_SIZE; ++i) {
-        for (int j = 0; j < BOARD_SIZE; ++j, ++k) {
+    whiteBoard_ = blackBoard_ = queenBoard_ = CheckersBitboard::EMPTY;
+    for (int i = 0; i < BOARD_SIZE; ++i) {
+        for (int j = 0; j < BOARD_SIZE; ++j) {
             if (i <= 3) {
-                board_[i][j] = IsWorldCell(i, j) ? WHITE_PIECE : EMPTY_CELL;
+                setCell(i, j, WHITE_PIECE);
             } else if (6 <= i) {
-                board_[i][j] = IsWorldCell(i, j) ? BLACK_PIECE : EMPTY_CELL;
-            } else {
-                board_[i][j] = EMPTY_CELL;
+                setCell(i, j, BLACK_PIECE);
             }
         }
     }
@@ -74,7 +99,7 @@ void CheckersGameData::Reset() {
 void CheckersGameData::ForEachInBoard(std::function<void (int, int, int)> operation) {
     for (int i = 0; i < BOARD_SIZE; ++i) {
         for (int j = 0; j < BOARD_SIZE; ++j) {
-            operation(board_[i][j], i, j);
+            operation(getCell(i, j), i, j);
         }
     }
 }
@@ -110,14 +135,14 @@ void CheckersGameData::NextTurn() {
 
 //--------------------------------------------------------------------------------
 
-int CheckersGameData::CountPieces(int side) {
-    int count = 0;
-    ForEachInBoard([&] (int victim, int i, int j) {
-        if (IsPieceSide(victim, side)) {
-            ++count;
-        }
-    });
-    return count;
+int CheckersGameData::CountPieces(int side) const {
+    return CheckersBitboard::Count(getSideBoard(side));
+}
+
+//--------------------------------------------------------------------------------
+
+int CheckersGameData::CountQueens(int side) const {
+    return CheckersBitboard::Count(getSideBoard(side) & queenBoard_);
 }
 
 //********************************************************************************
@@ -125,111 +150,17 @@ int CheckersGameData::CountPieces(int side) {
 //********************************************************************************
 
 void CheckersGameData::GetPieceMoveOffsets(int piece, CoordsVector & offsets) const {
-    offsets.clear();
-    switch (piece) {
-    case WHITE_PIECE:
-        offsets.push_back(sf::Vector2i(-1,  1));
-        offsets.push_back(sf::Vector2i( 1,  1));
-        offsets.push_back(sf::Vector2i(-2,  2));
-        offsets.push_back(sf::Vector2i( 2,  2));
-        offsets.push_back(sf::Vector2i( 2, -2));
-        offsets.push_back(sf::Vector2i(-2, -2));
-        break;
-    case BLACK_PIECE:
-        offsets.push_back(sf::Vector2i( 1, -1));
-        offsets.push_back(sf::Vector2i(-1, -1));
-        offsets.push_back(sf::Vector2i(-2,  2));
-        offsets.push_back(sf::Vector2i( 2,  2));
-        offsets.push_back(sf::Vector2i( 2, -2));
-        offsets.push_back(sf::Vector2i(-2, -2));
-        break;
-    case WHITE_QUEEN_PIECE:
-    case BLACK_QUEEN_PIECE:
-        offsets.push_back(sf::Vector2i(-1,  1));
-        offsets.push_back(sf::Vector2i( 1,  1));
-        offsets.push_back(sf::Vector2i( 1, -1));
-        offsets.push_back(sf::Vector2i(-1, -1));
-        offsets.push_back(sf::Vector2i(-2,  2));
-        offsets.push_back(sf::Vector2i( 2,  2));
-        offsets.push_back(sf::Vector2i( 2, -2));
-        offsets.push_back(sf::Vector2i(-2, -2));
-        offsets.push_back(sf::Vector2i(-3,  3));
-        offsets.push_back(sf::Vector2i( 3,  3));
-        offsets.push_back(sf::Vector2i( 3, -3));
-        offsets.push_back(sf::Vector2i(-3, -3));
-        offsets.push_back(sf::Vector2i(-4,  4));
-        offsets.push_back(sf::Vector2i( 4,  4));
-        offsets.push_back(sf::Vector2i( 4, -4));
-        offsets.push_back(sf::Vector2i(-4, -4));
-        offsets.push_back(sf::Vector2i(-5,  5));
-        offsets.push_back(sf::Vector2i( 5,  5));
-        offsets.push_back(sf::Vector2i( 5, -5));
-        offsets.push_back(sf::Vector2i(-5, -5));
-        offsets.push_back(sf::Vector2i(-6,  6));
-        offsets.push_back(sf::Vector2i( 6,  6));
-        offsets.push_back(sf::Vector2i( 6, -6));
-        offsets.push_back(sf::Vector2i(-6, -6));
-        offsets.push_back(sf::Vector2i(-7,  7));
-        offsets.push_back(sf::Vector2i( 7,  7));
-        offsets.push_back(sf::Vector2i( 7, -7));
-        offsets.push_back(sf::Vector2i(-7, -7));
-        break;
-    }
+    int size;
+    auto victims = getPieceMoveOffsets(piece, size);
+    offsets.assign(victims, victims + size);
 }
 
 //--------------------------------------------------------------------------------
 
 void CheckersGameData::GetPossibleMoves(CoordsVector & victims, int r, int c) const {
-    victims.clear();
-    if (IsInside(r, c)) {
-        // We'll only get the possible moves of a piece inside the board.
-        auto piece = board_[r][c];
-        auto orig = sf::Vector2i(c, r);
-
-        // Here we'll get the piece move offsets to calculate the next moves.
-        CoordsVector offsets;
-        GetPieceMoveOffsets(piece, offsets);
-        CoordsVector movesWithKill, movesNormal;
-
-        // For each offset we'll validate the possible destination move.
-        // We also will differentiate between a normal move and a kill move.
-        ForEach(offsets, [&] (const sf::Vector2i & item) {
-            auto dest = orig + item;
-            auto validation = ValidateMove(orig, dest);
-            if (validation == MOVE_VALID_WITH_KILL) {
-                movesWithKill.push_back(dest);
-            } else if (validation == MOVE_VALID) {
-                movesNormal.push_back(dest);
-            }
-        });
-
-        // If we doesn't have any kill move, we'll get the normal ones.
-        // Otherwise we have to take the kill moves because is mandatory to
-        // kill if there is an option in the checkers game.
-        if (movesWithKill.empty()) {
-            victims = movesNormal;
-        } else if (IsNormalPiece(piece)) {
-            victims = movesWithKill;
-        } else {
-            // There is also a differentiation factor when the piece that
-            // kills is a queen. In that case we'll get only the moves
-            // that have a second kill if exists. Otherwise we'll get all
-            // the other kill moves.
-            CoordsVector movesWithSecondKill;
-            ForEach(movesWithKill, [&] (const sf::Vector2i & item) {
-                CheckersGameData future(*this);
-                future.MakeMove(orig, item);
-                if (!future.LastTurnFinished()) {
-                    movesWithSecondKill.push_back(item);
-                }
-            });
-            if (movesWithSecondKill.empty()) {
-                victims = movesWithKill;
-            } else {
-                victims = movesWithSecondKill;
-            }
-        }
-    }
+    sf::Vector2i moves[MAX_OFFSETS];
+    int size = getPossibleMoves(moves, r, c);
+    victims.assign(moves, moves + size);
 }
 
 void CheckersGameData::GetPossibleMoves(CoordsVector & victims, const sf::Vector2i & coords) const {
@@ -241,41 +172,15 @@ void CheckersGameData::GetPossibleMoves(CoordsVector & victims, const sf::Vector
 void CheckersGameData::CalculateCandidates() {
     candidates_.clear();
     if (nextPieceToMove_ == NO_CELL) {
-        // First, get all the pieces coordinates of the correct side.
-        CoordsVector pieces;
-        if (turn_ == WHITE_SIDE) {
-            ForEachInBoard([&] (int victim, int i, int j) {
-                if (IsWhitePiece(victim)) {
-                    pieces.push_back(sf::Vector2i(j, i));
-                }
-            });
-        } else if (turn_ == BLACK_SIDE) {
-            ForEachInBoard([&] (int victim, int i, int j) {
-                if (IsBlackPiece(victim)) {
-                    pieces.push_back(sf::Vector2i(j, i));
-                }
-            });
-        }
-
-        // Second, check if any of those pieces can move or kill.
-        CoordsVector piecesWithKill, piecesWithMove;
-        ForEach(pieces, [&] (const sf::Vector2i & item) {
-            auto result = CanPieceMoveOrKill(item);
-            if (result == CAN_KILL) {
-                piecesWithKill.push_back(item);
-            } else if (result == CAN_ONLY_MOVE) {
-                piecesWithMove.push_back(item);
-            }
-
-        });
+        // First, get the pieces of the correct side that can move or kill.
+        Bitboard killers, movers = getMovers(turn_, killers);
 
         // If we doesn't have any piece with a kill move, we'll get all the
         // others with only move. Otherwise we have to take the kill moves
         // because is mandatory to kill if there is an option in the game.
-        if (piecesWithKill.empty()) {
-            candidates_ = piecesWithMove;
-        } else {
-            candidates_ = piecesWithKill;
+        auto pieces = killers != CheckersBitboard::EMPTY ? killers : movers;
+        while (pieces != CheckersBitboard::EMPTY) {
+            candidates_.push_back(CheckersBitboard::GetCoords(CheckersBitboard::PopFirst(pieces)));
         }
 
         // If at the end of the process we don't have any candidate
@@ -292,35 +197,18 @@ void CheckersGameData::CalculateCandidates() {
 //--------------------------------------------------------------------------------
 
 int CheckersGameData::CanPieceMoveOrKill(int r, int c) const {
-    if (IsInside(r, c)) {
-        // Only check pieces inside the board of the current playing side.
-        auto piece = board_[r][c];
-        if (IsTurnPiece(piece)) {
-            // Get the piece move offsets to calculate the next moves.
-            CoordsVector offsets;
-            GetPieceMoveOffsets(piece, offsets);
-
-            // For each offset we'll validate the possible destination move.
-            // We also will differentiate between a normal move and a kill
-            // move. If a normal move is found, we'll update a flag to return
-            // at the end the "can only move" value. We have to continue
-            // seeking for a kill move, but when one of this is found we'll
-            // return the result of the method; because kill is mandatory.
-            bool canMove = false;
-            auto orig = sf::Vector2i(c, r);
-            auto i = offsets.begin(), end = offsets.end();
-            for (; i != end; ++i) {
-                auto dest = orig + *i;
-                auto validation = ValidateMove(orig, dest);
-                if (validation == MOVE_VALID_WITH_KILL) {
-                    return CAN_KILL;
-                } else if (validation == MOVE_VALID) {
-                    canMove = true;
-                }
-            }
-            if (canMove) {
-                return CAN_ONLY_MOVE;
-            }
+    // Only check pieces inside the board of the current playing side.
+    auto piece = getCell(r, c);
+    if (IsTurnPiece(piece)) {
+        // Get the moves of the piece, when there is a kill move we'll return
+        // it, because kill is mandatory.
+        Bitboard moves, kills;
+        getPieceMoves(CheckersBitboard::GetSquare(r, c), IsQueenPiece(piece), turn_,
+            getSideBoard(turn_), getSideBoard(GetOppositeSide(turn_)), moves, kills);
+        if (kills != CheckersBitboard::EMPTY) {
+            return CAN_KILL;
+        } else if (moves != CheckersBitboard::EMPTY) {
+            return CAN_ONLY_MOVE;
         }
     }
     return CAN_DO_NOTHING;
@@ -336,8 +224,8 @@ int CheckersGameData::ValidateMove(int r1, int c1, int r2, int c2) const {
     if (IsInside(r1, c1) && IsInside(r2, c2)) {
         // We can only validate a move when the origin and the
         // destination are inside the board.
-        auto piece = board_[r1][c1];
-        auto destination = board_[r2][c2];
+        auto piece = getCell(r1, c1);
+        auto destination = getCell(r2, c2);
         if (IsTurnPiece(piece) && destination == EMPTY_CELL) {
             // The origin piece must be a piece of the current turn's
             // side and the destination must be empty. Then we'll check
@@ -376,82 +264,362 @@ int CheckersGameData::ValidateMove(const sf::Vector2i & c1, const sf::Vector2i &
 //--------------------------------------------------------------------------------
 
 void CheckersGameData::MakeMove(int r1, int c1, int r2, int c2) {
-    bool killedByDeath = false;
-    if (IsInside(r1, c1) && IsInside(r2, c2)) {
-        // We can only move when the origin and the destination are inside the board.
-        auto piece = board_[r1][c1];
-        auto destination = board_[r2][c2];
-        if (IsTurnPiece(piece) && destination == EMPTY_CELL) {
-            // The origin must be a piece of the current turn's side and the destination
-            // must be empty. Then we'll check the delta of the current move.
-            auto deltar = std::abs(r1 - r2), deltac = std::abs(c1 - c2);
-            if (deltar == deltac) {
-                auto movePiece = [&] () {
-                    board_[r2][c2] = piece;
-                    board_[r1][c1] = EMPTY_CELL;
-                    nextPieceToMove_ = NO_CELL;
-                };
-                auto setNextPieceToMove = [&] () {
-                    // Set the next piece to move when it can kill after being moved.
-                    if (CanPieceMoveOrKill(r2, c2) == CAN_KILL) {
-                        nextPieceToMove_ = sf::Vector2i(c2, r2);
-                    }
-                };
-                if (deltar > 1) {
-                    // With a delta greater than 1 we have to check if
-                    // there are enemies in between of the "long" move.
-                    CoordsVector enemies;
-                    int enemyCount = countEnemiesBetween(r1, c1, r2, c2,
-                        [&] (const sf::Vector2i & item) { enemies.push_back(item); });
-
-                    if (IsQueenPiece(piece)) {
-                        // If the piece is a queen we'll check if we're making
-                        // a long move without kill or simply killing an enemy.
-                        if (0 == enemyCount) {
-                            movePiece();
-                        } else if (enemyCount == 1) {
-                            movePiece();
-                            killedByDeath = true;
-                        }
-                    } else if (enemyCount == 1 && deltar == 2) {
-                        // The normal pieces must kill somebody and the delta
-                        // cannot be more than 2 cells. It also have to check
-                        // if the moved piece must be transform into queen.
-                        movePiece();
-                        checkAndTransform(r2, c2);
-                        killedByDeath = true;
-                    }
+    // Only a valid move changes the board, the invalid ones are ignored.
+    if (ValidateMove(r1, c1, r2, c2) != MOVE_INVALID) {
+        doStep(CheckersBitboard::GetSquare(r1, c1), CheckersBitboard::GetSquare(r2, c2));
+    }
+}
+
+void CheckersGameData::MakeMove(const sf::Vector2i & c1, const sf::Vector2i & c2) {
+    MakeMove(c1.y, c1.x, c2.y, c2.x);
+}
+
+//********************************************************************************
+// Search Methods
+//********************************************************************************
+
+void CheckersGameData::GetAllMoves(CheckersMoveVector & moves) {
+    moves.clear();
+    if (winner_ == NO_WINNER) {
+        CheckersMove move;
+        if (nextPieceToMove_ == NO_CELL) {
+            // If any piece can kill, only the pieces with a kill move are candidates,
+            // because is mandatory to kill. Then get all the moves of each candidate.
+            Bitboard killers, movers = getMovers(turn_, killers);
+            auto pieces = killers != CheckersBitboard::EMPTY ? killers : movers;
+            while (pieces != CheckersBitboard::EMPTY) {
+                getAllMoves(CheckersBitboard::GetCoords(CheckersBitboard::PopFirst(pieces)),
+                    move, moves);
+            }
+        } else {
+            // You still have moves to do with the previous killer piece.
+            getAllMoves(nextPieceToMove_, move, moves);
+        }
+    }
+}
+
+//--------------------------------------------------------------------------------
+
+void CheckersGameData::DoMove(const CheckersMove & move, MoveUndo & undo) {
+    saveState(undo);
+    for (int i = 0; i < move.size; ++i) {
+        doStep(CheckersBitboard::GetSquare(move.steps[i].origin),
+            CheckersBitboard::GetSquare(move.steps[i].destination));
+    }
+    // Change the turn like NextTurn, but the candidates are not needed in a search,
+    // so we'll only check if the next side can move to know if it lose the game.
+    if (winner_ == NO_WINNER) {
+        if (nextPieceToMove_ == NO_CELL) {
+            turn_ = GetOppositeSide(turn_);
+        }
+        if (!anyCandidate()) {
+            SetWinner(GetOppositeSide(turn_));
+        }
+    }
+}
+
+//--------------------------------------------------------------------------------
+
+void CheckersGameData::UndoMove(const MoveUndo & undo) {
+    restoreState(undo);
+}
+
+//********************************************************************************
+// Private Methods
+//********************************************************************************
+
+int CheckersGameData::getCell(int r, int c) const {
+    int square = CheckersBitboard::GetSquare(r, c);
+    if (square != CheckersBitboard::NO_SQUARE) {
+        bool queen = CheckersBitboard::IsSet(queenBoard_, square);
+        if (CheckersBitboard::IsSet(whiteBoard_, square)) {
+            return queen ? WHITE_QUEEN_PIECE : WHITE_PIECE;
+        } else if (CheckersBitboard::IsSet(blackBoard_, square)) {
+            return queen ? BLACK_QUEEN_PIECE : BLACK_PIECE;
+        }
+    }
+    return EMPTY_CELL;
+}
+
+//--------------------------------------------------------------------------------
 
-                    if (killedByDeath) {
-                        // After set a kill, we'll remove the victim.
-                        auto & enemy = enemies[0];
-                        board_[enemy.y][enemy.x] = EMPTY_CELL;
-                        // Here we check if we need to set the next piece to move.
-                        setNextPieceToMove();
+void CheckersGameData::setCell(int r, int c, int piece) {
+    // The light cells of the board are always empty.
+    int square = CheckersBitboard::GetSquare(r, c);
+    if (square != CheckersBitboard::NO_SQUARE) {
+        auto mask = CheckersBitboard::GetMask(square);
+        whiteBoard_ &= ~mask;
+        blackBoard_ &= ~mask;
+        queenBoard_ &= ~mask;
+        if (IsWhitePiece(piece)) whiteBoard_ |= mask;
+        if (IsBlackPiece(piece)) blackBoard_ |= mask;
+        if (IsQueenPiece(piece)) queenBoard_ |= mask;
+    }
+}
+
+//--------------------------------------------------------------------------------
+
+CheckersGameData::Bitboard CheckersGameData::getSideBoard(int side) const {
+    if (side == WHITE_SIDE) {
+        return whiteBoard_;
+    } else if (side == BLACK_SIDE) {
+        return blackBoard_;
+    } else {
+        return CheckersBitboard::EMPTY;
+    }
+}
+
+//--------------------------------------------------------------------------------
+
+const sf::Vector2i * CheckersGameData::getPieceMoveOffsets(int piece, int & size) {
+    switch (piece) {
+    case WHITE_PIECE:
+        size = NORMAL_OFFSETS_SIZE;
+        return WHITE_OFFSETS;
+    case BLACK_PIECE:
+        size = NORMAL_OFFSETS_SIZE;
+        return BLACK_OFFSETS;
+    case WHITE_QUEEN_PIECE:
+    case BLACK_QUEEN_PIECE:
+        size = QUEEN_OFFSETS_SIZE;
+        return QUEEN_OFFSETS;
+    }
+    size = 0;
+    return nullptr;
+}
+
+//--------------------------------------------------------------------------------
+
+int CheckersGameData::getDirection(int from, int to, int & distance) {
+    auto orig = CheckersBitboard::GetCoords(from), dest = CheckersBitboard::GetCoords(to);
+    distance = std::abs(dest.y - orig.y);
+    if (dest.y > orig.y) {
+        return dest.x < orig.x ? CheckersBitboard::UP_LEFT_DIRECTION :
+                                 CheckersBitboard::UP_RIGHT_DIRECTION;
+    } else {
+        return dest.x > orig.x ? CheckersBitboard::DOWN_RIGHT_DIRECTION :
+                                 CheckersBitboard::DOWN_LEFT_DIRECTION;
+    }
+}
+
+//--------------------------------------------------------------------------------
+
+void CheckersGameData::getPieceMoves(int square, bool queen, int side, Bitboard own,
+    Bitboard enemies, Bitboard & moves, Bitboard & kills) {
+    moves = kills = CheckersBitboard::EMPTY;
+    auto empty = CheckersBitboard::FULL & ~(own | enemies);
+    if (queen) {
+        // The queens fly over the empty cells until the first piece of each ray.
+        // When that piece is an enemy, the empty cells after it are kill moves.
+        for (int i = 0; i < CheckersBitboard::MAX_DIRECTIONS; ++i) {
+            auto ray = CheckersBitboard::Ray(square, i, MAX_QUEEN_DISTANCE);
+            auto pieces = ray & ~empty;
+            if (pieces == CheckersBitboard::EMPTY) {
+                moves |= ray;
+            } else {
+                bool forward = CheckersBitboard::IsForward(i);
+                int first = forward ? CheckersBitboard::First(pieces) : CheckersBitboard::Last(pieces);
+                auto after = CheckersBitboard::Ray(first, i, BOARD_SIZE - 1);
+                moves |= ray & ~after & ~CheckersBitboard::GetMask(first);
+                if (CheckersBitboard::IsSet(enemies, first)) {
+                    auto targets = ray & after;
+                    pieces = targets & ~empty;
+                    if (pieces != CheckersBitboard::EMPTY) {
+                        int second = forward ? CheckersBitboard::First(pieces) :
+                                               CheckersBitboard::Last(pieces);
+                        targets &= ~CheckersBitboard::Ray(second, i, BOARD_SIZE - 1) &
+                                   ~CheckersBitboard::GetMask(second);
                     }
-                } else if (deltar == 1) {
-                    // If the delta is 1 we'll validate a normal move.
-                    movePiece();
-                    checkAndTransform(r2, c2);
+                    kills |= targets;
                 }
             }
         }
+    } else {
+        // The normal pieces move one cell forward, but they kill in any direction.
+        auto piece = CheckersBitboard::GetMask(square);
+        for (int i = 0; i < CheckersBitboard::MAX_DIRECTIONS; ++i) {
+            auto next = CheckersBitboard::Shift(piece, i);
+            if (CheckersBitboard::IsForward(i) == (side == WHITE_SIDE)) {
+                moves |= next & empty;
+            }
+            kills |= CheckersBitboard::Shift(next & enemies, i) & empty;
+        }
     }
+}
 
-    if (killedByDeath) {
-        // After any kind of kill, we'll check if there is any winner.
-        int whiteCount = CountPieces(WHITE_SIDE);
-        int blackCount = CountPieces(BLACK_SIDE);
-        if (whiteCount < 1) {
-            SetWinner(BLACK_SIDE);
-        } else if (blackCount < 1) {
-            SetWinner(WHITE_SIDE);
+//--------------------------------------------------------------------------------
+
+bool CheckersGameData::hasSecondKill(int from, int to) const {
+    // Move the queen and remove the victim, then check if it can kill again.
+    int distance, direction = getDirection(from, to, distance);
+    auto own = getSideBoard(turn_), enemies = getSideBoard(GetOppositeSide(turn_));
+    auto victims = CheckersBitboard::Ray(from, direction, distance - 1) & enemies;
+    own ^= CheckersBitboard::GetMask(from) | CheckersBitboard::GetMask(to);
+    enemies &= ~victims;
+    Bitboard moves, kills;
+    getPieceMoves(to, true, turn_, own, enemies, moves, kills);
+    return kills != CheckersBitboard::EMPTY;
+}
+
+//--------------------------------------------------------------------------------
+
+int CheckersGameData::getPossibleMoves(sf::Vector2i * victims, int r, int c) const {
+    int size = 0;
+    auto piece = getCell(r, c);
+    if (IsTurnPiece(piece)) {
+        // We'll only get the possible moves of a piece of the current turn.
+        int square = CheckersBitboard::GetSquare(r, c);
+        bool queen = IsQueenPiece(piece);
+        Bitboard moves, kills;
+        getPieceMoves(square, queen, turn_, getSideBoard(turn_),
+            getSideBoard(GetOppositeSide(turn_)), moves, kills);
+
+        // The moves are sorted with the offsets of the piece. If we doesn't have any
+        // kill move, we'll get the normal ones. Otherwise we have to take the kill
+        // moves because is mandatory to kill if there is an option in the game.
+        int offsetsSize;
+        auto offsets = getPieceMoveOffsets(piece, offsetsSize);
+        auto targets = kills != CheckersBitboard::EMPTY ? kills : moves;
+        auto orig = sf::Vector2i(c, r);
+        for (int pass = 0; pass < 2 && size == 0; ++pass) {
+            // There is also a differentiation factor when the piece that kills is a
+            // queen. In that case we'll get only the moves that have a second kill
+            // if exists. Otherwise we'll get all the other kill moves.
+            bool onlySecondKills = pass == 0 && queen && kills != CheckersBitboard::EMPTY;
+            for (int i = 0; i < offsetsSize; ++i) {
+                auto dest = orig + offsets[i];
+                int target = CheckersBitboard::GetSquare(dest);
+                if (target != CheckersBitboard::NO_SQUARE &&
+                    CheckersBitboard::IsSet(targets, target) &&
+                    (!onlySecondKills || hasSecondKill(square, target))) {
+                    victims[size++] = dest;
+                }
+            }
         }
     }
+    return size;
 }
 
-void CheckersGameData::MakeMove(const sf::Vector2i & c1, const sf::Vector2i & c2) {
-    MakeMove(c1.y, c1.x, c2.y, c2.x);
+//--------------------------------------------------------------------------------
+
+void CheckersGameData::getAllMoves(const sf::Vector2i & piece, CheckersMove & move,
+    CheckersMoveVector & moves) {
+    // Get all the possible moves of the current candidate.
+    sf::Vector2i destinations[MAX_OFFSETS];
+    int size = getPossibleMoves(destinations, piece.y, piece.x);
+    // For each possible move, make the step and if the turn is finished, add the
+    // move to the vector. Otherwise get deep in the chain of kills.
+    MoveUndo undo;
+    saveState(undo);
+    int origin = CheckersBitboard::GetSquare(piece);
+    for (int i = 0; i < size; ++i) {
+        auto & destination = destinations[i];
+        auto victim = doStep(origin, CheckersBitboard::GetSquare(destination));
+        move.steps[move.size++] = CheckersMoveStep(piece, destination, victim);
+        if (nextPieceToMove_ == NO_CELL) {
+            moves.push_back(move);
+        } else {
+            getAllMoves(destination, move, moves);
+        }
+        --move.size;
+        restoreState(undo);
+    }
+}
+
+//--------------------------------------------------------------------------------
+
+CheckersGameData::Bitboard CheckersGameData::getMovers(int side, Bitboard & killers) const {
+    // The normal pieces are checked all together with shifts of the whole board,
+    // in the opposite direction, from the destination cells to the pieces.
+    auto own = getSideBoard(side), enemies = getSideBoard(GetOppositeSide(side));
+    auto empty = CheckersBitboard::FULL & ~(own | enemies);
+    auto normals = own & ~queenBoard_, queens = own & queenBoard_;
+    Bitboard movers = CheckersBitboard::EMPTY;
+    killers = CheckersBitboard::EMPTY;
+    for (int i = 0; i < CheckersBitboard::MAX_DIRECTIONS; ++i) {
+        int back = (i + 2) % CheckersBitboard::MAX_DIRECTIONS;
+        auto previous = CheckersBitboard::Shift(empty, back);
+        if (CheckersBitboard::IsForward(i) == (side == WHITE_SIDE)) {
+            movers |= previous & normals;
+        }
+        killers |= CheckersBitboard::Shift(previous & enemies, back) & normals;
+    }
+    // The queens are checked one by one with their rays.
+    while (queens != CheckersBitboard::EMPTY) {
+        int square = CheckersBitboard::PopFirst(queens);
+        Bitboard moves, kills;
+        getPieceMoves(square, true, side, own, enemies, moves, kills);
+        if (moves != CheckersBitboard::EMPTY) movers |= CheckersBitboard::GetMask(square);
+        if (kills != CheckersBitboard::EMPTY) killers |= CheckersBitboard::GetMask(square);
+    }
+    return movers | killers;
+}
+
+//--------------------------------------------------------------------------------
+
+bool CheckersGameData::anyCandidate() const {
+    Bitboard killers;
+    return getMovers(turn_, killers) != CheckersBitboard::EMPTY;
+}
+
+//--------------------------------------------------------------------------------
+
+void CheckersGameData::saveState(MoveUndo & undo) const {
+    undo.whiteBoard = whiteBoard_;
+    undo.blackBoard = blackBoard_;
+    undo.queenBoard = queenBoard_;
+    undo.nextPieceToMove = nextPieceToMove_;
+    undo.winner = winner_;
+    undo.turn = turn_;
+}
+
+//--------------------------------------------------------------------------------
+
+void CheckersGameData::restoreState(const MoveUndo & undo) {
+    whiteBoard_ = undo.whiteBoard;
+    blackBoard_ = undo.blackBoard;
+    queenBoard_ = undo.queenBoard;
+    nextPieceToMove_ = undo.nextPieceToMove;
+    winner_ = undo.winner;
+    turn_ = undo.turn;
+}
+
+//--------------------------------------------------------------------------------
+
+sf::Vector2i CheckersGameData::doStep(int from, int to) {
+    // With a "long" move, the only piece in the trajectory is the enemy to kill.
+    int distance, direction = getDirection(from, to, distance);
+    bool white = CheckersBitboard::IsSet(whiteBoard_, from);
+    auto & own = white ? whiteBoard_ : blackBoard_;
+    auto & enemies = white ? blackBoard_ : whiteBoard_;
+    auto victims = CheckersBitboard::Ray(from, direction, distance - 1) & enemies;
+
+    // Move the piece and check if it must be transformed into queen.
+    auto fromMask = CheckersBitboard::GetMask(from), toMask = CheckersBitboard::GetMask(to);
+    own ^= fromMask | toMask;
+    if (queenBoard_ & fromMask) {
+        queenBoard_ ^= fromMask | toMask;
+    } else if (toMask & (white ? LAST_WHITE_ROW : LAST_BLACK_ROW)) {
+        queenBoard_ |= toMask;
+    }
+    nextPieceToMove_ = NO_CELL;
+
+    if (victims != CheckersBitboard::EMPTY) {
+        // After set a kill, we'll remove the victim and check if we need to set
+        // the next piece to move.
+        enemies &= ~victims;
+        queenBoard_ &= ~victims;
+        auto dest = CheckersBitboard::GetCoords(to);
+        if (CanPieceMoveOrKill(dest.y, dest.x) == CAN_KILL) {
+            nextPieceToMove_ = dest;
+        }
+        // And then we'll check if there is any winner.
+        if (enemies == CheckersBitboard::EMPTY) {
+            SetWinner(white ? WHITE_SIDE : BLACK_SIDE);
+        }
+        return CheckersBitboard::GetCoords(CheckersBitboard::First(victims));
+    }
+    return NO_CELL;
 }
 
 //--------------------------------------------------------------------------------
@@ -465,7 +633,7 @@ int CheckersGameData::countEnemiesBetween(int r1, int c1, int r2, int c2,
     // Set some initial data to execute the algorithm.
     auto offset = sf::Vector2i(c2 - c1 < 0 ? -1 : 1, r2 - r1 < 0 ? -1 : 1);
     auto orig = sf::Vector2i(c1, r1), dest = sf::Vector2i(c2, r2);
-    int pieceSide = GetPieceSide(board_[r1][c1]);
+    int pieceSide = GetPieceSide(getCell(r1, c1));
     int enemySide = GetOppositeSide(pieceSide);
     int enemyCount = 0;
     // We'll go from the next cell from the origin to the destination.
@@ -473,7 +641,7 @@ int CheckersGameData::countEnemiesBetween(int r1, int c1, int r2, int c2,
         // For each piece inside the trajectory, if we found a piece of our
         // own side, we won't be able to move. Otherwise we'll count the
         // enemies found in the path.
-        auto item = board_[i.y][i.x];
+        auto item = getCell(i.y, i.x);
         auto itemSide = GetPieceSide(item);
         if (itemSide == pieceSide) {
             return -1;
@@ -487,19 +655,6 @@ int CheckersGameData::countEnemiesBetween(int r1, int c1, int r2, int c2,
 
 //--------------------------------------------------------------------------------
 
-void CheckersGameData::checkAndTransform(int r, int c) {
-    // We take the piece from the board and check the type and the side.
-    // If the piece is in the last row, it will be transformed.
-    auto piece = board_[r][c];
-    if (IsNormalPiece(piece)) {
-        if (IsWhitePiece(piece) && r == LAST_WHITE_ROW) {
-            board_[r][c] = WHITE_QUEEN_PIECE;
-        } else if (IsBlackPiece(piece) && r == LAST_BLACK_ROW) {
-            board_[r][c] = BLACK_QUEEN_PIECE;
-        }
-    }
-}
-
 //********************************************************************************
 // Query Methods
 //********************************************************************************
@@ -557,11 +712,12 @@ bool CheckersGameData::IsTurnPiece(int piece) const {
 //--------------------------------------------------------------------------------
 
 bool CheckersGameData::IsPlayerPiece(int r, int c, int side) const {
-    if (IsInside(r, c) && board_[r][c] != EMPTY_CELL) {
+    auto piece = getCell(r, c);
+    if (IsInside(r, c) && piece != EMPTY_CELL) {
         if (side == WHITE_SIDE) {
-            return IsWhitePiece(board_[r][c]);
+            return IsWhitePiece(piece);
         } else if (side == BLACK_SIDE) {
-            return IsBlackPiece(board_[r][c]);
+            return IsBlackPiece(piece);
         } else {
             return false;
         }
@@ -628,7 +784,10 @@ bool CheckersGameData::IsCandidate(const sf::Vector2i & coords) const {
 
 CheckersGameData::CheckersGameData() : singlePlayer_(false), difficulty_(NORMAL_LEVEL),
     playerSide_(WHITE_SIDE), winner_(NO_WINNER), turn_(WHITE_SIDE), nextPieceToMove_(-1, -1),
-    candidates_() {}
+    whiteBoard_(CheckersBitboard::EMPTY), blackBoard_(CheckersBitboard::EMPTY),
+    queenBoard_(CheckersBitboard::EMPTY), candidates_() {
+    CheckersBitboard::Initialize();
+}
 
 //--------------------------------------------------------------------------------
 
@@ -649,9 +808,9 @@ CheckersGameData & CheckersGameData::operator =(const CheckersGameData & source)
     winner_ = source.winner_;
     turn_ = source.turn_;
     nextPieceToMove_ = source.nextPieceToMove_;
-    ForEachInBoard([&] (int, int i, int j) {
-        board_[i][j] = source.board_[i][j];
-    });
+    whiteBoard_ = source.whiteBoard_;
+    blackBoard_ = source.blackBoard_;
+    queenBoard_ = source.queenBoard_;
     candidates_ = source.candidates_;
     return *this;
 }
@@ -26,9 +26,40 @@
 #include <vector>
 #include <functional>
 #include <SFML/Graphics/Rect.hpp>
+#include <Games/Checkers/CheckersBitboard.h>
 
 /**
- * This class represents the checkers board game data.
+ * This structure represents a step inside a move. The victim is the cell of the
+ * killed enemy, or (-1, -1) when the step doesn't kill anybody.
+ */
+struct CheckersMoveStep {
+    sf::Vector2i origin;
+    sf::Vector2i destination;
+    sf::Vector2i victim;
+    CheckersMoveStep() : origin(-1, -1), destination(-1, -1), victim(-1, -1) {}
+    CheckersMoveStep(const sf::Vector2i & orig, const sf::Vector2i & dest,
+        const sf::Vector2i & vict) : origin(orig), destination(dest), victim(vict) {}
+};
+
+/**
+ * This structure represents a move in the game. Every step after the first one
+ * kills an enemy, so a move can't have more steps than the pieces of a side.
+ */
+struct CheckersMove {
+    static const int MAX_STEPS = 20;
+    CheckersMoveStep steps[MAX_STEPS];
+    int size;
+    CheckersMove() : size(0) {}
+};
+
+/**
+ * This type represents a vector of moves.
+ */
+typedef std::vector<CheckersMove> CheckersMoveVector;
+
+/**
+ * This class represents the checkers board game data. The pieces are stored in
+ * bitboards of the dark cells, but the methods still work with the board cells.
  */
 class CheckersGameData {
 public:
@@ -77,9 +108,18 @@ public:
     // Types
     //--------------------------------------------------------------------------------
 
-    typedef int BoardTable[BOARD_SIZE][BOARD_SIZE];
+    typedef CheckersBitboard::Bitboard Bitboard;
     typedef std::vector<sf::Vector2i> CoordsVector;
 
+    struct MoveUndo {
+        Bitboard whiteBoard;
+        Bitboard blackBoard;
+        Bitboard queenBoard;
+        sf::Vector2i nextPieceToMove;
+        int winner;
+        int turn;
+    };
+
     //--------------------------------------------------------------------------------
     // Properties
     //--------------------------------------------------------------------------------
@@ -105,7 +145,8 @@ public:
     void SetWinner(int side);
 
     void NextTurn();
-    int CountPieces(int side);
+    int CountPieces(int side) const;
+    int CountQueens(int side) const;
 
     //--------------------------------------------------------------------------------
     // Move Methods
@@ -126,6 +167,14 @@ public:
     void MakeMove(int r1, int c1, int r2, int c2);
     void MakeMove(const sf::Vector2i & c1, const sf::Vector2i & c2);
 
+    //--------------------------------------------------------------------------------
+    // Search Methods
+    //--------------------------------------------------------------------------------
+
+    void GetAllMoves(CheckersMoveVector & moves);
+    void DoMove(const CheckersMove & move, MoveUndo & undo);
+    void UndoMove(const MoveUndo & undo);
+
     //--------------------------------------------------------------------------------
     // Query Methods
     //--------------------------------------------------------------------------------
@@ -166,6 +215,12 @@ public:
     CheckersGameData & operator =(const CheckersGameData & source);
 
 private:
+    //--------------------------------------------------------------------------------
+    // Constants
+    //--------------------------------------------------------------------------------
+
+    static const int MAX_OFFSETS = 28;
+
     //--------------------------------------------------------------------------------
     // Fields
     //--------------------------------------------------------------------------------
@@ -178,7 +233,9 @@ private:
     int turn_;
     sf::Vector2i nextPieceToMove_;
 
-    BoardTable board_;
+    Bitboard whiteBoard_;
+    Bitboard blackBoard_;
+    Bitboard queenBoard_;
     CoordsVector candidates_;
 
     //--------------------------------------------------------------------------------
@@ -189,7 +246,23 @@ private:
     int countEnemiesBetween(int r1, int c1, int r2, int c2,
         std::function<void (const sf::Vector2i &)> onEnemyFind) const;
 
-    void checkAndTransform(int r, int c);
+    int getCell(int r, int c) const;
+    void setCell(int r, int c, int piece);
+    Bitboard getSideBoard(int side) const;
+
+    static const sf::Vector2i * getPieceMoveOffsets(int piece, int & size);
+    static int getDirection(int from, int to, int & distance);
+    static void getPieceMoves(int square, bool queen, int side, Bitboard own,
+        Bitboard enemies, Bitboard & moves, Bitboard & kills);
+    bool hasSecondKill(int from, int to) const;
+    int getPossibleMoves(sf::Vector2i * victims, int r, int c) const;
+    void getAllMoves(const sf::Vector2i & piece, CheckersMove & move, CheckersMoveVector & moves);
+    Bitboard getMovers(int side, Bitboard & killers) const;
+    bool anyCandidate() const;
+
+    void saveState(MoveUndo & undo) const;
+    void restoreState(const MoveUndo & undo);
+    sf::Vector2i doStep(int from, int to);
 };
 
 #endif
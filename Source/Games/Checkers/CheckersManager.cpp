@@ -33,6 +33,7 @@
 #include <System/Mouse.h>
 #include <System/MathUtil.h>
 #include <System/ForEach.h>
+#include <System/ThinkService.h>
 #include <Menu/DesktopState.h>
 #include <Games/SaveManager.h>
 #include <Games/Checkers/CheckersGameData.h>
@@ -81,6 +82,7 @@ struct CheckersManager::InnerData {
     int aiCurrentTime;
     int aiMoveIndex;
     CheckersMove aiCurrentMove;
+    std::shared_ptr<ThinkJob<CheckersMove>> aiTask;
 
     std::unique_ptr<TextLabel> messageText;
     int errorMessage;
@@ -94,6 +96,7 @@ struct CheckersManager::InnerData {
     void MakeMove(const sf::Vector2i & coords);
 
     void ResetHudAndGoToGameState();
+    void CancelMachineMove();
     void ClearErrorMessage();
     void SetErrorMessage(int error);
     void UpdateHud();
@@ -156,11 +159,24 @@ void CheckersManager::InnerData::ResetHudAndGoToGameState() {
     aiCurrentTime = 0;
     aiMoveIndex = 0;
     aiCurrentMove = CheckersMove();
+    CancelMachineMove();
     core->SetNextState(MakeSharedState<CheckersGameState>());
 }
 
 //--------------------------------------------------------------------------------
 
+/**
+ * Cancels the move that the machine is thinking.
+ */
+void CheckersManager::InnerData::CancelMachineMove() {
+    if (aiTask) {
+        aiTask->Cancel();
+        aiTask = nullptr;
+    }
+}
+
+//--------------------------------------------------------------------------------
+
 /**
  * Clears the error message.
  */
@@ -348,6 +364,9 @@ void CheckersManager::Release() {
         // Unload the textures of the game.
         data_->tileset = nullptr;
 
+        // Stop the machine if it is still thinking.
+        data_->CancelMachineMove();
+
         // Remove the inner data of the game.
         data_.reset(nullptr);
     }
@@ -502,12 +521,24 @@ void CheckersManager::UpdateMachine(const sf::Time & timeDelta) {
                     data_->aiExecuteMove = false;
                 }
             }
+        } else if (data_->aiTask) {
+            // The machine thinks in the background, so only check if the move is ready.
+            if (data_->aiTask->Finished()) {
+                data_->aiCurrentMove = data_->aiTask->Result();
+                data_->aiTask = nullptr;
+                data_->aiMoveIndex = 0;
+                data_->aiCurrentTime = 0;
+                data_->aiExecuteMove = true;
+            }
         } else {
-            CheckersMiniMax solver;
-            data_->aiCurrentMove = solver.Execute(data_->game);
-            data_->aiMoveIndex = 0;
-            data_->aiCurrentTime = 0;
-            data_->aiExecuteMove = true;
+            // Submit a copy of the board to think the next move of the machine.
+            auto board = data_->game;
+            data_->aiTask = ThinkService::Instance()->Submit<CheckersMove>(
+                [board] (const ThinkTask & task) -> CheckersMove {
+                    CheckersMiniMax solver;
+                    return solver.Execute(board, &task);
+                }
+            );
         }
     }
     data_->UpdateHud();
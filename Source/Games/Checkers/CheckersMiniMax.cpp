@@ -22,7 +22,6 @@
 
 #include "CheckersMiniMax.h"
 #include <limits>
-#include <System/ForEach.h>
 
 //********************************************************************************
 // Constants
@@ -31,85 +30,96 @@
 const int INITIAL_ALPHA = std::numeric_limits<int>::min();
 const int INITIAL_BETA = std::numeric_limits<int>::max();
 
+const int HARD_TIME_BUDGET = 500;
+const int NO_TIME_BUDGET = std::numeric_limits<int>::max();
+const long long CHECK_STOP_MASK = 1023;
+
 //********************************************************************************
 // Methods
 //********************************************************************************
 
-CheckersMove CheckersMiniMax::Execute(CheckersGameData & data) {
-    initialize(data.Difficulty());
-    return minimax(data, 0, INITIAL_ALPHA, INITIAL_BETA);
+CheckersMove CheckersMiniMax::Execute(const CheckersGameData & data, const ThinkTask * task) {
+    // The search makes and undoes the moves on its own copy of the board.
+    CheckersGameData board(data);
+    thinkTask = task;
+    initialize(board.Difficulty());
+    nodes = 0;
+    stopped = false;
+    clock.restart();
+
+    // Search deeper and deeper until the last depth or the end of the time budget.
+    // A stopped iteration isn't complete, so the move of the previous one is kept,
+    // and the best move of each iteration is searched first in the next one.
+    CheckersMove result;
+    int lastDepth = maxDepth, best = 0;
+    for (int depth = 1; depth <= lastDepth; ++depth) {
+        maxDepth = depth;
+        auto move = minimax(board, 0, INITIAL_ALPHA, INITIAL_BETA, best);
+        if (stopped && depth > 1) break;
+        result = move;
+        // The next iteration will need more time than all the previous ones.
+        if (stopped || clock.getElapsedTime().asMilliseconds() * 2 >= timeBudget) break;
+    }
+    return result;
 }
 
 //--------------------------------------------------------------------------------
 
 void CheckersMiniMax::initialize(int difficulty) {
     if (difficulty == CheckersGameData::HARD_LEVEL) {
-        maxDepth = 3;
+        maxDepth = MAX_DEPTH;
+        timeBudget = HARD_TIME_BUDGET;
     } else if (difficulty == CheckersGameData::NORMAL_LEVEL) {
         maxDepth = 1;
+        timeBudget = NO_TIME_BUDGET;
     } else {
         maxDepth = 1;
+        timeBudget = NO_TIME_BUDGET;
     }
 }
 
 //--------------------------------------------------------------------------------
 
-void CheckersMiniMax::getAllMoves(CheckersGameData & data, CheckersMoveVector & moves) {
-    // First, get all the candidates on the current board.
-    auto & candidates = data.Candidates();
-    // For each candidate lets get all the moves of it.
-    CheckersMoveStepVector currentSteps;
-    ForEach(candidates, [&] (const sf::Vector2i & item) {
-        getAllMoves(data, item, currentSteps, moves);
-    });
-}
-
-//--------------------------------------------------------------------------------
-
-void CheckersMiniMax::getAllMoves(CheckersGameData & data, const sf::Vector2i & piece,
-    CheckersMoveStepVector & steps, CheckersMoveVector & moves) {
-    // Get all the possible moves of the current candidate.
-    CheckersGameData::CoordsVector possibleMoves;
-    data.GetPossibleMoves(possibleMoves, piece);
-    // For each possible move, make the move and change the turn.
-    ForEach(possibleMoves, [&] (const sf::Vector2i & destination) {
-        CheckersGameData future(data);
-        future.MakeMove(piece, destination);
-        future.NextTurn();
-        // If the turn is finished, add it to the vector of moves.
-        // Otherwise get deep in the chain of moves.
-        steps.push_back(CheckersMoveStep(piece, destination));
-        if (future.LastTurnFinished()) {
-            moves.push_back(CheckersMove(steps, future));
-        } else {
-            getAllMoves(future, destination, steps, moves);
-        }
-        steps.pop_back();
-    });
+bool CheckersMiniMax::checkStop() {
+    // When the task is cancelled or the time is over the search ends with the current
+    // result. The clock is only read from time to time, because it is slow.
+    if (!stopped && (++nodes & CHECK_STOP_MASK) == 0) {
+        stopped = (thinkTask != nullptr && thinkTask->Cancelled()) ||
+            clock.getElapsedTime().asMilliseconds() >= timeBudget;
+    }
+    return stopped;
 }
 
 //--------------------------------------------------------------------------------
 
-CheckersMove CheckersMiniMax::minimax(CheckersGameData & data, int depth, int alpha, int beta) {
+CheckersMove CheckersMiniMax::minimax(CheckersGameData & data, int depth, int alpha, int beta,
+    int & best) {
     CheckersMove result;
     if (!data.GameOver()) {
         // If the game is not over, get all the moves inside the board.
-        CheckersMoveVector moves;
-        getAllMoves(data, moves);
+        auto & moves = movesByDepth[depth];
+        data.GetAllMoves(moves);
 
         // If we have some moves to check, we'll initialize some variables.
-        if (!moves.empty()) {
-            int actval, maxval = INITIAL_ALPHA;
-            auto it = moves.begin(), end = moves.end();
-            result = CheckersMove(*it);
-
-            // And then for each move we'll try to get the maximum result.
-            for (; it != end; ++it) {
-                actval = minimizer(it->finalData, depth + 1, alpha, beta);
+        int size = static_cast<int>(moves.size());
+        if (size > 0) {
+            CheckersGameData::MoveUndo undo;
+            int actval, maxval = INITIAL_ALPHA, first = best < size ? best : 0;
+            result = moves[first];
+            best = first;
+
+            // And then for each move we'll try to get the maximum result, starting
+            // with the best move of the previous search.
+            for (int k = 0; k < size; ++k) {
+                int i = k == 0 ? first : (k <= first ? k - 1 : k);
+                data.DoMove(moves[i], undo);
+                actval = minimizer(data, depth + 1, alpha, beta);
+                data.UndoMove(undo);
                 if (maxval < actval) {
                     maxval = actval;
                     alpha = actval;
-                    result = CheckersMove(*it);
+                    result = moves[i];
+                    best = i;
                 }
             }
         }
@@ -123,26 +133,29 @@ int CheckersMiniMax::minimizer(CheckersGameData & data, int depth, int alpha, in
     // If we reach the maximum depth o the game is over, we'll evaluate the current
     // state of the game. If the current side does not have any moves the game ends,
     // so is not necesary to check if we have or not moves when there is no game over.
-    if (maxDepth < depth || data.GameOver()) {
+    if (maxDepth < depth || data.GameOver() || checkStop()) {
         return evaluate(data);
     } else {
         // If the game is not over, get all the moves inside the board.
-        CheckersMoveVector moves;
-        getAllMoves(data, moves);
+        auto & moves = movesByDepth[depth];
+        data.GetAllMoves(moves);
 
         // We'll initialize some variables.
+        CheckersGameData::MoveUndo undo;
         int actval, minval = INITIAL_BETA;
         auto it = moves.begin(), end = moves.end();
         // And then for each move we'll try to get the minimum result.
         for (; it != end; ++it) {
-            actval = maximizer(it->finalData, depth + 1, alpha, beta);
+            data.DoMove(*it, undo);
+            actval = maximizer(data, depth + 1, alpha, beta);
+            data.UndoMove(undo);
 
             if(minval > actval) {
                 minval = actval;
                 beta = actval;
             }
 
-            if(alpha > beta) {
+            if(alpha >= beta) {
                 return minval;
             }
         }
@@ -156,26 +169,29 @@ int CheckersMiniMax::maximizer(CheckersGameData & data, int depth, int alpha, in
     // If we reach the maximum depth o the game is over, we'll evaluate the current
     // state of the game. If the current side does not have any moves the game ends,
     // so is not necesary to check if we have or not moves when there is no game over.
-    if (maxDepth < depth || data.GameOver()) {
+    if (maxDepth < depth || data.GameOver() || checkStop()) {
         return evaluate(data);
     } else {
         // If the game is not over, get all the moves inside the board.
-        CheckersMoveVector moves;
-        getAllMoves(data, moves);
+        auto & moves = movesByDepth[depth];
+        data.GetAllMoves(moves);
 
         // We'll initialize some variables.
+        CheckersGameData::MoveUndo undo;
         int actval, maxval = INITIAL_ALPHA;
         auto it = moves.begin(), end = moves.end();
         // And then for each move we'll try to get the maximum result.
         for (; it != end; ++it) {
-            actval = minimizer(it->finalData, depth + 1, alpha, beta);
+            data.DoMove(*it, undo);
+            actval = minimizer(data, depth + 1, alpha, beta);
+            data.UndoMove(undo);
 
             if(maxval < actval) {
                 maxval = actval;
                 alpha = actval;
             }
 
-            if(alpha > beta) {
+            if(alpha >= beta) {
                 return maxval;
             }
         }
@@ -193,27 +209,19 @@ int CheckersMiniMax::evaluate(CheckersGameData & data) {
             return INITIAL_ALPHA;
         }
     } else {
-        int result = 0;
+        // The pieces are counted with the bitboards of each side.
         int machineSide = data.GetOppositeSide(data.PlayerSide());
+        int playerSide = data.PlayerSide();
         int normalValue = 1, queenValue = 10;
         if (data.Difficulty() == CheckersGameData::EASY_LEVEL) {
             queenValue = 1;
         }
-        data.ForEachInBoard([&] (int victim, int i, int j) {
-            if (data.IsNormalPiece(victim)) {
-                if (data.IsPieceSide(victim, machineSide)) {
-                    result += normalValue;
-                } else {
-                    result -= normalValue;
-                }
-            } else if (data.IsQueenPiece(victim)) {
-                if (data.IsPieceSide(victim, machineSide)) {
-                    result += queenValue;
-                } else {
-                    result -= queenValue;
-                }
-            }
-        });
+        int machineQueens = data.CountQueens(machineSide);
+        int playerQueens = data.CountQueens(playerSide);
+        int result = (data.CountPieces(machineSide) - machineQueens) * normalValue +
+                     machineQueens * queenValue;
+        result -= (data.CountPieces(playerSide) - playerQueens) * normalValue +
+                  playerQueens * queenValue;
         return result;
     }
 }
@@ -222,7 +230,8 @@ int CheckersMiniMax::evaluate(CheckersGameData & data) {
 // Constructors, destructor and operators
 //********************************************************************************
 
-CheckersMiniMax::CheckersMiniMax() {}
+CheckersMiniMax::CheckersMiniMax() : maxDepth(0), timeBudget(NO_TIME_BUDGET), nodes(0),
+    stopped(false), thinkTask(nullptr) {}
 
 //--------------------------------------------------------------------------------
 
@@ -25,50 +25,27 @@
 
 #include <vector>
 #include <SFML/Graphics/Rect.hpp>
+#include <SFML/System/Clock.hpp>
+#include <System/ThinkService.h>
 #include <Games/Checkers/CheckersGameData.h>
 
 /**
- * This structure represents a step inside a move.
- */
-struct CheckersMoveStep {
-    sf::Vector2i origin;
-    sf::Vector2i destination;
-    CheckersMoveStep() {}
-    CheckersMoveStep(const sf::Vector2i & orig, const sf::Vector2i & dest)
-        : origin(orig), destination(dest) {}
-};
-
-/**
- * This type represents a vector steps inside a move.
- */
-typedef std::vector<CheckersMoveStep> CheckersMoveStepVector;
-
-/**
- * This structure represents a move in the game.
- */
-struct CheckersMove {
-    CheckersMoveStepVector steps;
-    CheckersGameData finalData;
-    CheckersMove() {}
-    CheckersMove(const CheckersMoveStepVector & st, const CheckersGameData & fd)
-        : steps(st), finalData(fd) {}
-};
-
-/**
- * This type represents a vector of moves.
- */
-typedef std::vector<CheckersMove> CheckersMoveVector;
-
-/**
- * This class represents the mini-max algorithm.
+ * This class represents the mini-max algorithm. The hard level deepens the search
+ * one ply at a time, until the maximum depth or the end of its time budget.
  */
 class CheckersMiniMax {
 public:
+    //--------------------------------------------------------------------------------
+    // Constants
+    //--------------------------------------------------------------------------------
+
+    static const int MAX_DEPTH = 8;
+
     //--------------------------------------------------------------------------------
     // Methods
     //--------------------------------------------------------------------------------
 
-    CheckersMove Execute(CheckersGameData & data);
+    CheckersMove Execute(const CheckersGameData & data, const ThinkTask * task = nullptr);
 
     //--------------------------------------------------------------------------------
     // Constructors, destructor and operators
@@ -83,16 +60,20 @@ private:
     //--------------------------------------------------------------------------------
 
     int maxDepth;
+    int timeBudget;
+    long long nodes;
+    bool stopped;
+    sf::Clock clock;
+    const ThinkTask * thinkTask;
+    CheckersMoveVector movesByDepth[MAX_DEPTH + 1];
 
     //--------------------------------------------------------------------------------
     // Methods
     //--------------------------------------------------------------------------------
 
     void initialize(int difficulty);
-    void getAllMoves(CheckersGameData & data, CheckersMoveVector & moves);
-    void getAllMoves(CheckersGameData & data, const sf::Vector2i & piece,
-        CheckersMoveStepVector & steps, CheckersMoveVector & moves);
-    CheckersMove minimax(CheckersGameData & data, int depth, int alpha, int beta);
+    bool checkStop();
+    CheckersMove minimax(CheckersGameData & data, int depth, int alpha, int beta, int & best);
     int minimizer(CheckersGameData & data, int depth, int alpha, int beta);
     int maximizer(CheckersGameData & data, int depth, int alpha, int beta);
     int evaluate(CheckersGameData & data);
@@ -0,0 +1,345 @@
+/******************************************************************************
+ Copyright (c) 2014 Gorka Surez Garca
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ DEALINGS IN THE SOFTWARE.
+******************************************************************************/
+
+#include "ChessBenchmark.h"
+#include <cstdio>
+#include <cstdlib>
+#include <SFML/System/Clock.hpp>
+#include <System/CoreManager.h>
+#include <System/ForEach.h>
+
+//********************************************************************************
+// Constants
+//********************************************************************************
+
+const std::string PERFT_OPTION   = "-chess-perft";
+const std::string SEARCH_OPTION  = "-chess-search";
+const std::string THREADS_OPTION = "-chess-threads";
+const std::string DRAW_OPTION    = "-chess-stalemate";
+
+const long long UNLIMITED_NODES = 1LL << 62;
+const int       UNLIMITED_TIME  = 1 << 30;
+
+const int MAX_PERFT_DEPTH = 6;
+
+const std::string START_POSITION = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
+
+/**
+ * The perft positions and their number of leaf nodes at each depth. The nodes are
+ * regression baselines counted with this move generator, under the rules of this
+ * game, where a side in check can make any move, the game ends when a king is
+ * killed and a promotion is a single move. So they only detect the changes of
+ * the generator, they don't prove that it is right. The references are the counts
+ * published for the standard chess, only at the depths where these rules give the
+ * same moves. A zero value is unknown.
+ */
+struct PerftPosition {
+    const char * name;
+    const char * fen;
+    long long nodes[MAX_PERFT_DEPTH];
+    long long references[MAX_PERFT_DEPTH];
+};
+
+const PerftPosition PERFT_POSITIONS[] = {
+    { "start", "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+        { 20, 400, 8902, 197526, 4884743, 0 }, { 20, 400, 8902, 0, 0, 0 } },
+    { "kiwipete", "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+        { 48, 2039, 97982, 4119970, 0, 0 }, { 48, 2039, 0, 0, 0, 0 } },
+    { "endgame", "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+        { 14, 219, 3472, 58508, 969965, 0 }, { 14, 0, 0, 0, 0, 0 } },
+    { "promotion", "n1n5/PPPk4/8/8/8/8/4Kppp/5N1N b - - 0 1",
+        { 15, 219, 3613, 57521, 1080643, 0 }, { 0, 0, 0, 0, 0, 0 } }
+};
+
+const int PERFT_POSITIONS_COUNT = sizeof(PERFT_POSITIONS) / sizeof(PerftPosition);
+
+/**
+ * The search positions, from the middlegame to the endgame.
+ */
+const char * SEARCH_POSITIONS[][2] = {
+    { "italian",  "r1bqk2r/pppp1ppp/2n2n2/2b1p3/2B1P3/3P1N2/PPP2PPP/RNBQK2R w KQkq - 1 5" },
+    { "kiwipete", "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1" },
+    { "queens",   "r2q1rk1/pp1bbppp/2n1pn2/3p4/3P4/2NBPN2/PP1B1PPP/R2Q1RK1 w - - 0 10" },
+    { "rooks",    "8/5pk1/6p1/8/3R4/6P1/5PK1/3r4 w - - 0 1" },
+    { "pawns",    "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1" },
+    { "kqk",      "8/8/8/4k3/8/8/8/3QK3 w - - 0 1" }
+};
+
+const int SEARCH_POSITIONS_COUNT = sizeof(SEARCH_POSITIONS) / sizeof(SEARCH_POSITIONS[0]);
+
+/**
+ * The positions where the best result of the machine is a stalemate, so the search
+ * must give the score of a draw. In the "desperado" one the machine has a queen
+ * less, but Rg1 forces Kxg1 and then the black king doesn't have any move.
+ */
+const char * DRAW_POSITIONS[][2] = {
+    { "desperado", "7k/5Q2/8/8/8/6r1/7P/7K b - - 0 1" }
+};
+
+const int DRAW_POSITIONS_COUNT = sizeof(DRAW_POSITIONS) / sizeof(DRAW_POSITIONS[0]);
+
+//********************************************************************************
+// Methods (Public)
+//********************************************************************************
+
+bool ChessBenchmark::Execute(int argc, char ** argv, int & result) {
+    // Find the benchmark option in the command line arguments.
+    std::vector<std::string> args(argv, argv + argc);
+    result = EXIT_SUCCESS;
+    if (args.size() > 1 && args[1] == PERFT_OPTION) {
+        int depth = getArgument(args, 2, DEFAULT_PERFT_DEPTH);
+        int failures = args.size() > 3 ? Perft(depth, getArguments(args, 3)) : Perft(depth);
+        result = failures > 0 ? EXIT_FAILURE : EXIT_SUCCESS;
+        return true;
+    } else if (args.size() > 1 && args[1] == SEARCH_OPTION) {
+        Search(getArgument(args, 2, DEFAULT_SEARCH_DEPTH), getArgument(args, 3, 1));
+        return true;
+    } else if (args.size() > 1 && args[1] == THREADS_OPTION) {
+        Threads(getArgument(args, 2, CoreManager::Instance()->ProcessorCount()),
+            getArgument(args, 3, DEFAULT_TIME));
+        return true;
+    } else if (args.size() > 1 && args[1] == DRAW_OPTION) {
+        int failures = Stalemate(getArgument(args, 2, DEFAULT_DRAW_DEPTH));
+        result = failures > 0 ? EXIT_FAILURE : EXIT_SUCCESS;
+        return true;
+    }
+    return false;
+}
+
+//--------------------------------------------------------------------------------
+
+int ChessBenchmark::Perft(int maxDepth) {
+    // Count the moves of the known positions and compare them with the tables.
+    int failures = 0;
+    for (int i = 0; i < PERFT_POSITIONS_COUNT; ++i) {
+        auto & position = PERFT_POSITIONS[i];
+        failures += perft(position.name, position.fen, position.nodes,
+            position.references, maxDepth);
+    }
+    std::printf("benchmark=perft failures=%d\n", failures);
+    return failures;
+}
+
+//--------------------------------------------------------------------------------
+
+int ChessBenchmark::Perft(int maxDepth, const std::string & fen) {
+    // Use the table of a known position when the user asks for one of them.
+    for (int i = 0; i < PERFT_POSITIONS_COUNT; ++i) {
+        if (fen == PERFT_POSITIONS[i].fen) {
+            return perft(PERFT_POSITIONS[i].name, fen, PERFT_POSITIONS[i].nodes,
+                PERFT_POSITIONS[i].references, maxDepth);
+        }
+    }
+    return perft("custom", fen, nullptr, nullptr, maxDepth);
+}
+
+//--------------------------------------------------------------------------------
+
+void ChessBenchmark::Search(int maxDepth, int threads) {
+    // Search each position with a fresh solver and an increasing depth, to get
+    // the time needed to finish each iteration of the search.
+    for (int i = 0; i < SEARCH_POSITIONS_COUNT; ++i) {
+        ChessGameData game;
+        if (!loadPosition(game, SEARCH_POSITIONS[i][1])) continue;
+        for (int depth = 1; depth <= maxDepth; ++depth) {
+            ChessMiniMax solver;
+            solver.Threads(threads);
+            solver.Initialize(ChessGameData::HARD_LEVEL);
+            solver.Budget(UNLIMITED_TIME, UNLIMITED_NODES, depth);
+
+            ChessGameData victim(game);
+            sf::Clock clock;
+            auto move = solver.Execute(victim);
+            auto time = clock.getElapsedTime().asMicroseconds();
+            auto & stats = solver.Stats();
+            std::printf("benchmark=search position=%s threads=%d depth=%d nodes=%lld "
+                "time=%.3f nps=%.0f hits=%lld cutoffs=%lld move=%s\n",
+                SEARCH_POSITIONS[i][0], threads, solver.Depth(), stats.nodes,
+                time / 1000.0, time > 0 ? stats.nodes * 1000000.0 / time : 0.0,
+                stats.tableHits, stats.cutoffs, getMoveName(move).c_str());
+            std::fflush(stdout);
+        }
+    }
+}
+
+//--------------------------------------------------------------------------------
+
+void ChessBenchmark::Threads(int maxThreads, int milliseconds) {
+    // Search the same position with the same time and an increasing number of
+    // threads, to measure how the number of nodes per second scales.
+    double baseSpeed = 0.0;
+    for (int threads = 1; threads <= maxThreads; ++threads) {
+        ChessGameData game;
+        loadPosition(game, START_POSITION);
+        ChessMove(sf::Vector2i(4, 1), sf::Vector2i(4, 3)).MakeMove(game);
+
+        ChessMiniMax solver;
+        solver.Initialize(ChessGameData::HARD_LEVEL);
+        solver.Threads(threads);
+        solver.Budget(milliseconds, UNLIMITED_NODES, ChessMiniMax::MAX_DEPTH);
+
+        sf::Clock clock;
+        solver.Execute(game);
+        auto time = clock.getElapsedTime().asMilliseconds();
+        double speed = time > 0 ? solver.Nodes() * 1000.0 / time : 0.0;
+        if (threads == 1) baseSpeed = speed;
+
+        std::printf("benchmark=threads threads=%d nodes=%lld time=%d nps=%.0f "
+            "depth=%d scaling=%.2f\n", threads, solver.Nodes(), time, speed,
+            solver.Depth(), baseSpeed > 0.0 ? speed / baseSpeed : 0.0);
+        std::fflush(stdout);
+    }
+}
+
+//--------------------------------------------------------------------------------
+
+int ChessBenchmark::Stalemate(int maxDepth) {
+    // Search each position until the given depth and check the score of the root.
+    int failures = 0;
+    for (int i = 0; i < DRAW_POSITIONS_COUNT; ++i) {
+        ChessGameData game;
+        if (!loadPosition(game, DRAW_POSITIONS[i][1])) {
+            ++failures;
+            continue;
+        }
+        ChessMiniMax solver;
+        solver.Threads(1);
+        solver.Initialize(ChessGameData::HARD_LEVEL);
+        solver.Budget(UNLIMITED_TIME, UNLIMITED_NODES, maxDepth);
+        auto move = solver.Execute(game);
+
+        bool verified = solver.Score() == ChessMiniMax::DRAW_SCORE;
+        if (!verified) ++failures;
+        std::printf("benchmark=stalemate position=%s depth=%d score=%d expected=%d "
+            "move=%s verified=%s\n", DRAW_POSITIONS[i][0], solver.Depth(), solver.Score(),
+            ChessMiniMax::DRAW_SCORE, getMoveName(move).c_str(), verified ? "yes" : "no");
+        std::fflush(stdout);
+    }
+    std::printf("benchmark=stalemate failures=%d\n", failures);
+    return failures;
+}
+
+//********************************************************************************
+// Methods (Private)
+//********************************************************************************
+
+bool ChessBenchmark::loadPosition(ChessGameData & game, const std::string & fen) {
+    // The machine always plays with the side that has the turn.
+    game.ShowErrorMessages(false);
+    game.Start(true, ChessGameData::HARD_LEVEL, ChessGameData::WHITE_SIDE);
+    if (game.LoadFEN(fen)) {
+        if (game.Turn() == game.PlayerSide()) {
+            game.Start(true, ChessGameData::HARD_LEVEL, ChessGameData::BLACK_SIDE);
+            game.LoadFEN(fen);
+        }
+        return true;
+    } else {
+        std::printf("benchmark=error fen=\"%s\"\n", fen.c_str());
+        return false;
+    }
+}
+
+//--------------------------------------------------------------------------------
+
+long long ChessBenchmark::perft(const ChessGameData & game, int depth) {
+    // Make all the moves of the user interface, to test the same code that the
+    // players use, and count the positions at the last depth.
+    if (depth == 0) return 1;
+    long long nodes = 0;
+    ChessGameData::CoordsVector candidates, destinations;
+    game.GetCandidates(candidates);
+    ForEach(candidates, [&] (const sf::Vector2i & origin) {
+        game.GetPossibleMoves(destinations, origin);
+        ForEach(destinations, [&] (const sf::Vector2i & destination) {
+            ChessGameData victim(game);
+            if (ChessMove(origin, destination).MakeMove(victim)) {
+                nodes += perft(victim, depth - 1);
+            }
+        });
+    });
+    return nodes;
+}
+
+//--------------------------------------------------------------------------------
+
+int ChessBenchmark::perft(const std::string & name, const std::string & fen,
+    const long long * expected, const long long * references, int maxDepth) {
+    ChessGameData game;
+    if (!loadPosition(game, fen)) return 1;
+    int failures = 0;
+    for (int depth = 1; depth <= maxDepth; ++depth) {
+        sf::Clock clock;
+        auto nodes = perft(game, depth);
+        auto time = clock.getElapsedTime().asMicroseconds();
+
+        // Check the result with the baseline and the standard reference of the position.
+        bool inside = depth <= MAX_PERFT_DEPTH;
+        long long known = expected != nullptr && inside ? expected[depth - 1] : 0;
+        long long reference = references != nullptr && inside ? references[depth - 1] : 0;
+        bool failed = (known != 0 && known != nodes) || (reference != 0 && reference != nodes);
+        const char * verified = failed ? "no" : (known == 0 && reference == 0 ? "unknown" :
+            (reference != 0 ? "reference" : "baseline"));
+        if (failed) ++failures;
+
+        std::printf("benchmark=perft position=%s depth=%d nodes=%lld expected=%lld "
+            "reference=%lld time=%.3f nps=%.0f verified=%s\n", name.c_str(), depth, nodes,
+            known, reference, time / 1000.0, time > 0 ? nodes * 1000000.0 / time : 0.0,
+            verified);
+        std::fflush(stdout);
+    }
+    return failures;
+}
+
+//--------------------------------------------------------------------------------
+
+std::string ChessBenchmark::getMoveName(const ChessMove & move) {
+    // Write the move with the coordinates of the cells, like "e2e4".
+    if (move.origin == ChessGameData::NO_CELL) return "none";
+    std::string name;
+    name += static_cast<char>('a' + move.origin.x);
+    name += static_cast<char>('1' + move.origin.y);
+    name += static_cast<char>('a' + move.destination.x);
+    name += static_cast<char>('1' + move.destination.y);
+    return name;
+}
+
+//--------------------------------------------------------------------------------
+
+int ChessBenchmark::getArgument(const std::vector<std::string> & args, int index, int defval) {
+    if (index < static_cast<int>(args.size())) {
+        int value = std::atoi(args[index].c_str());
+        if (value > 0) return value;
+    }
+    return defval;
+}
+
+//--------------------------------------------------------------------------------
+
+std::string ChessBenchmark::getArguments(const std::vector<std::string> & args, int index) {
+    // The notation of the positions has spaces, so join the rest of the arguments.
+    std::string victim;
+    for (int i = index; i < static_cast<int>(args.size()); ++i) {
+        if (!victim.empty()) victim += " ";
+        victim += args[i];
+    }
+    return victim;
+}
@@ -0,0 +1,77 @@
+/******************************************************************************
+ Copyright (c) 2014 Gorka Surez Garca
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ DEALINGS IN THE SOFTWARE.
+******************************************************************************/
+
+#ifndef __CHESS_BENCHMARK_HEADER__
+#define __CHESS_BENCHMARK_HEADER__
+
+#include <string>
+#include <vector>
+#include <Games/Chess/ChessMiniMax.h>
+
+/**
+ * This static class contains the benchmarks of the chess logic, that are executed
+ * from the command line without the user interface. Each result is written as a
+ * line of "name=value" fields in the standard output.
+ */
+class ChessBenchmark {
+private:
+    ChessBenchmark() {}
+    ~ChessBenchmark() {}
+
+public:
+    //--------------------------------------------------------------------------------
+    // Constants
+    //--------------------------------------------------------------------------------
+
+    static const int DEFAULT_TIME         = 5000;
+    static const int DEFAULT_PERFT_DEPTH  =    4;
+    static const int DEFAULT_SEARCH_DEPTH =    7;
+    static const int DEFAULT_DRAW_DEPTH   =    4;
+
+    //--------------------------------------------------------------------------------
+    // Methods
+    //--------------------------------------------------------------------------------
+
+    static bool Execute(int argc, char ** argv, int & result);
+
+    static int Perft(int maxDepth);
+    static int Perft(int maxDepth, const std::string & fen);
+    static void Search(int maxDepth, int threads);
+    static void Threads(int maxThreads, int milliseconds);
+    static int Stalemate(int maxDepth);
+
+private:
+    //--------------------------------------------------------------------------------
+    // Methods
+    //--------------------------------------------------------------------------------
+
+    static bool loadPosition(ChessGameData & game, const std::string & fen);
+    static long long perft(const ChessGameData & game, int depth);
+    static int perft(const std::string & name, const std::string & fen,
+        const long long * expected, const long long * references, int maxDepth);
+    static std::string getMoveName(const ChessMove & move);
+
+    static int getArgument(const std::vector<std::string> & args, int index, int defval);
+    static std::string getArguments(const std::vector<std::string> & args, int index);
+};
+
+#endif
@@ -0,0 +1,223 @@
+/******************************************************************************
+ Copyright (c) 2014 Gorka Surez Garca
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ DEALINGS IN THE SOFTWARE.
+******************************************************************************/
+
+#include "ChessBitboard.h"
+
+//********************************************************************************
+// Constants
+//********************************************************************************
+
+const int ROOK_DIRECTIONS[4][2]   = { { 0, 1 }, { -1, 0 }, { 1, 0 }, { 0, -1 } };
+const int BISHOP_DIRECTIONS[4][2] = { { -1, 1 }, { 1, 1 }, { -1, -1 }, { 1, -1 } };
+
+const int KNIGHT_JUMPS[8][2] = {
+    { -1,  2 }, { 1,  2 }, { -2,  1 }, { 2,  1 },
+    { -2, -1 }, { 2, -1 }, { -1, -2 }, { 1, -2 }
+};
+
+const int KING_STEPS[8][2] = {
+    { -1,  1 }, { 0,  1 }, { 1,  1 }, { -1,  0 },
+    {  1,  0 }, { -1, -1 }, { 0, -1 }, { 1, -1 }
+};
+
+const ChessBitboard::Bitboard DE_BRUIJN_MAGIC = 0x03F79D71B4CB0A89ULL;
+
+const int DE_BRUIJN_INDEX[ChessBitboard::MAX_SQUARES] = {
+     0, 47,  1, 56, 48, 27,  2, 60, 57, 49, 41, 37, 28, 16,  3, 61,
+    54, 58, 35, 52, 50, 42, 21, 44, 38, 32, 29, 23, 17, 11,  4, 62,
+    46, 55, 26, 59, 40, 36, 15, 53, 34, 51, 20, 43, 31, 22, 10, 45,
+    25, 39, 14, 33, 19, 30,  9, 24, 13, 18,  8, 12,  7,  6,  5, 63
+};
+
+//********************************************************************************
+// Static
+//********************************************************************************
+
+bool ChessBitboard::initialized_ = false;
+
+ChessBitboard::Bitboard ChessBitboard::pawnAttacks_[2][MAX_SQUARES];
+ChessBitboard::Bitboard ChessBitboard::knightAttacks_[MAX_SQUARES];
+ChessBitboard::Bitboard ChessBitboard::kingAttacks_[MAX_SQUARES];
+ChessBitboard::Bitboard ChessBitboard::between_[MAX_SQUARES][MAX_SQUARES];
+ChessBitboard::Bitboard ChessBitboard::line_[MAX_SQUARES][MAX_SQUARES];
+
+ChessBitboard::Magic ChessBitboard::rookMagics_[MAX_SQUARES];
+ChessBitboard::Magic ChessBitboard::bishopMagics_[MAX_SQUARES];
+
+ChessBitboard::Bitboard ChessBitboard::rookTable_[ROOK_TABLE_SIZE];
+ChessBitboard::Bitboard ChessBitboard::bishopTable_[BISHOP_TABLE_SIZE];
+
+//********************************************************************************
+// Methods (Public)
+//********************************************************************************
+
+void ChessBitboard::Initialize() {
+    if (initialized_) return;
+
+    // Some helpers to set a board from a relative cell of a square.
+    auto inside = [] (int row, int col) -> bool {
+        return 0 <= row && row < BOARD_SIZE && 0 <= col && col < BOARD_SIZE;
+    };
+    auto getTargets = [&] (int square, const int (*offsets)[2], int size) -> Bitboard {
+        Bitboard result = EMPTY;
+        int row = square / BOARD_SIZE, col = square % BOARD_SIZE;
+        for (int i = 0; i < size; ++i) {
+            int r = row + offsets[i][1], c = col + offsets[i][0];
+            if (inside(r, c)) result |= GetMask(GetSquare(r, c));
+        }
+        return result;
+    };
+
+    // Calculate the attacks of the jumping pieces.
+    const int WHITE_PAWN_KILLS[2][2] = { { -1,  1 }, { 1,  1 } };
+    const int BLACK_PAWN_KILLS[2][2] = { { -1, -1 }, { 1, -1 } };
+    for (int square = 0; square < MAX_SQUARES; ++square) {
+        pawnAttacks_[0][square] = getTargets(square, WHITE_PAWN_KILLS, 2);
+        pawnAttacks_[1][square] = getTargets(square, BLACK_PAWN_KILLS, 2);
+        knightAttacks_[square] = getTargets(square, KNIGHT_JUMPS, 8);
+        kingAttacks_[square] = getTargets(square, KING_STEPS, 8);
+    }
+
+    // Calculate the attacks of the sliding pieces.
+    initializeMagics(rookMagics_, rookTable_, ROOK_DIRECTIONS);
+    initializeMagics(bishopMagics_, bishopTable_, BISHOP_DIRECTIONS);
+
+    // Calculate the lines between two squares in the same row, column or diagonal.
+    for (int from = 0; from < MAX_SQUARES; ++from) {
+        for (int to = 0; to < MAX_SQUARES; ++to) {
+            between_[from][to] = EMPTY;
+            line_[from][to] = EMPTY;
+            if (from == to) continue;
+            Bitboard fromMask = GetMask(from), toMask = GetMask(to);
+            if (RookAttacks(from, EMPTY) & toMask) {
+                between_[from][to] = RookAttacks(from, toMask) & RookAttacks(to, fromMask);
+                line_[from][to] = (RookAttacks(from, EMPTY) & RookAttacks(to, EMPTY)) |
+                    fromMask | toMask;
+            } else if (BishopAttacks(from, EMPTY) & toMask) {
+                between_[from][to] = BishopAttacks(from, toMask) & BishopAttacks(to, fromMask);
+                line_[from][to] = (BishopAttacks(from, EMPTY) & BishopAttacks(to, EMPTY)) |
+                    fromMask | toMask;
+            }
+        }
+    }
+
+    initialized_ = true;
+}
+
+//--------------------------------------------------------------------------------
+
+int ChessBitboard::Count(Bitboard victim) {
+    // Parallel bit count without any intrinsic, so it works in any platform.
+    victim = victim - ((victim >> 1) & 0x5555555555555555ULL);
+    victim = (victim & 0x3333333333333333ULL) + ((victim >> 2) & 0x3333333333333333ULL);
+    victim = (victim + (victim >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+    return static_cast<int>((victim * 0x0101010101010101ULL) >> 56);
+}
+
+//--------------------------------------------------------------------------------
+
+int ChessBitboard::First(Bitboard victim) {
+    // De Bruijn multiplication over the bits until the first set one.
+    if (victim == EMPTY) return NO_SQUARE;
+    return DE_BRUIJN_INDEX[((victim ^ (victim - 1)) * DE_BRUIJN_MAGIC) >> 58];
+}
+
+//********************************************************************************
+// Methods (Private)
+//********************************************************************************
+
+ChessBitboard::Bitboard ChessBitboard::slidingAttacks(int square, Bitboard occupancy,
+    const int (*directions)[2]) {
+    // Walk each ray until the border or the first piece found.
+    Bitboard result = EMPTY;
+    int row = square / BOARD_SIZE, col = square % BOARD_SIZE;
+    for (int i = 0; i < 4; ++i) {
+        int r = row + directions[i][1], c = col + directions[i][0];
+        while (0 <= r && r < BOARD_SIZE && 0 <= c && c < BOARD_SIZE) {
+            Bitboard mask = GetMask(GetSquare(r, c));
+            result |= mask;
+            if (occupancy & mask) break;
+            r += directions[i][1];
+            c += directions[i][0];
+        }
+    }
+    return result;
+}
+
+//--------------------------------------------------------------------------------
+
+void ChessBitboard::initializeMagics(Magic * magics, Bitboard * table,
+    const int (*directions)[2]) {
+    // A fixed seed xorshift generator, so the magics are the same in every run.
+    Bitboard seed = 0x9E3779B97F4A7C15ULL;
+    auto random = [&] () -> Bitboard {
+        seed ^= seed >> 12; seed ^= seed << 25; seed ^= seed >> 27;
+        return seed * 2685821657736338717ULL;
+    };
+
+    Bitboard occupancies[4096], references[4096];
+    int epochs[4096] = { 0 }, epoch = 0;
+    Bitboard * attacks = table;
+
+    for (int square = 0; square < MAX_SQUARES; ++square) {
+        // The borders of the board never block a ray, so they're out of the mask.
+        int row = square / BOARD_SIZE, col = square % BOARD_SIZE;
+        Bitboard edges = ((ROW_1 | ROW_8) & ~(ROW_1 << (BOARD_SIZE * row))) |
+                         ((FILE_A | FILE_H) & ~(FILE_A << col));
+
+        auto & victim = magics[square];
+        victim.mask = slidingAttacks(square, EMPTY, directions) & ~edges;
+        victim.shift = MAX_SQUARES - Count(victim.mask);
+        victim.attacks = attacks;
+
+        // Enumerate all the subsets of the mask with the Carry-Rippler trick.
+        int size = 0;
+        Bitboard subset = EMPTY;
+        do {
+            occupancies[size] = subset;
+            references[size] = slidingAttacks(square, subset, directions);
+            ++size;
+            subset = (subset - victim.mask) & victim.mask;
+        } while (subset != EMPTY);
+
+        // Find a magic number that maps every subset without destructive collisions.
+        for (int i = 0; i < size; ) {
+            do {
+                victim.magic = random() & random() & random();
+            } while (Count((victim.mask * victim.magic) >> 56) < 6);
+
+            ++epoch;
+            for (i = 0; i < size; ++i) {
+                unsigned int index = static_cast<unsigned int>(
+                    (occupancies[i] * victim.magic) >> victim.shift);
+                if (epochs[index] < epoch) {
+                    epochs[index] = epoch;
+                    attacks[index] = references[i];
+                } else if (attacks[index] != references[i]) {
+                    break;
+                }
+            }
+        }
+
+        attacks += size;
+    }
+}
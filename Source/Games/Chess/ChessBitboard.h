@@ -0,0 +1,182 @@
+/******************************************************************************
+ Copyright (c) 2014 Gorka Surez Garca
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ DEALINGS IN THE SOFTWARE.
+******************************************************************************/
+
+#ifndef __CHESS_BITBOARD_HEADER__
+#define __CHESS_BITBOARD_HEADER__
+
+#include <SFML/System/Vector2.hpp>
+
+/**
+ * This static class is a collection of 64-bit board utility functions.
+ */
+class ChessBitboard {
+private:
+    ChessBitboard() {}
+    ~ChessBitboard() {}
+
+public:
+    //--------------------------------------------------------------------------------
+    // Types
+    //--------------------------------------------------------------------------------
+
+    typedef unsigned long long Bitboard;
+
+    //--------------------------------------------------------------------------------
+    // Constants
+    //--------------------------------------------------------------------------------
+
+    static const int BOARD_SIZE  =  8;
+    static const int MAX_SQUARES = 64;
+    static const int NO_SQUARE   = -1;
+
+    static const Bitboard EMPTY = 0ULL;
+    static const Bitboard FULL  = ~0ULL;
+
+    static const Bitboard FILE_A = 0x0101010101010101ULL;
+    static const Bitboard FILE_H = 0x8080808080808080ULL;
+    static const Bitboard ROW_1  = 0x00000000000000FFULL;
+    static const Bitboard ROW_8  = 0xFF00000000000000ULL;
+
+    //--------------------------------------------------------------------------------
+    // Methods
+    //--------------------------------------------------------------------------------
+
+    static void Initialize();
+
+    /**
+     * Gets the square index of a cell.
+     */
+    static int GetSquare(int row, int col) {
+        return row * BOARD_SIZE + col;
+    }
+
+    /**
+     * Gets the square index of a cell.
+     */
+    static int GetSquare(const sf::Vector2i & coords) {
+        return coords.y * BOARD_SIZE + coords.x;
+    }
+
+    /**
+     * Gets the cell coordinates of a square index.
+     */
+    static sf::Vector2i GetCoords(int square) {
+        return sf::Vector2i(square % BOARD_SIZE, square / BOARD_SIZE);
+    }
+
+    /**
+     * Gets the board with only one square set.
+     */
+    static Bitboard GetMask(int square) {
+        return 1ULL << square;
+    }
+
+    /**
+     * Checks if a square is set inside a board.
+     */
+    static bool IsSet(Bitboard victim, int square) {
+        return (victim & (1ULL << square)) != EMPTY;
+    }
+
+    static int Count(Bitboard victim);
+    static int First(Bitboard victim);
+
+    /**
+     * Gets the first square of a board and removes it.
+     */
+    static int PopFirst(Bitboard & victim) {
+        int square = First(victim);
+        victim &= victim - 1;
+        return square;
+    }
+
+    static Bitboard PawnAttacks(int side, int square)   { return pawnAttacks_[side][square]; }
+    static Bitboard KnightAttacks(int square)           { return knightAttacks_[square];     }
+    static Bitboard KingAttacks(int square)             { return kingAttacks_[square];       }
+    static Bitboard Between(int from, int to)           { return between_[from][to];         }
+    static Bitboard Line(int from, int to)              { return line_[from][to];            }
+
+    /**
+     * Gets the attacks of a rook with a board occupancy.
+     */
+    static Bitboard RookAttacks(int square, Bitboard occupancy) {
+        const auto & victim = rookMagics_[square];
+        return victim.attacks[((occupancy & victim.mask) * victim.magic) >> victim.shift];
+    }
+
+    /**
+     * Gets the attacks of a bishop with a board occupancy.
+     */
+    static Bitboard BishopAttacks(int square, Bitboard occupancy) {
+        const auto & victim = bishopMagics_[square];
+        return victim.attacks[((occupancy & victim.mask) * victim.magic) >> victim.shift];
+    }
+
+    /**
+     * Gets the attacks of a queen with a board occupancy.
+     */
+    static Bitboard QueenAttacks(int square, Bitboard occupancy) {
+        return RookAttacks(square, occupancy) | BishopAttacks(square, occupancy);
+    }
+
+private:
+    //--------------------------------------------------------------------------------
+    // Constants and types
+    //--------------------------------------------------------------------------------
+
+    static const int ROOK_TABLE_SIZE   = 0x19000;
+    static const int BISHOP_TABLE_SIZE = 0x1480;
+
+    struct Magic {
+        Bitboard mask;
+        Bitboard magic;
+        Bitboard * attacks;
+        unsigned int shift;
+    };
+
+    //--------------------------------------------------------------------------------
+    // Fields
+    //--------------------------------------------------------------------------------
+
+    static bool initialized_;
+
+    static Bitboard pawnAttacks_[2][MAX_SQUARES];
+    static Bitboard knightAttacks_[MAX_SQUARES];
+    static Bitboard kingAttacks_[MAX_SQUARES];
+    static Bitboard between_[MAX_SQUARES][MAX_SQUARES];
+    static Bitboard line_[MAX_SQUARES][MAX_SQUARES];
+
+    static Magic rookMagics_[MAX_SQUARES];
+    static Magic bishopMagics_[MAX_SQUARES];
+
+    static Bitboard rookTable_[ROOK_TABLE_SIZE];
+    static Bitboard bishopTable_[BISHOP_TABLE_SIZE];
+
+    //--------------------------------------------------------------------------------
+    // Methods
+    //--------------------------------------------------------------------------------
+
+    static Bitboard slidingAttacks(int square, Bitboard occupancy, const int (*directions)[2]);
+    static void initializeMagics(Magic * magics, Bitboard * table, const int (*directions)[2]);
+};
+
+#endif
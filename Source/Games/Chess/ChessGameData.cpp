@@ -21,6 +21,9 @@
 ******************************************************************************/
 
 #include "ChessGameData.h"
+#include <cctype>
+#include <cstring>
+#include <sstream>
 #include <System/MathUtil.h>
 #include <System/ForEach.h>
 #include <Games/Chess/ChessManager.h>
@@ -39,100 +42,12 @@ const int OPPOSITE_SIDE[ChessGameData::MAX_SIDES] = {
     ChessGameData::BLACK_SIDE, ChessGameData::WHITE_SIDE
 };
 
+const int NO_LAST_MOVE = -1;
+
 //--------------------------------------------------------------------------------
 
 const sf::Vector2i ChessGameData::NO_CELL = sf::Vector2i(-1, -1);
 
-const int ChessGameData::MAX_OFFSETS[PIECE_TYPES] = {
-    MAX_PAWN_OFFSETS, MAX_ROOK_OFFSETS, MAX_KNIGHT_OFFSETS,
-    MAX_BISHOP_OFFSETS, MAX_QUEEN_OFFSETS, MAX_KING_OFFSETS
-};
-
-const sf::Vector2i ChessGameData::WHITE_PAWN_OFFSETS[MAX_PAWN_OFFSETS] = {
-    sf::Vector2i(-1, 1),    // Kill Left
-    sf::Vector2i(0, 1),     // Move 1
-    sf::Vector2i(1, 1),     // Kill Right
-    sf::Vector2i(0, 2)      // Move 2
-};
-
-const sf::Vector2i ChessGameData::BLACK_PAWN_OFFSETS[MAX_PAWN_OFFSETS] = {
-    sf::Vector2i(-1, -1),   // Kill Left
-    sf::Vector2i(0, -1),    // Move 1
-    sf::Vector2i(1, -1),    // Kill Right
-    sf::Vector2i(0, -2)     // Move 2
-};
-
-const sf::Vector2i ChessGameData::ROOK_OFFSETS[MAX_ROOK_OFFSETS] = {
-    sf::Vector2i(0, 1), sf::Vector2i(-1, 0), sf::Vector2i(1, 0), sf::Vector2i(0, -1),
-    sf::Vector2i(0, 2), sf::Vector2i(-2, 0), sf::Vector2i(2, 0), sf::Vector2i(0, -2),
-    sf::Vector2i(0, 3), sf::Vector2i(-3, 0), sf::Vector2i(3, 0), sf::Vector2i(0, -3),
-    sf::Vector2i(0, 4), sf::Vector2i(-4, 0), sf::Vector2i(4, 0), sf::Vector2i(0, -4),
-    sf::Vector2i(0, 5), sf::Vector2i(-5, 0), sf::Vector2i(5, 0), sf::Vector2i(0, -5),
-    sf::Vector2i(0, 6), sf::Vector2i(-6, 0), sf::Vector2i(6, 0), sf::Vector2i(0, -6),
-    sf::Vector2i(0, 7), sf::Vector2i(-7, 0), sf::Vector2i(7, 0), sf::Vector2i(0, -7)
-};
-
-const sf::Vector2i ChessGameData::KNIGHT_OFFSETS[MAX_KNIGHT_OFFSETS] = {
-    sf::Vector2i(-1,  2), sf::Vector2i( 1,  2),
-    sf::Vector2i(-2,  1), sf::Vector2i( 2,  1),
-    sf::Vector2i(-2, -1), sf::Vector2i( 2, -1),
-    sf::Vector2i(-1, -2), sf::Vector2i( 1, -2)
-};
-
-const sf::Vector2i ChessGameData::BISHOP_OFFSETS[MAX_BISHOP_OFFSETS] = {
-    sf::Vector2i(-1, 1), sf::Vector2i(1, 1), sf::Vector2i(-1, -1), sf::Vector2i(1, -1),
-    sf::Vector2i(-2, 2), sf::Vector2i(2, 2), sf::Vector2i(-2, -2), sf::Vector2i(2, -2),
-    sf::Vector2i(-3, 3), sf::Vector2i(3, 3), sf::Vector2i(-3, -3), sf::Vector2i(3, -3),
-    sf::Vector2i(-4, 4), sf::Vector2i(4, 4), sf::Vector2i(-4, -4), sf::Vector2i(4, -4),
-    sf::Vector2i(-5, 5), sf::Vector2i(5, 5), sf::Vector2i(-5, -5), sf::Vector2i(5, -5),
-    sf::Vector2i(-6, 6), sf::Vector2i(6, 6), sf::Vector2i(-6, -6), sf::Vector2i(6, -6),
-    sf::Vector2i(-7, 7), sf::Vector2i(7, 7), sf::Vector2i(-7, -7), sf::Vector2i(7, -7)
-};
-
-const sf::Vector2i ChessGameData::QUEEN_OFFSETS[MAX_QUEEN_OFFSETS] = {
-    sf::Vector2i(-1,  1), sf::Vector2i(0,  1), sf::Vector2i(1,  1),
-    sf::Vector2i(-1,  0),                      sf::Vector2i(1,  0),
-    sf::Vector2i(-1, -1), sf::Vector2i(0, -1), sf::Vector2i(1, -1),
-
-    sf::Vector2i(-2,  2), sf::Vector2i(0,  2), sf::Vector2i(2,  2),
-    sf::Vector2i(-2,  0),                      sf::Vector2i(2,  0),
-    sf::Vector2i(-2, -2), sf::Vector2i(0, -2), sf::Vector2i(2, -2),
-
-    sf::Vector2i(-3,  3), sf::Vector2i(0,  3), sf::Vector2i(3,  3),
-    sf::Vector2i(-3,  0),                      sf::Vector2i(3,  0),
-    sf::Vector2i(-3, -3), sf::Vector2i(0, -3), sf::Vector2i(3, -3),
-
-    sf::Vector2i(-4,  4), sf::Vector2i(0,  4), sf::Vector2i(4,  4),
-    sf::Vector2i(-4,  0),                      sf::Vector2i(4,  0),
-    sf::Vector2i(-4, -4), sf::Vector2i(0, -4), sf::Vector2i(4, -4),
-
-    sf::Vector2i(-5,  5), sf::Vector2i(0,  5), sf::Vector2i(5,  5),
-    sf::Vector2i(-5,  0),                      sf::Vector2i(5,  0),
-    sf::Vector2i(-5, -5), sf::Vector2i(0, -5), sf::Vector2i(5, -5),
-
-    sf::Vector2i(-6,  6), sf::Vector2i(0,  6), sf::Vector2i(6,  6),
-    sf::Vector2i(-6,  0),                      sf::Vector2i(6,  0),
-    sf::Vector2i(-6, -6), sf::Vector2i(0, -6), sf::Vector2i(6, -6),
-
-    sf::Vector2i(-7,  7), sf::Vector2i(0,  7), sf::Vector2i(7,  7),
-    sf::Vector2i(-7,  0),                      sf::Vector2i(7,  0),
-    sf::Vector2i(-7, -7), sf::Vector2i(0, -7), sf::Vector2i(7, -7)
-};
-
-const sf::Vector2i ChessGameData::KING_OFFSETS[MAX_KING_OFFSETS] = {
-    sf::Vector2i(-1,  1), sf::Vector2i(0,  1), sf::Vector2i(1,  1),
-    sf::Vector2i(-1,  0),                      sf::Vector2i(1,  0),
-    sf::Vector2i(-1, -1), sf::Vector2i(0, -1), sf::Vector2i(1, -1),
-
-    sf::Vector2i(-2,  0),                      sf::Vector2i(2,  0)
-};
-
-//********************************************************************************
-// Static
-//********************************************************************************
-
-bool ChessGameData::showErrorMessages_ = true;
-
 //********************************************************************************
 // General Methods (Public)
 //********************************************************************************
@@ -184,6 +99,7 @@ void ChessGameData::Reset() {
 
         pieces_[BLACK_PIECES_START + HALF_PIECES + i] = BLACK_PIECES[i];
     }
+    updateBoard();
 
     // Set some control information.
     winner_ = NO_WINNER;
@@ -194,6 +110,81 @@ void ChessGameData::Reset() {
 
 //--------------------------------------------------------------------------------
 
+bool ChessGameData::LoadFEN(const std::string & fen) {
+    // Split the position in the fields of the notation, the move counters are ignored.
+    std::istringstream input(fen);
+    std::string placement, turn, castling = "-", passant = "-";
+    input >> placement >> turn >> castling >> passant;
+    if (placement.empty() || (turn != "w" && turn != "b")) return false;
+
+    // Put the pieces on the board, from the last row to the first one.
+    const std::string PIECE_NAMES = "prnbqk";
+    BoardPieces pieces;
+    int count[MAX_SIDES] = { 0, 0 };
+    int row = BOARD_SIZE - 1, col = 0;
+    for (size_t i = 0; i < placement.size(); ++i) {
+        char name = placement[i];
+        if (name == '/') {
+            if (--row < 0 || col != BOARD_SIZE) return false;
+            col = 0;
+        } else if (name >= '1' && name <= '8') {
+            col += name - '0';
+        } else {
+            int side = std::isupper(name) ? WHITE_SIDE : BLACK_SIDE;
+            auto type = PIECE_NAMES.find(static_cast<char>(std::tolower(name)));
+            if (type == std::string::npos || col >= BOARD_SIZE ||
+                count[side] >= MAX_PIECES_SIDE) {
+                return false;
+            }
+            int start = side == WHITE_SIDE ? WHITE_PIECES_START : BLACK_PIECES_START;
+            pieces[start + count[side]++] = Piece(side, static_cast<int>(type),
+                sf::Vector2i(col++, row));
+        }
+        if (col > BOARD_SIZE) return false;
+    }
+    if (row != 0 || col != BOARD_SIZE) return false;
+    std::copy(pieces, pieces + MAX_PIECES, pieces_);
+    updateBoard();
+
+    // The kings and rooks without the castling right are marked like moved pieces.
+    const char * CASTLING_NAMES[MAX_SIDES] = { "KQ", "kq" };
+    const int CASTLING_ROWS[MAX_SIDES] = { WHITE_PIECES_ROW, BLACK_PIECES_ROW };
+    for (int side = 0; side < MAX_SIDES; ++side) {
+        bool rights[2];
+        for (int i = 0; i < 2; ++i) {
+            rights[i] = castling.find(CASTLING_NAMES[side][i]) != std::string::npos;
+            int rookIndex = getPiece(CASTLING_ROWS[side], i == 0 ? BOARD_SIZE - 1 : 0);
+            if (!rights[i] && rookIndex != PIECE_NOT_FOUND &&
+                pieces_[rookIndex].side == side && pieces_[rookIndex].type == ROOK_PIECE) {
+                setMark(rookIndex, MARK_CANT_CASTLING);
+            }
+        }
+        int kingIndex = getPieceByType(side, KING_PIECE);
+        if (!rights[0] && !rights[1] && kingIndex != PIECE_NOT_FOUND) {
+            setMark(kingIndex, MARK_CANT_CASTLING);
+        }
+    }
+
+    // The pawn that jumped two cells can be killed by the enemy pawns at its sides.
+    turn_ = turn == "w" ? WHITE_SIDE : BLACK_SIDE;
+    if (passant.size() == 2 && passant[0] >= 'a' && passant[0] <= 'h') {
+        int c = passant[0] - 'a', r = turn_ == WHITE_SIDE ? 4 : 3;
+        int index = getPiece(r, c);
+        if (index != PIECE_NOT_FOUND && pieces_[index].type == PAWN_PIECE) {
+            checkAndMarkPawn(pieces_[index], turn_, r, c - 1);
+            checkAndMarkPawn(pieces_[index], turn_, r, c + 1);
+        }
+    }
+
+    // Set some control information.
+    winner_ = NO_WINNER;
+    whiteCheck_ = turn_ == WHITE_SIDE && isKingAttacked(WHITE_SIDE);
+    blackCheck_ = turn_ == BLACK_SIDE && isKingAttacked(BLACK_SIDE);
+    return true;
+}
+
+//--------------------------------------------------------------------------------
+
 void ChessGameData::SetWinner(int side) {
     if (side == BOTH_SIDES) {
         // If both sides win there is a draw.
@@ -220,24 +211,34 @@ void ChessGameData::NextTurn() {
         } else if (getPieceByType(BLACK_SIDE, KING_PIECE) == PIECE_NOT_FOUND) {
             SetWinner(WHITE_SIDE);
         } else {
-            // No king dead, it's party time bro.
+            // No king dead, it's party time bro. A side in check can make any move,
+            // so its king could be still in danger after the next move of the enemy.
+            bool exposedKing = exposedKing_;
+            exposedKing_ = turn_ == WHITE_SIDE ? whiteCheck_ : blackCheck_;
             whiteCheck_ = false;
             blackCheck_ = false;
 
             clearAllErrorMessages();
+            bool showErrorMessages = showErrorMessages_;
             showErrorMessages_ = false;
 
-            if (turn_ == WHITE_SIDE) {
-                // So the last turn was the white one. Let's change it and take
-                // a look to the board to find a check situation. If there is a
-                // check, we'll test the checkmate situation to warn the user.
-                turn_ = BLACK_SIDE;
-                if (isCheck()) {
+            // Only the last move can give a check to a safe king, any other way the
+            // whole board is checked. The checkmate and the stalemate are searched
+            // only when the side to move is unable to find any legal move.
+            turn_ = OPPOSITE_SIDE[turn_];
+            bool check = lastMove_ != NO_LAST_MOVE && !exposedKing ?
+                isCheckAfterMove(lastMove_) : isKingAttacked(turn_);
+            lastMove_ = NO_LAST_MOVE;
+
+            if (turn_ == BLACK_SIDE) {
+                // So the last turn was the white one. If there is a check,
+                // we'll test the checkmate situation to warn the user.
+                if (check) {
                     if (isCheckmate()) {
-                        showErrorMessages_ = true;
+                        showErrorMessages_ = showErrorMessages;
                         setErrorMessage(ChessManager::ERROR_BLACK_CHECKMATE);
                     } else {
-                        showErrorMessages_ = true;
+                        showErrorMessages_ = showErrorMessages;
                         setErrorMessage(ChessManager::ERROR_BLACK_CHECK);
                     }
                     blackCheck_ = true;
@@ -246,16 +247,14 @@ void ChessGameData::NextTurn() {
                     SetWinner(BOTH_SIDES);
                 }
             } else {
-                // So the last turn was the black one. Let's change it and take
-                // a look to the board to find a check situation. If there is a
-                // check, we'll test the checkmate situation to warn the user.
-                turn_ = WHITE_SIDE;
-                if (isCheck()) {
+                // So the last turn was the black one. If there is a check,
+                // we'll test the checkmate situation to warn the user.
+                if (check) {
                     if (isCheckmate()) {
-                        showErrorMessages_ = true;
+                        showErrorMessages_ = showErrorMessages;
                         setErrorMessage(ChessManager::ERROR_WHITE_CHECKMATE);
                     } else {
-                        showErrorMessages_ = true;
+                        showErrorMessages_ = showErrorMessages;
                         setErrorMessage(ChessManager::ERROR_WHITE_CHECK);
                     }
                     whiteCheck_ = true;
@@ -265,7 +264,7 @@ void ChessGameData::NextTurn() {
                 }
             }
 
-            showErrorMessages_ = true;
+            showErrorMessages_ = showErrorMessages;
         }
     }
 }
@@ -285,73 +284,431 @@ bool ChessGameData::MakeMove(const sf::Vector2i & orig, const sf::Vector2i & des
         if (index != PIECE_NOT_FOUND) {
             auto & piece = pieces_[index];
             if (piece.side == turn_) {
+                // The castling and the pawn special kill move two pieces, so the next
+                // turn will need to check the whole board to find a check.
+                bool castling = piece.type == KING_PIECE && std::abs(dest.x - orig.x) == 2;
+                bool specialKill = piece.type == PAWN_PIECE && dest.x != orig.x &&
+                    getPiece(dest) == PIECE_NOT_FOUND;
+                bool result = false;
                 switch (piece.type) {
-                case PAWN_PIECE:   return makePawnMove(piece, dest);
-                case ROOK_PIECE:   return makeRookMove(piece, dest);
-                case KNIGHT_PIECE: return makeKnightMove(piece, dest);
-                case BISHOP_PIECE: return makeBishopMove(piece, dest);
-                case QUEEN_PIECE:  return makeQueenMove(piece, dest);
-                case KING_PIECE:   return makeKingMove(piece, dest);
+                case PAWN_PIECE:   result = makePawnMove(piece, dest);   break;
+                case ROOK_PIECE:   result = makeRookMove(piece, dest);   break;
+                case KNIGHT_PIECE: result = makeKnightMove(piece, dest); break;
+                case BISHOP_PIECE: result = makeBishopMove(piece, dest); break;
+                case QUEEN_PIECE:  result = makeQueenMove(piece, dest);  break;
+                case KING_PIECE:   result = makeKingMove(piece, dest);   break;
+                }
+                if (result) {
+                    lastMove_ = !castling && !specialKill ? GetMove(ChessBitboard::GetSquare(orig),
+                        ChessBitboard::GetSquare(dest)) : NO_LAST_MOVE;
                 }
+                return result;
             }
         }
     }
     return false;
 }
 
+//--------------------------------------------------------------------------------
+
+bool ChessGameData::DoMove(int move, MoveUndo & undo) {
+    // Get the piece to move and save the state to undo the move later.
+    auto origin = GetMoveOrigin(move), destination = GetMoveDestination(move);
+    auto index = board_[origin];
+    if (index == PIECE_NOT_FOUND || pieces_[index].side != turn_) return false;
+    auto & current = pieces_[index];
+    auto side = current.side;
+    auto oldPosition = current.position;
+    auto dest = ChessBitboard::GetCoords(destination);
+
+    undo.move = move;
+    undo.turn = turn_;
+    undo.winner = winner_;
+    undo.whiteCheck = whiteCheck_;
+    undo.blackCheck = blackCheck_;
+    undo.piece = index;
+    undo.pieceType = current.type;
+    undo.pieceMark = current.mark;
+    undo.victim = PIECE_NOT_FOUND;
+    undo.victimType = DEAD_PIECE;
+    undo.rook = PIECE_NOT_FOUND;
+    undo.marked[0] = undo.marked[1] = PIECE_NOT_FOUND;
+
+    // Like in MakeMove, when a side is already in check the move isn't validated again.
+    bool inCheck = side == WHITE_SIDE ? whiteCheck_ : blackCheck_;
+
+    if (current.type == KING_PIECE && std::abs(dest.x - oldPosition.x) == 2) {
+        // The castling needs no check, a free way for the king and a not moved rook.
+        if (inCheck) return false;
+        int inc = dest.x > oldPosition.x ? 1 : -1;
+        movePiece(index, oldPosition + sf::Vector2i(inc, 0));
+        bool passCheck = isKingAttacked(side);
+        movePiece(index, oldPosition);
+        if (passCheck) return false;
+
+        auto rookIndex = getPiece(side == WHITE_SIDE ? 0 : 7, inc > 0 ? 7 : 0);
+        if (rookIndex == PIECE_NOT_FOUND) return false;
+        auto & rook = pieces_[rookIndex];
+        auto rookPosition = rook.position;
+        auto rookDest = sf::Vector2i(dest.x - inc, dest.y);
+        if (rook.type != ROOK_PIECE || rook.side != side || rook.mark == MARK_CANT_CASTLING ||
+            collision(rookPosition, rookDest) || getPiece(rookDest) != PIECE_NOT_FOUND) {
+            return false;
+        }
+
+        movePiece(rookIndex, rookDest);
+        if (isKingAttacked(side)) {
+            movePiece(rookIndex, rookPosition);
+            return false;
+        }
+        movePiece(index, dest);
+        if (isKingAttacked(side)) {
+            movePiece(index, oldPosition);
+            movePiece(rookIndex, rookPosition);
+            return false;
+        }
+
+        undo.rook = rookIndex;
+        undo.rookOrigin = static_cast<signed char>(ChessBitboard::GetSquare(rookPosition));
+        undo.rookMark = rook.mark;
+        setMark(rookIndex, MARK_CANT_CASTLING);
+        setMark(index, MARK_CANT_CASTLING);
+
+    } else {
+        // Find the victim of the move, even the one of the pawn special kill.
+        int victimIndex = board_[destination];
+        if (current.type == PAWN_PIECE && dest.x != oldPosition.x &&
+            victimIndex == PIECE_NOT_FOUND) {
+            victimIndex = getPiece(oldPosition.y, dest.x);
+        }
+        if (victimIndex != PIECE_NOT_FOUND) {
+            undo.victim = victimIndex;
+            undo.victimType = pieces_[victimIndex].type;
+            killPiece(victimIndex);
+        }
+
+        // Move the piece and check that our king is still alive.
+        movePiece(index, dest);
+        if (!inCheck && undo.victimType != KING_PIECE && isKingAttacked(side)) {
+            movePiece(index, oldPosition);
+            if (victimIndex != PIECE_NOT_FOUND) revivePiece(victimIndex, undo.victimType);
+            return false;
+        }
+
+        // Update the marks of the pieces like the make moves methods.
+        if (current.type == PAWN_PIECE) {
+            if (std::abs(dest.y - oldPosition.y) == 2) {
+                for (int i = 0, c = dest.x - 1; c <= dest.x + 1; c += 2, ++i) {
+                    auto enemyIndex = getPiece(dest.y, c);
+                    if (enemyIndex != PIECE_NOT_FOUND && pieces_[enemyIndex].side != side &&
+                        pieces_[enemyIndex].type == PAWN_PIECE) {
+                        undo.marked[i] = enemyIndex;
+                        undo.markedMark[i] = pieces_[enemyIndex].mark;
+                        setMark(enemyIndex, MARK_PAWN_ATTACK);
+                        setMark(index, MARK_PAWN_VICTIM);
+                    }
+                }
+            }
+            // The AI always converts the pawns into queens.
+            if (dest.y == (side == WHITE_SIDE ? LAST_WHITE_ROW : LAST_BLACK_ROW)) {
+                changePiece(index, side, QUEEN_PIECE);
+            }
+        } else if (current.type == KING_PIECE || ((current.type == ROOK_PIECE ||
+            current.type == QUEEN_PIECE) && (dest.x == oldPosition.x || dest.y == oldPosition.y))) {
+            setMark(index, MARK_CANT_CASTLING);
+        }
+    }
+
+    // Change the turn like NextTurn, but the search will find the checkmates.
+    if (winner_ == NO_WINNER) {
+        if (typeBoards_[WHITE_SIDE][KING_PIECE] == ChessBitboard::EMPTY) {
+            SetWinner(BLACK_SIDE);
+        } else if (typeBoards_[BLACK_SIDE][KING_PIECE] == ChessBitboard::EMPTY) {
+            SetWinner(WHITE_SIDE);
+        } else {
+            turn_ = OPPOSITE_SIDE[turn_];
+            whiteCheck_ = turn_ == WHITE_SIDE && isKingAttacked(WHITE_SIDE);
+            blackCheck_ = turn_ == BLACK_SIDE && isKingAttacked(BLACK_SIDE);
+        }
+    }
+    return true;
+}
+
+//--------------------------------------------------------------------------------
+
+void ChessGameData::UndoMove(const MoveUndo & undo) {
+    // Restore the control information of the game.
+    turn_ = undo.turn;
+    winner_ = undo.winner;
+    whiteCheck_ = undo.whiteCheck;
+    blackCheck_ = undo.blackCheck;
+
+    // Restore the moved piece and the killed one.
+    auto & current = pieces_[undo.piece];
+    if (current.type != undo.pieceType) {
+        changePiece(undo.piece, current.side, undo.pieceType);
+    }
+    setMark(undo.piece, undo.pieceMark);
+    movePiece(undo.piece, ChessBitboard::GetCoords(GetMoveOrigin(undo.move)));
+    if (undo.victim != PIECE_NOT_FOUND) {
+        revivePiece(undo.victim, undo.victimType);
+    }
+
+    // Restore the rook of the castling and the marked pawns.
+    if (undo.rook != PIECE_NOT_FOUND) {
+        setMark(undo.rook, undo.rookMark);
+        movePiece(undo.rook, ChessBitboard::GetCoords(undo.rookOrigin));
+    }
+    for (int i = 0; i < 2; ++i) {
+        if (undo.marked[i] != PIECE_NOT_FOUND) {
+            setMark(undo.marked[i], undo.markedMark[i]);
+        }
+    }
+}
+
 //********************************************************************************
 // General Methods (Private)
 //********************************************************************************
 
-const sf::Vector2i * ChessGameData::getMoveOffsets(int side, int type) const {
-    switch (type) {
-    case PAWN_PIECE:
-        if (side == WHITE_SIDE)
-            return WHITE_PAWN_OFFSETS;
-        else if (side == BLACK_SIDE)
-            return BLACK_PAWN_OFFSETS;
-        break;
+int ChessGameData::getPiece(int r, int c) const {
+    // Find a not dead piece at a position.
+    return IsInside(r, c) ? board_[ChessBitboard::GetSquare(r, c)] : PIECE_NOT_FOUND;
+}
 
-    case ROOK_PIECE:   return ROOK_OFFSETS;
-    case KNIGHT_PIECE: return KNIGHT_OFFSETS;
-    case BISHOP_PIECE: return BISHOP_OFFSETS;
-    case QUEEN_PIECE:  return QUEEN_OFFSETS;
-    case KING_PIECE:   return KING_OFFSETS;
-    }
-    return nullptr;
+int ChessGameData::getPiece(const sf::Vector2i & coords) const {
+    // Find a not dead piece at a position.
+    return IsInside(coords) ? board_[ChessBitboard::GetSquare(coords)] : PIECE_NOT_FOUND;
+}
+
+int ChessGameData::getPieceByType(int side, int type) const {
+    // Find the first piece of a type and a side.
+    auto victims = typeBoards_[side][type];
+    return victims != ChessBitboard::EMPTY ?
+        board_[ChessBitboard::First(victims)] : PIECE_NOT_FOUND;
 }
 
 //--------------------------------------------------------------------------------
 
-int ChessGameData::getPiece(int r, int c) const {
+void ChessGameData::updateBoard() {
+    // Clear all the boards and put again the alive pieces.
+    for (int i = 0; i < MAX_SIDES; ++i) {
+        sideBoards_[i] = ChessBitboard::EMPTY;
+        for (int j = 0; j < PIECE_TYPES; ++j) {
+            typeBoards_[i][j] = ChessBitboard::EMPTY;
+        }
+    }
+    for (int i = 0; i < ChessBitboard::MAX_SQUARES; ++i) {
+        board_[i] = PIECE_NOT_FOUND;
+    }
+    hash_ = 0ULL;
     for (int i = 0; i < MAX_PIECES; ++i) {
-        // Find a not dead piece at a position.
-        if (pieces_[i].NotDead() && pieces_[i].position.y == r &&
-            pieces_[i].position.x == c) {
-            return i;
+        if (pieces_[i].NotDead() && IsInside(pieces_[i].position)) {
+            placePiece(i);
         }
     }
-    return PIECE_NOT_FOUND;
+    lastMove_ = NO_LAST_MOVE;
+    exposedKing_ = true;
 }
 
-int ChessGameData::getPiece(const sf::Vector2i & coords) const {
-    for (int i = 0; i < MAX_PIECES; ++i) {
-        // Find a not dead piece at a position.
-        if (pieces_[i].NotDead() && pieces_[i].position == coords) {
-            return i;
+//--------------------------------------------------------------------------------
+
+void ChessGameData::placePiece(int index) {
+    auto & victim = pieces_[index];
+    auto square = ChessBitboard::GetSquare(victim.position);
+    auto mask = ChessBitboard::GetMask(square);
+    sideBoards_[victim.side] |= mask;
+    typeBoards_[victim.side][victim.type] |= mask;
+    board_[square] = static_cast<signed char>(index);
+    hash_ ^= ChessZobrist::PieceKey(victim.side, victim.type, square) ^
+        ChessZobrist::MarkKey(victim.mark, square);
+}
+
+//--------------------------------------------------------------------------------
+
+void ChessGameData::removePiece(int index) {
+    auto & victim = pieces_[index];
+    auto square = ChessBitboard::GetSquare(victim.position);
+    auto mask = ~ChessBitboard::GetMask(square);
+    sideBoards_[victim.side] &= mask;
+    typeBoards_[victim.side][victim.type] &= mask;
+    board_[square] = PIECE_NOT_FOUND;
+    hash_ ^= ChessZobrist::PieceKey(victim.side, victim.type, square) ^
+        ChessZobrist::MarkKey(victim.mark, square);
+}
+
+//--------------------------------------------------------------------------------
+
+void ChessGameData::movePiece(int index, const sf::Vector2i & dest) {
+    if (pieces_[index].NotDead()) {
+        removePiece(index);
+        pieces_[index].position = dest;
+        placePiece(index);
+    } else {
+        pieces_[index].position = dest;
+    }
+}
+
+//--------------------------------------------------------------------------------
+
+void ChessGameData::killPiece(int index) {
+    removePiece(index);
+    pieces_[index].type = DEAD_PIECE;
+}
+
+//--------------------------------------------------------------------------------
+
+void ChessGameData::revivePiece(int index, int type) {
+    pieces_[index].type = type;
+    placePiece(index);
+}
+
+//--------------------------------------------------------------------------------
+
+void ChessGameData::changePiece(int index, int side, int type) {
+    if (pieces_[index].NotDead()) removePiece(index);
+    pieces_[index].side = side;
+    pieces_[index].type = type;
+    if (pieces_[index].NotDead()) placePiece(index);
+}
+
+//--------------------------------------------------------------------------------
+
+void ChessGameData::setMark(int index, int mark) {
+    auto & victim = pieces_[index];
+    if (victim.NotDead()) {
+        auto square = ChessBitboard::GetSquare(victim.position);
+        hash_ ^= ChessZobrist::MarkKey(victim.mark, square) ^
+            ChessZobrist::MarkKey(mark, square);
+    }
+    victim.mark = mark;
+}
+
+//--------------------------------------------------------------------------------
+
+ChessGameData::Bitboard ChessGameData::getPseudoLegalTargets(int index) const {
+    auto & current = pieces_[index];
+    auto square = ChessBitboard::GetSquare(current.position);
+    auto allies = sideBoards_[current.side];
+    auto enemies = sideBoards_[OPPOSITE_SIDE[current.side]];
+    auto occupancy = allies | enemies;
+
+    switch (current.type) {
+    case PAWN_PIECE: {
+            // The pawns can kill in diagonal and move forward to empty cells.
+            auto result = ChessBitboard::PawnAttacks(current.side, square) & enemies;
+            int forward = current.side == WHITE_SIDE ? 1 : -1;
+            int firstRow = current.side == WHITE_SIDE ? WHITE_PAWNS_ROW : BLACK_PAWNS_ROW;
+            int row = current.position.y, col = current.position.x;
+            if (IsInside(row + forward, col) && getPiece(row + forward, col) == PIECE_NOT_FOUND) {
+                result |= ChessBitboard::GetMask(ChessBitboard::GetSquare(row + forward, col));
+                if (row == firstRow && getPiece(row + 2 * forward, col) == PIECE_NOT_FOUND) {
+                    result |= ChessBitboard::GetMask(ChessBitboard::GetSquare(row + 2 * forward, col));
+                }
+            }
+            // And the marked ones can make the special kill over a marked enemy pawn.
+            int specialRow = current.side == WHITE_SIDE ? 4 : 3;
+            if (current.mark == MARK_PAWN_ATTACK && row == specialRow) {
+                for (int c = col - 1; c <= col + 1; c += 2) {
+                    int victimIndex = getPiece(row, c);
+                    if (victimIndex != PIECE_NOT_FOUND &&
+                        pieces_[victimIndex].side != current.side &&
+                        pieces_[victimIndex].type == PAWN_PIECE &&
+                        pieces_[victimIndex].mark == MARK_PAWN_VICTIM &&
+                        getPiece(row + forward, c) == PIECE_NOT_FOUND) {
+                        result |= ChessBitboard::GetMask(ChessBitboard::GetSquare(row + forward, c));
+                    }
+                }
+            }
+            return result;
+        }
+
+    case ROOK_PIECE:   return ChessBitboard::RookAttacks(square, occupancy) & ~allies;
+    case KNIGHT_PIECE: return ChessBitboard::KnightAttacks(square) & ~allies;
+    case BISHOP_PIECE: return ChessBitboard::BishopAttacks(square, occupancy) & ~allies;
+    case QUEEN_PIECE:  return ChessBitboard::QueenAttacks(square, occupancy) & ~allies;
+
+    case KING_PIECE: {
+            // The king can move around and try the castling if it's still possible.
+            auto result = ChessBitboard::KingAttacks(square) & ~allies;
+            if (current.mark != MARK_CANT_CASTLING) {
+                for (int c = current.position.x - 2; c <= current.position.x + 2; c += 4) {
+                    if (IsInside(current.position.y, c)) {
+                        auto dest = ChessBitboard::GetSquare(current.position.y, c);
+                        auto path = ChessBitboard::Between(square, dest) |
+                                    ChessBitboard::GetMask(dest);
+                        if ((path & occupancy) == ChessBitboard::EMPTY) {
+                            result |= ChessBitboard::GetMask(dest);
+                        }
+                    }
+                }
+            }
+            return result;
         }
     }
-    return PIECE_NOT_FOUND;
+    return ChessBitboard::EMPTY;
 }
 
-int ChessGameData::getPieceByType(int side, int type) const {
-    for (int i = 0; i < MAX_PIECES; ++i) {
-        // Find the first piece of a tpe and a side.
-        if (pieces_[i].type == type && pieces_[i].side == side) {
-            return i;
+//--------------------------------------------------------------------------------
+
+bool ChessGameData::isAttacked(int square, int side) const {
+    // Look from the square with every type of piece to find the attackers of a side.
+    auto & victims = typeBoards_[side];
+    auto occupancy = getOccupancy();
+    return (ChessBitboard::PawnAttacks(OPPOSITE_SIDE[side], square) & victims[PAWN_PIECE]) ||
+           (ChessBitboard::KnightAttacks(square) & victims[KNIGHT_PIECE]) ||
+           (ChessBitboard::KingAttacks(square) & victims[KING_PIECE]) ||
+           (ChessBitboard::RookAttacks(square, occupancy) &
+               (victims[ROOK_PIECE] | victims[QUEEN_PIECE])) ||
+           (ChessBitboard::BishopAttacks(square, occupancy) &
+               (victims[BISHOP_PIECE] | victims[QUEEN_PIECE]));
+}
+
+//--------------------------------------------------------------------------------
+
+bool ChessGameData::isKingAttacked(int side) const {
+    auto king = typeBoards_[side][KING_PIECE];
+    return king != ChessBitboard::EMPTY &&
+        isAttacked(ChessBitboard::First(king), OPPOSITE_SIDE[side]);
+}
+
+//--------------------------------------------------------------------------------
+
+ChessGameData::Bitboard ChessGameData::getAttackers(int square, Bitboard occupancy) const {
+    // Look from the square with every type of piece to find the attackers of both sides.
+    auto & whites = typeBoards_[WHITE_SIDE];
+    auto & blacks = typeBoards_[BLACK_SIDE];
+    return (ChessBitboard::PawnAttacks(BLACK_SIDE, square) & whites[PAWN_PIECE]) |
+           (ChessBitboard::PawnAttacks(WHITE_SIDE, square) & blacks[PAWN_PIECE]) |
+           (ChessBitboard::KnightAttacks(square) & (whites[KNIGHT_PIECE] | blacks[KNIGHT_PIECE])) |
+           (ChessBitboard::KingAttacks(square) & (whites[KING_PIECE] | blacks[KING_PIECE])) |
+           (ChessBitboard::RookAttacks(square, occupancy) & (whites[ROOK_PIECE] |
+               blacks[ROOK_PIECE] | whites[QUEEN_PIECE] | blacks[QUEEN_PIECE])) |
+           (ChessBitboard::BishopAttacks(square, occupancy) & (whites[BISHOP_PIECE] |
+               blacks[BISHOP_PIECE] | whites[QUEEN_PIECE] | blacks[QUEEN_PIECE]));
+}
+
+//--------------------------------------------------------------------------------
+
+ChessGameData::Bitboard ChessGameData::getAttacks(int side) const {
+    // Join all the squares under the attack of the pieces of a side.
+    auto & victims = typeBoards_[side];
+    auto occupancy = getOccupancy();
+    auto result = ChessBitboard::EMPTY;
+    for (int type = PAWN_PIECE; type < PIECE_TYPES; ++type) {
+        auto pieces = victims[type];
+        while (pieces != ChessBitboard::EMPTY) {
+            auto square = ChessBitboard::PopFirst(pieces);
+            switch (type) {
+            case PAWN_PIECE:   result |= ChessBitboard::PawnAttacks(side, square);          break;
+            case ROOK_PIECE:   result |= ChessBitboard::RookAttacks(square, occupancy);     break;
+            case KNIGHT_PIECE: result |= ChessBitboard::KnightAttacks(square);              break;
+            case BISHOP_PIECE: result |= ChessBitboard::BishopAttacks(square, occupancy);   break;
+            case QUEEN_PIECE:  result |= ChessBitboard::QueenAttacks(square, occupancy);    break;
+            case KING_PIECE:   result |= ChessBitboard::KingAttacks(square);                break;
+            }
         }
     }
-    return PIECE_NOT_FOUND;
+    return result;
 }
 
 //--------------------------------------------------------------------------------
@@ -362,7 +719,7 @@ void ChessGameData::convertPawnTo(int type) {
             // Convert all the found pawns at their end row.
             if ((pieces_[i].side == WHITE_SIDE && pieces_[i].position.y == LAST_WHITE_ROW) ||
                 (pieces_[i].side == BLACK_SIDE && pieces_[i].position.y == LAST_BLACK_ROW)) {
-                pieces_[i].type = type;
+                changePiece(i, pieces_[i].side, type);
             }
         }
     }
@@ -374,35 +731,19 @@ bool ChessGameData::makeFutureMove(int side, const sf::Vector2i & orig,
     const sf::Vector2i & dest) const {
     ChessGameData future(*this);
     future.turn_ = side;
-    bool result;
-    if (showErrorMessages_) {
-        showErrorMessages_ = false;
-        result = future.MakeMove(orig, dest);
-        showErrorMessages_ = true;
-    } else {
-        result = future.MakeMove(orig, dest);
-    }
-    return result;
+    future.showErrorMessages_ = false;
+    return future.MakeMove(orig, dest);
 }
 
 //--------------------------------------------------------------------------------
 
 bool ChessGameData::isCheck() const {
     if ((turn_ == WHITE_SIDE && !whiteCheck_) || (turn_ == BLACK_SIDE && !blackCheck_)) {
-        // If no previous check state, find the king of the current turn.
-        auto enemySide = OPPOSITE_SIDE[turn_];
-        auto kingIndex = getPieceByType(turn_, KING_PIECE);
-        if (kingIndex != PIECE_NOT_FOUND) {
-            auto & king = pieces_[kingIndex];
-            // Try to move all the enemy pieces to the king's position.
-            for (int i = 0; i < MAX_PIECES; ++i) {
-                auto & enemy = pieces_[i];
-                if (enemy.side == enemySide && enemy.NotDead() &&
-                    makeFutureMove(enemySide, enemy.position, king.position)) {
-                    setErrorMessage(ChessManager::ERROR_CHECK_IF_MOVE);
-                    return true;
-                }
-            }
+        // If no previous check state, find any enemy piece that can kill the king of
+        // the current turn, because the kill of a king is always a valid move.
+        if (isKingAttacked(turn_)) {
+            setErrorMessage(ChessManager::ERROR_CHECK_IF_MOVE);
+            return true;
         }
     }
     return false;
@@ -410,21 +751,57 @@ bool ChessGameData::isCheck() const {
 
 //--------------------------------------------------------------------------------
 
-bool ChessGameData::isCheckmate() const {
-    for (int i = 0; i < MAX_PIECES; ++i) {
-        // Find all the alive pieces of this turn.
-        auto & victim = pieces_[i];
-        if (victim.side == turn_ && victim.NotDead()) {
-            auto * offsets = getMoveOffsets(victim);
-            if (offsets != nullptr) {
-                // For each piece check all the possible moves to do.
-                for (int j = 0; j < MAX_OFFSETS[victim.type]; ++j) {
-                    auto destination = victim.position + offsets[j];
-                    if (makeFutureMove(turn_, victim.position, destination)) {
-                        return false;
-                    }
-                }
-            }
+bool ChessGameData::isCheckAfterMove(int move) const {
+    auto king = typeBoards_[turn_][KING_PIECE];
+    if (king == ChessBitboard::EMPTY) return false;
+    auto kingSquare = ChessBitboard::First(king);
+    auto enemySide = OPPOSITE_SIDE[turn_];
+    auto & enemies = typeBoards_[enemySide];
+    auto occupancy = getOccupancy();
+
+    // Check if the moved piece attacks the king from its new cell.
+    auto destination = GetMoveDestination(move);
+    auto index = board_[destination];
+    if (index != PIECE_NOT_FOUND && pieces_[index].side == enemySide) {
+        Bitboard attacks = ChessBitboard::EMPTY;
+        switch (pieces_[index].type) {
+        case PAWN_PIECE:   attacks = ChessBitboard::PawnAttacks(enemySide, destination);   break;
+        case ROOK_PIECE:   attacks = ChessBitboard::RookAttacks(destination, occupancy);   break;
+        case KNIGHT_PIECE: attacks = ChessBitboard::KnightAttacks(destination);            break;
+        case BISHOP_PIECE: attacks = ChessBitboard::BishopAttacks(destination, occupancy); break;
+        case QUEEN_PIECE:  attacks = ChessBitboard::QueenAttacks(destination, occupancy);  break;
+        case KING_PIECE:   attacks = ChessBitboard::KingAttacks(destination);              break;
+        }
+        if (ChessBitboard::IsSet(attacks, kingSquare)) return true;
+    }
+
+    // Check if the old cell of the piece was hiding the attack of a sliding piece.
+    auto origin = GetMoveOrigin(move);
+    auto line = ChessBitboard::Line(origin, kingSquare);
+    if (line != ChessBitboard::EMPTY) {
+        auto orig = ChessBitboard::GetCoords(origin), dest = ChessBitboard::GetCoords(kingSquare);
+        if (orig.x == dest.x || orig.y == dest.y) {
+            return (ChessBitboard::RookAttacks(kingSquare, occupancy) & line &
+                (enemies[ROOK_PIECE] | enemies[QUEEN_PIECE])) != ChessBitboard::EMPTY;
+        } else {
+            return (ChessBitboard::BishopAttacks(kingSquare, occupancy) & line &
+                (enemies[BISHOP_PIECE] | enemies[QUEEN_PIECE])) != ChessBitboard::EMPTY;
+        }
+    }
+    return false;
+}
+
+//--------------------------------------------------------------------------------
+
+bool ChessGameData::isCheckmate() {
+    // Try the moves in the board until one of them is valid, usually the first one.
+    MoveList moves;
+    MoveUndo undo;
+    GetPseudoLegalMoves(moves);
+    for (int i = 0; i < moves.size; ++i) {
+        if (DoMove(moves.moves[i], undo)) {
+            UndoMove(undo);
+            return false;
         }
     }
     // No move done, then checkmate.
@@ -440,8 +817,8 @@ void ChessGameData::checkAndMarkPawn(Piece & current, int enemySide, int r, int
         // Check the side and the type of the piece and mark the pawns.
         auto & enemy = pieces_[enemyIndex];
         if (enemy.side == enemySide && enemy.type == PAWN_PIECE) {
-            enemy.mark = MARK_PAWN_ATTACK;
-            current.mark = MARK_PAWN_VICTIM;
+            setMark(enemyIndex, MARK_PAWN_ATTACK);
+            setMark(getIndex(current), MARK_PAWN_VICTIM);
         }
     }
 }
@@ -449,24 +826,14 @@ void ChessGameData::checkAndMarkPawn(Piece & current, int enemySide, int r, int
 //--------------------------------------------------------------------------------
 
 bool ChessGameData::collision(const sf::Vector2i & orig, const sf::Vector2i & dest) {
-    auto delta = dest - orig;
-    if (delta.x == 0 || delta.y == 0 || std::abs(delta.x) == std::abs(delta.y)) {
-        // Only check horizontal, vertical and diagonal moves.
-        auto transform = [] (int x) -> int {
-            if (x < 0) return -1;
-            else if (x > 0) return 1;
-            else return 0;
-        };
-        delta.x = transform(delta.x);
-        delta.y = transform(delta.y);
-        // Try to find any piece in the middle of the trajectory-
-        for (auto pos = orig + delta; pos != dest; pos += delta) {
-            if (getPiece(pos) != PIECE_NOT_FOUND) {
-                return true;
-            }
-        }
-        // Nothing found, then no collision.
+    auto from = ChessBitboard::GetSquare(orig), to = ChessBitboard::GetSquare(dest);
+    if (from == to) {
+        // No trajectory, then no collision.
         return false;
+    } else if (ChessBitboard::Line(from, to) != ChessBitboard::EMPTY) {
+        // Only check horizontal, vertical and diagonal moves, trying to find
+        // any piece in the middle of the trajectory.
+        return (ChessBitboard::Between(from, to) & getOccupancy()) != ChessBitboard::EMPTY;
     } else {
         // Invalid type of movement, collision by nonsense.
         return true;
@@ -483,10 +850,10 @@ bool ChessGameData::makeWhitePawnMove(Piece & current, const sf::Vector2i & dest
             if (getPiece(dest.y - 1, dest.x) == PIECE_NOT_FOUND &&
                 getPiece(dest) == PIECE_NOT_FOUND) {
                 auto oldPosition = current.position;
-                current.position = dest;
+                movePiece(getIndex(current), dest);
                 if (isCheck()) {
                     // You cant move the piece or the king dies.
-                    current.position = oldPosition;
+                    movePiece(getIndex(current), oldPosition);
                 } else {
                     // Check if the pawn must be marked and validate the move.
                     checkAndMarkPawn(current, BLACK_SIDE, dest.y, dest.x - 1);
@@ -498,10 +865,10 @@ bool ChessGameData::makeWhitePawnMove(Piece & current, const sf::Vector2i & dest
             // Move forward 1 cell if nobody is in the way.
             if (getPiece(dest) == PIECE_NOT_FOUND) {
                 auto oldPosition = current.position;
-                current.position = dest;
+                movePiece(getIndex(current), dest);
                 if (isCheck()) {
                     // You cant move the piece or the king dies.
-                    current.position = oldPosition;
+                    movePiece(getIndex(current), oldPosition);
                 } else {
                     // Validate the move.
                     return true;
@@ -516,12 +883,12 @@ bool ChessGameData::makeWhitePawnMove(Piece & current, const sf::Vector2i & dest
             // Lets try to make a normal kill.
             auto oldPosition = current.position;
             auto oldType = pieces_[index].type;
-            current.position = dest;
-            pieces_[index].type = DEAD_PIECE;
+            killPiece(index);
+            movePiece(getIndex(current), dest);
             if (oldType != KING_PIECE && isCheck()) {
                 // You cant move the piece or the king dies.
-                current.position = oldPosition;
-                pieces_[index].type = oldType;
+                movePiece(getIndex(current), oldPosition);
+                revivePiece(index, oldType);
             } else {
                 // Validate the move.
                 return true;
@@ -534,12 +901,12 @@ bool ChessGameData::makeWhitePawnMove(Piece & current, const sf::Vector2i & dest
                 // Lets try to make the special kill.
                 auto oldPosition = current.position;
                 auto oldType = pieces_[index].type;
-                current.position = dest;
-                pieces_[index].type = DEAD_PIECE;
+                killPiece(index);
+                movePiece(getIndex(current), dest);
                 if (oldType != KING_PIECE && isCheck()) {
                     // You cant move the piece or the king dies.
-                    current.position = oldPosition;
-                    pieces_[index].type = oldType;
+                    movePiece(getIndex(current), oldPosition);
+                    revivePiece(index, oldType);
                 } else {
                     // Validate the move.
                     return true;
@@ -560,10 +927,10 @@ bool ChessGameData::makeBlackPawnMove(Piece & current, const sf::Vector2i & dest
             if (getPiece(dest.y + 1, dest.x) == PIECE_NOT_FOUND &&
                 getPiece(dest) == PIECE_NOT_FOUND) {
                 auto oldPosition = current.position;
-                current.position = dest;
+                movePiece(getIndex(current), dest);
                 if (isCheck()) {
                     // You cant move the piece or the king dies.
-                    current.position = oldPosition;
+                    movePiece(getIndex(current), oldPosition);
                 } else {
                     // Check if the pawn must be marked and validate the move.
                     checkAndMarkPawn(current, WHITE_SIDE, dest.y, dest.x - 1);
@@ -575,10 +942,10 @@ bool ChessGameData::makeBlackPawnMove(Piece & current, const sf::Vector2i & dest
             // Move forward 1 cell if nobody is in the way.
             if (getPiece(dest) == PIECE_NOT_FOUND) {
                 auto oldPosition = current.position;
-                current.position = dest;
+                movePiece(getIndex(current), dest);
                 if (isCheck()) {
                     // You cant move the piece or the king dies.
-                    current.position = oldPosition;
+                    movePiece(getIndex(current), oldPosition);
                 } else {
                     // Validate the move.
                     return true;
@@ -593,12 +960,12 @@ bool ChessGameData::makeBlackPawnMove(Piece & current, const sf::Vector2i & dest
             // Lets try to make a normal kill.
             auto oldPosition = current.position;
             auto oldType = pieces_[index].type;
-            current.position = dest;
-            pieces_[index].type = DEAD_PIECE;
+            killPiece(index);
+            movePiece(getIndex(current), dest);
             if (oldType != KING_PIECE && isCheck()) {
                 // You cant move the piece or the king dies.
-                current.position = oldPosition;
-                pieces_[index].type = oldType;
+                movePiece(getIndex(current), oldPosition);
+                revivePiece(index, oldType);
             } else {
                 // Validate the move.
                 return true;
@@ -611,12 +978,12 @@ bool ChessGameData::makeBlackPawnMove(Piece & current, const sf::Vector2i & dest
                 // Lets try to make the special kill.
                 auto oldPosition = current.position;
                 auto oldType = pieces_[index].type;
-                current.position = dest;
-                pieces_[index].type = DEAD_PIECE;
+                killPiece(index);
+                movePiece(getIndex(current), dest);
                 if (oldType != KING_PIECE && isCheck()) {
                     // You cant move the piece or the king dies.
-                    current.position = oldPosition;
-                    pieces_[index].type = oldType;
+                    movePiece(getIndex(current), oldPosition);
+                    revivePiece(index, oldType);
                 } else {
                     // Validate the move.
                     return true;
@@ -645,10 +1012,10 @@ bool ChessGameData::makeGenericMove(Piece & current, const sf::Vector2i & dest)
     if (getPiece(dest) == PIECE_NOT_FOUND) {
         // Just move the piece, because nobody is at the end of my way.
         auto oldPosition = current.position;
-        current.position = dest;
+        movePiece(getIndex(current), dest);
         if (isCheck()) {
             // You cant move the piece or the king dies.
-            current.position = oldPosition;
+            movePiece(getIndex(current), oldPosition);
         } else {
             // Validate the move.
             return true;
@@ -657,12 +1024,12 @@ bool ChessGameData::makeGenericMove(Piece & current, const sf::Vector2i & dest)
         // An enemy is going to die in my path of destruction.
         auto oldPosition = current.position;
         auto oldType = pieces_[index].type;
-        current.position = dest;
-        pieces_[index].type = DEAD_PIECE;
+        killPiece(index);
+        movePiece(getIndex(current), dest);
         if (oldType != KING_PIECE && isCheck()) {
             // You cant move the piece or the king dies.
-            current.position = oldPosition;
-            pieces_[index].type = oldType;
+            movePiece(getIndex(current), oldPosition);
+            revivePiece(index, oldType);
         } else {
             // Validate the move.
             return true;
@@ -676,7 +1043,7 @@ bool ChessGameData::makeGenericMove(Piece & current, const sf::Vector2i & dest)
 bool ChessGameData::makeRookMove(Piece & current, const sf::Vector2i & dest) {
     if ((current.position.x == dest.x || current.position.y == dest.y) &&
         !collision(current.position, dest) && makeGenericMove(current, dest)) {
-        current.mark = MARK_CANT_CASTLING;
+        setMark(getIndex(current), MARK_CANT_CASTLING);
         return true;
     }
     return false;
@@ -719,9 +1086,9 @@ bool ChessGameData::makeKingCastling(Piece & current, const sf::Vector2i & dest)
         current.mark != MARK_CANT_CASTLING && !collision(current.position, dest)) {
         auto isCheckIfMove = [&] (int inc) -> bool {
             auto oldPosition = current.position;
-            current.position.x += inc;
+            movePiece(getIndex(current), oldPosition + sf::Vector2i(inc, 0));
             auto result = isCheck();
-            current.position = oldPosition;
+            movePiece(getIndex(current), oldPosition);
             return result;
         };
         if (current.position.x < dest.x && !isCheckIfMove(1)) {
@@ -735,15 +1102,15 @@ bool ChessGameData::makeKingCastling(Piece & current, const sf::Vector2i & dest)
                     auto oldRookPosition = victim.position;
                     if (makeRookMove(victim, sf::Vector2i(dest.x - 1, dest.y))) {
                         auto oldPosition = current.position;
-                        current.position = dest;
+                        movePiece(getIndex(current), dest);
                         if (isCheck()) {
                             // You cant move the piece or the king dies.
-                            victim.mark = MARK_NONE;
-                            victim.position = oldRookPosition;
-                            current.position = oldPosition;
+                            setMark(index, MARK_NONE);
+                            movePiece(getIndex(victim), oldRookPosition);
+                            movePiece(getIndex(current), oldPosition);
                         } else {
                             // Validate the move.
-                            current.mark = MARK_CANT_CASTLING;
+                            setMark(getIndex(current), MARK_CANT_CASTLING);
                             return true;
                         }
                     }
@@ -760,15 +1127,15 @@ bool ChessGameData::makeKingCastling(Piece & current, const sf::Vector2i & dest)
                     auto oldRookPosition = victim.position;
                     if (makeRookMove(victim, sf::Vector2i(dest.x + 1, dest.y))) {
                         auto oldPosition = current.position;
-                        current.position = dest;
+                        movePiece(getIndex(current), dest);
                         if (isCheck()) {
                             // You cant move the piece or the king dies.
-                            victim.mark = MARK_NONE;
-                            victim.position = oldRookPosition;
-                            current.position = oldPosition;
+                            setMark(index, MARK_NONE);
+                            movePiece(getIndex(victim), oldRookPosition);
+                            movePiece(getIndex(current), oldPosition);
                         } else {
                             // Validate the move.
-                            current.mark = MARK_CANT_CASTLING;
+                            setMark(getIndex(current), MARK_CANT_CASTLING);
                             return true;
                         }
                     }
@@ -788,7 +1155,7 @@ bool ChessGameData::makeKingMove(Piece & current, const sf::Vector2i & dest) {
         (ox == dest.x && (oy == dest.y - 1 || oy == dest.y + 1)) ||
         (ox == dest.x + 1 && dest.y - 1 <= oy && oy <= dest.y + 1)) &&
         makeGenericMove(current, dest)) {
-        current.mark = MARK_CANT_CASTLING;
+        setMark(getIndex(current), MARK_CANT_CASTLING);
         return true;
     } else if (oy == dest.y && (ox == dest.x - 2 || ox == dest.x + 2)) {
         return makeKingCastling(current, dest);
@@ -861,25 +1228,42 @@ void ChessGameData::GetPossibleMoves(CoordsVector & victims, const sf::Vector2i
     victims.clear();
     auto index = getPiece(coords);
     if (index != PIECE_NOT_FOUND && pieces_[index].side == turn_) {
-        auto * offsets = getMoveOffsets(pieces_[index]);
-        if (offsets != nullptr) {
-            for (int j = 0; j < MAX_OFFSETS[pieces_[index].type]; ++j) {
-                auto destination = pieces_[index].position + offsets[j];
-                if (makeFutureMove(turn_, pieces_[index].position, destination)) {
-                    victims.push_back(destination);
-                }
+        auto targets = getPseudoLegalTargets(index);
+        while (targets != ChessBitboard::EMPTY) {
+            auto destination = ChessBitboard::GetCoords(ChessBitboard::PopFirst(targets));
+            if (makeFutureMove(turn_, pieces_[index].position, destination)) {
+                victims.push_back(destination);
             }
         }
     }
 }
 
+//--------------------------------------------------------------------------------
+
+void ChessGameData::GetPseudoLegalMoves(MoveList & victims) const {
+    victims.Clear();
+    auto pieces = sideBoards_[turn_];
+    while (pieces != ChessBitboard::EMPTY) {
+        // Add all the possible destinations for each alive piece of the turn.
+        auto origin = ChessBitboard::PopFirst(pieces);
+        auto targets = getPseudoLegalTargets(board_[origin]);
+        while (targets != ChessBitboard::EMPTY) {
+            victims.Add(origin, ChessBitboard::PopFirst(targets));
+        }
+    }
+}
+
 //********************************************************************************
 // Constructors, destructor and operators
 //********************************************************************************
 
 ChessGameData::ChessGameData() : singlePlayer_(false), difficulty_(NORMAL_LEVEL),
     playerSide_(WHITE_SIDE), winner_(NO_WINNER), turn_(WHITE_SIDE), whiteCheck_(false),
-    blackCheck_(false) {}
+    blackCheck_(false), showErrorMessages_(true) {
+    ChessBitboard::Initialize();
+    ChessZobrist::Initialize();
+    updateBoard();
+}
 
 //--------------------------------------------------------------------------------
 
@@ -901,8 +1285,15 @@ ChessGameData & ChessGameData::operator =(const ChessGameData & source) {
     turn_ = source.turn_;
     whiteCheck_ = source.whiteCheck_;
     blackCheck_ = source.blackCheck_;
+    showErrorMessages_ = source.showErrorMessages_;
     ForEachInPieces([&] (Piece &, int i) {
         pieces_[i] = source.pieces_[i];
     });
+    lastMove_ = source.lastMove_;
+    exposedKing_ = source.exposedKing_;
+    std::memcpy(sideBoards_, source.sideBoards_, sizeof(sideBoards_));
+    std::memcpy(typeBoards_, source.typeBoards_, sizeof(typeBoards_));
+    std::memcpy(board_, source.board_, sizeof(board_));
+    hash_ = source.hash_;
     return *this;
 }
@@ -23,9 +23,12 @@
 #ifndef __CHESS_GAME_DATA_HEADER__
 #define __CHESS_GAME_DATA_HEADER__
 
+#include <string>
 #include <vector>
 #include <functional>
 #include <SFML/Graphics/Rect.hpp>
+#include <Games/Chess/ChessBitboard.h>
+#include <Games/Chess/ChessZobrist.h>
 
 /**
  * This class represents the chess board game data.
@@ -34,6 +37,7 @@ class ChessGameData {
 public:
     friend class SaveManager;
     friend class ChessMiniMax;
+    friend class ChessTablebase;
 
     //--------------------------------------------------------------------------------
     // Constants
@@ -77,22 +81,9 @@ public:
     static const int BLACK_PIECES_END   = 32;
 
     static const sf::Vector2i NO_CELL;
-    static const int MAX_OFFSETS[PIECE_TYPES];
-
-    static const int MAX_PAWN_OFFSETS   =  4;
-    static const int MAX_ROOK_OFFSETS   = 28;
-    static const int MAX_KNIGHT_OFFSETS =  8;
-    static const int MAX_BISHOP_OFFSETS = 28;
-    static const int MAX_QUEEN_OFFSETS  = 56;
-    static const int MAX_KING_OFFSETS   = 10;
-
-    static const sf::Vector2i WHITE_PAWN_OFFSETS[MAX_PAWN_OFFSETS];
-    static const sf::Vector2i BLACK_PAWN_OFFSETS[MAX_PAWN_OFFSETS];
-    static const sf::Vector2i ROOK_OFFSETS[MAX_ROOK_OFFSETS];
-    static const sf::Vector2i KNIGHT_OFFSETS[MAX_KNIGHT_OFFSETS];
-    static const sf::Vector2i BISHOP_OFFSETS[MAX_BISHOP_OFFSETS];
-    static const sf::Vector2i QUEEN_OFFSETS[MAX_QUEEN_OFFSETS];
-    static const sf::Vector2i KING_OFFSETS[MAX_KING_OFFSETS];
+
+    static const int MAX_MOVES      =  256;
+    static const int MAX_MOVE_CODES = 4096;
 
     static const int MARK_NONE          = 0;
     static const int MARK_PAWN_ATTACK   = 1;
@@ -116,6 +107,27 @@ public:
 
     typedef Piece BoardPieces[MAX_PIECES];
     typedef std::vector<sf::Vector2i> CoordsVector;
+    typedef ChessBitboard::Bitboard Bitboard;
+    typedef ChessZobrist::HashKey HashKey;
+
+    struct MoveList {
+        int size;
+        int moves[MAX_MOVES];
+        MoveList() : size(0) {}
+        void Clear() { size = 0; }
+        void Add(int origin, int destination) {
+            if (size < MAX_MOVES) moves[size++] = GetMove(origin, destination);
+        }
+    };
+
+    struct MoveUndo {
+        int move, turn, winner;
+        bool whiteCheck, blackCheck;
+        signed char piece, pieceType, pieceMark;
+        signed char victim, victimType;
+        signed char rook, rookOrigin, rookMark;
+        signed char marked[2], markedMark[2];
+    };
 
     //--------------------------------------------------------------------------------
     // Properties
@@ -132,6 +144,10 @@ public:
 
     bool GameOver() const { return winner_ != NO_WINNER; }
 
+    HashKey Hash() const {
+        return turn_ == BLACK_SIDE ? hash_ ^ ChessZobrist::SideKey() : hash_;
+    }
+
     //--------------------------------------------------------------------------------
     // General Methods
     //--------------------------------------------------------------------------------
@@ -143,12 +159,13 @@ public:
         }
     }
 
-    static void ShowErrorMessages(bool value) {
+    void ShowErrorMessages(bool value) {
         showErrorMessages_ = value;
     }
 
     void Start(bool singlePlayer, int difficulty, int playerSide);
     void Reset();
+    bool LoadFEN(const std::string & fen);
 
     void SetWinner(int side);
     void NextTurn();
@@ -163,6 +180,9 @@ public:
         return MakeMove(sf::Vector2i(c1, r1), sf::Vector2i(c2, r2));
     }
 
+    bool DoMove(int move, MoveUndo & undo);
+    void UndoMove(const MoveUndo & undo);
+
     //--------------------------------------------------------------------------------
     // Query Methods
     //--------------------------------------------------------------------------------
@@ -173,6 +193,11 @@ public:
     bool AnyPawnToConvert() const;
     void GetCandidates(CoordsVector & victims) const;
     void GetPossibleMoves(CoordsVector & victims, const sf::Vector2i & coords) const;
+    void GetPseudoLegalMoves(MoveList & victims) const;
+
+    static int GetMove(int origin, int destination) { return origin | (destination << 6); }
+    static int GetMoveOrigin(int move) { return move & 63; }
+    static int GetMoveDestination(int move) { return (move >> 6) & 63; }
 
     //--------------------------------------------------------------------------------
     // Constructors, destructor and operators
@@ -197,29 +222,56 @@ private:
     bool whiteCheck_;
     bool blackCheck_;
     BoardPieces pieces_;
+    int lastMove_;
+    bool exposedKing_;
+
+    Bitboard sideBoards_[MAX_SIDES];
+    Bitboard typeBoards_[MAX_SIDES][PIECE_TYPES];
+    signed char board_[ChessBitboard::MAX_SQUARES];
+    HashKey hash_;
 
-    static bool showErrorMessages_;
+    bool showErrorMessages_;
 
     //--------------------------------------------------------------------------------
     // General Methods
     //--------------------------------------------------------------------------------
 
-    const sf::Vector2i * getMoveOffsets(int side, int type) const;
-    const sf::Vector2i * getMoveOffsets(const Piece & piece) const {
-        return getMoveOffsets(piece.side, piece.type);
+    int getIndex(const Piece & piece) const {
+        return static_cast<int>(&piece - pieces_);
+    }
+
+    Bitboard getOccupancy() const {
+        return sideBoards_[WHITE_SIDE] | sideBoards_[BLACK_SIDE];
     }
 
     int getPiece(int r, int c) const;
     int getPiece(const sf::Vector2i & coords) const;
     int getPieceByType(int side, int type) const;
 
+    void updateBoard();
+    void placePiece(int index);
+    void removePiece(int index);
+    void movePiece(int index, const sf::Vector2i & dest);
+    void killPiece(int index);
+    void revivePiece(int index, int type);
+    void changePiece(int index, int side, int type);
+    void setMark(int index, int mark);
+
+    Bitboard getPseudoLegalTargets(int index) const;
+
+    bool isAttacked(int square, int side) const;
+    bool isKingAttacked(int side) const;
+    Bitboard getAttackers(int square, Bitboard occupancy) const;
+    Bitboard getAttacks(int side) const;
+
     void convertPawnTo(int type);
 
     bool makeFutureMove(int side, const sf::Vector2i & orig,
         const sf::Vector2i & dest) const;
 
     bool isCheck() const;
-    bool isCheckmate() const;
+    bool isCheckAfterMove(int move) const;
+    bool isCheckmate();
 
     void checkAndMarkPawn(Piece & current, int enemySide, int r, int c);
     bool collision(const sf::Vector2i & orig, const sf::Vector2i & dest);
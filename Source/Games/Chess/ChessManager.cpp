@@ -364,6 +364,13 @@ void ChessManager::Initialize() {
         data_->clickSound.Load("Content/Sounds/SharedClick.wav");
         data_->wrongSound.Load("Content/Sounds/SharedWrong.wav");
 
+        // Use all the processors of the machine to think the moves.
+        data_->solver.Threads(data_->core->ProcessorCount());
+
+        // Load the opening book and the tablebases, the first time they are generated.
+        data_->solver.LoadBook("ChessBook.bin");
+        data_->solver.LoadTablebase("");
+
         // Loads the previous saved data.
         SaveManager::Instance()->ChessLoad();
 
@@ -391,6 +398,9 @@ void ChessManager::Release() {
         // Unload the textures of the game.
         data_->tileset = nullptr;
 
+        // Stop the machine if it is still thinking.
+        data_->solver.Cancel();
+
         // Remove the inner data of the game.
         data_.reset(nullptr);
     }
@@ -572,16 +582,18 @@ bool ChessManager::PawnToChange() {
 void ChessManager::UpdateMachine(const sf::Time & timeDelta) {
     if (!data_->game.GameOver()) {
         if (data_->aiExecuteMove) {
+            // The machine thinks in the background, so only check if the move is ready.
             data_->aiCurrentTime += timeDelta.asMilliseconds();
-            if (data_->aiCurrentTime >= AI_TIME_INTERVAL) {
+            if (data_->aiCurrentTime >= AI_TIME_INTERVAL && data_->solver.Ready()) {
                 data_->aiCurrentTime -= AI_TIME_INTERVAL;
+                data_->aiCurrentMove = data_->solver.Finish(data_->game);
                 data_->ClearAllErrorMessages();
                 data_->aiCurrentMove.MakeMove(data_->game);
                 data_->game.GetCandidates(data_->candidateCells);
                 data_->aiExecuteMove = false;
             }
         } else {
-            data_->aiCurrentMove = data_->solver.Execute(data_->game);
+            data_->solver.Launch(data_->game);
             data_->aiCurrentTime = 0;
             data_->aiExecuteMove = true;
         }
@@ -22,7 +22,10 @@
 
 #include "ChessMiniMax.h"
 #include <limits>
+#include <cstring>
+#include <algorithm>
 #include <System/ForEach.h>
+#include <System/SafeDelete.h>
 
 //********************************************************************************
 // Constants
@@ -31,8 +34,11 @@
 const int INITIAL_ALPHA = std::numeric_limits<int>::min();
 const int INITIAL_BETA  = std::numeric_limits<int>::max();
 
-const int AI_DEFEAT  = std::numeric_limits<int>::min();
-const int AI_VICTORY = std::numeric_limits<int>::max();
+const int AI_DEFEAT  = -1000000;
+const int AI_VICTORY =  1000000;
+const int AI_DRAW    = ChessMiniMax::DRAW_SCORE;
+
+const int MATE_BOUND = AI_VICTORY - 1000;
 
 const int PAWN_VALUE   =     1;
 const int ROOK_VALUE   =     5;
@@ -60,6 +66,25 @@ const int POSITION_VALUE =  1;
 const int THREAT_VALUE   = 16;
 const int ALIVE_VALUE    = 64;
 
+const int CHECK_BUDGET_MASK = 1023;
+
+const int       HELPER_TIME_BUDGET = std::numeric_limits<int>::max();
+const long long HELPER_NODE_BUDGET = std::numeric_limits<long long>::max();
+
+const int HASH_MOVE_SCORE = 1 << 30;
+const int CAPTURE_SCORE   = 1 << 29;
+const int KILLER_SCORE    = 1 << 28;
+const int MAX_HISTORY     = 1 << 20;
+const int VICTIM_FACTOR   = 128;
+
+const int EASY_TIME_BUDGET   =  250;
+const int NORMAL_TIME_BUDGET = 1000;
+const int HARD_TIME_BUDGET   = 3000;
+
+const long long EASY_NODE_BUDGET   =    20000;
+const long long NORMAL_NODE_BUDGET =   250000;
+const long long HARD_NODE_BUDGET   = 20000000;
+
 const int NORMAL_STATE     = 0;
 const int QUEEN_END_STATE  = 1;
 const int ROOK_END_STATE   = 2;
@@ -74,6 +99,10 @@ ChessMove::ChessMove() : origin(-1, -1), destination(-1, -1) {}
 ChessMove::ChessMove(const sf::Vector2i & orig, const sf::Vector2i & dest)
     : origin(orig), destination(dest) {}
 
+ChessMove::ChessMove(int move)
+    : origin(ChessBitboard::GetCoords(ChessGameData::GetMoveOrigin(move))),
+      destination(ChessBitboard::GetCoords(ChessGameData::GetMoveDestination(move))) {}
+
 //--------------------------------------------------------------------------------
 
 bool ChessMove::MakeMove(ChessGameData & victim) {
@@ -93,21 +122,109 @@ bool ChessMove::MakeMove(ChessGameData & victim) {
 //********************************************************************************
 
 void ChessMiniMax::Initialize(int difficulty) {
+    Cancel();
+    table_->Clear();
     state_ = NORMAL_STATE;
     if (difficulty == ChessGameData::HARD_LEVEL) {
-        maxDepth_ = 3;
+        timeBudget_ = HARD_TIME_BUDGET;
+        nodeBudget_ = HARD_NODE_BUDGET;
     } else if (difficulty == ChessGameData::NORMAL_LEVEL) {
-        maxDepth_ = 2;
+        timeBudget_ = NORMAL_TIME_BUDGET;
+        nodeBudget_ = NORMAL_NODE_BUDGET;
     } else {
-        maxDepth_ = 1;
+        timeBudget_ = EASY_TIME_BUDGET;
+        nodeBudget_ = EASY_NODE_BUDGET;
     }
+    depthBudget_ = MAX_DEPTH;
+    std::memset(history_, 0, sizeof(history_));
+    ForEach(helpers_, [] (ChessMiniMax * helper) {
+        std::memset(helper->history_, 0, sizeof(helper->history_));
+    });
 }
 
 //--------------------------------------------------------------------------------
 
 ChessMove ChessMiniMax::Execute(ChessGameData & data) {
-    if (state_ == NORMAL_STATE) checkState(data);
-    return minimax(data, 0, INITIAL_ALPHA, INITIAL_BETA);
+    prepare(data);
+    think();
+    return Finish(data);
+}
+
+//--------------------------------------------------------------------------------
+
+void ChessMiniMax::Launch(const ChessGameData & data) {
+    prepare(data);
+    task_ = ThinkService::Instance()->Submit([this] (const ThinkTask & task) {
+        thinkTask_ = &task;
+        think();
+        thinkTask_ = nullptr;
+    });
+}
+
+//--------------------------------------------------------------------------------
+
+ChessMove ChessMiniMax::Finish(ChessGameData & data) {
+    // Wait the end of the search and set the check state found in the root.
+    if (task_) task_->Wait();
+    task_ = nullptr;
+    data.whiteCheck_ = data.blackCheck_ = checkmate_;
+    return bestMove_;
+}
+
+//--------------------------------------------------------------------------------
+
+void ChessMiniMax::Budget(int milliseconds, long long nodes, int depth) {
+    Cancel();
+    timeBudget_ = milliseconds;
+    nodeBudget_ = nodes;
+    depthBudget_ = depth < MAX_DEPTH ? depth : MAX_DEPTH;
+}
+
+//--------------------------------------------------------------------------------
+
+void ChessMiniMax::LoadBook(const std::string & path) {
+    Cancel();
+    book_->Load(path);
+}
+
+//--------------------------------------------------------------------------------
+
+void ChessMiniMax::LoadTablebase(const std::string & directory) {
+    Cancel();
+    tablebase_->Load(directory);
+}
+
+//--------------------------------------------------------------------------------
+
+void ChessMiniMax::TableSize(int megabytes) {
+    Cancel();
+    table_->Resize(megabytes);
+}
+
+//--------------------------------------------------------------------------------
+
+void ChessMiniMax::Threads(int count) {
+    // Only the main search can change the number of helper threads.
+    if (helperIndex_ == 0) {
+        Cancel();
+        deleteHelpers();
+        if (count > MAX_THREADS) count = MAX_THREADS;
+        for (int i = 1; i < count; ++i) {
+            helpers_.push_back(new ChessMiniMax(*this, i));
+        }
+    }
+}
+
+//--------------------------------------------------------------------------------
+
+void ChessMiniMax::Cancel() {
+    stop_ = true;
+    if (task_) {
+        task_->Cancel();
+        task_->Wait();
+        task_ = nullptr;
+    }
+    ready_ = false;
 }
 
 //********************************************************************************
@@ -117,7 +234,7 @@ ChessMove ChessMiniMax::Execute(ChessGameData & data) {
 void ChessMiniMax::checkState(ChessGameData & data) {
     // Count all the types of pieces by side.
     int countPieces[ChessGameData::MAX_SIDES][ChessGameData::PIECE_TYPES];
-    std::memset(countPieces, 0, ChessGameData::MAX_SIDES * ChessGameData::PIECE_TYPES);
+    std::memset(countPieces, 0, sizeof(countPieces));
     for (int i = 0; i < ChessGameData::MAX_PIECES; ++i) {
         auto & victim = data.pieces_[i];
         if (victim.NotDead()) {
@@ -152,65 +269,389 @@ void ChessMiniMax::checkState(ChessGameData & data) {
 
 //--------------------------------------------------------------------------------
 
-void ChessMiniMax::getPossibleAllMoves(ChessGameData & data, ChessMoveVector & moves) {
-    // Check all the pieces of the current turn that are alive.
-    for (int i = 0; i < ChessGameData::MAX_PIECES; ++i) {
-        auto & victim = data.pieces_[i];
-        if (victim.side == data.turn_ && victim.NotDead()) {
-            // And add all the possible destinations for each of them.
-            auto * offsets = data.getMoveOffsets(victim);
-            if (offsets != nullptr) {
-                for (int j = 0; j < ChessGameData::MAX_OFFSETS[victim.type]; ++j) {
-                    auto destination = victim.position + offsets[j];
-                    moves.push_back(ChessMove(victim.position, destination));
-                }
-            }
+void ChessMiniMax::prepare(const ChessGameData & data) {
+    // Stop any previous search and take a copy of the board to think with it.
+    Cancel();
+    board_ = data;
+    board_.ShowErrorMessages(false);
+    if (state_ == NORMAL_STATE) {
+        // The old scores of the table are useless with a new way to evaluate.
+        checkState(board_);
+        if (state_ != NORMAL_STATE) table_->Clear();
+    }
+    table_->NewSearch();
+    reset();
+}
+
+//--------------------------------------------------------------------------------
+
+void ChessMiniMax::reset() {
+    bestMove_ = ChessMove();
+    depth_ = 0;
+    score_ = AI_DRAW;
+    checkmate_ = false;
+    stop_ = false;
+    std::memset(&stats_, 0, sizeof(stats_));
+    clock_.restart();
+
+    // Forget the killer moves and the oldest part of the history of the moves.
+    for (int i = 0; i <= MAX_DEPTH; ++i) {
+        killers_[i][0] = killers_[i][1] = ChessTranspositionTable::NO_MOVE;
+    }
+    for (int i = 0; i < ChessGameData::MAX_SIDES; ++i) {
+        for (int j = 0; j < ChessGameData::MAX_MOVE_CODES; ++j) {
+            history_[i][j] /= 2;
         }
     }
 }
 
 //--------------------------------------------------------------------------------
 
-ChessMove ChessMiniMax::minimax(ChessGameData & data, int depth, int alpha, int beta) {
-    ChessMove result;
-    ChessGameData::ShowErrorMessages(false);
-    if (!data.GameOver()) {
-        // If the game is not over, get all the moves inside the board.
-        ChessMoveVector moves;
-        getPossibleAllMoves(data, moves);
-
-        // If we have some moves to check, we'll test if there is a checkmate.
-        if (!moves.empty()) {
-            if (data.isCheckmate()) {
-                data.whiteCheck_ = data.blackCheck_ = true;
-                // Find the first move to do and return it.
-                auto it = moves.begin(), end = moves.end();
-                for (; it != end; ++it) {
-                    ChessGameData future(data);
-                    if (it->MakeMove(future)) {
-                        return ChessMove(*it);
-                    }
+void ChessMiniMax::think() {
+    if (!board_.GameOver()) {
+        // Get only the legal moves of the root, without any previous check state.
+        ChessGameData::MoveList moves, legalMoves;
+        ChessGameData::MoveUndo undo;
+        board_.GetPseudoLegalMoves(moves);
+        board_.whiteCheck_ = board_.blackCheck_ = false;
+        for (int i = 0; i < moves.size; ++i) {
+            if (board_.DoMove(moves.moves[i], undo)) {
+                board_.UndoMove(undo);
+                legalMoves.moves[legalMoves.size++] = moves.moves[i];
+            }
+        }
+
+        if (legalMoves.size == 0) {
+            // If there is no legal move, we have a checkmate, so find the first move to do.
+            checkmate_ = true;
+            board_.whiteCheck_ = board_.blackCheck_ = true;
+            for (int i = 0; i < moves.size; ++i) {
+                if (board_.DoMove(moves.moves[i], undo)) {
+                    board_.UndoMove(undo);
+                    bestMove_ = ChessMove(moves.moves[i]);
+                    break;
                 }
-            } else {
-                data.whiteCheck_ = data.blackCheck_ = false;
-                // For each move we'll try to get the maximum result.
-                int actval, maxval = INITIAL_ALPHA;
-                auto it = moves.begin(), end = moves.end();
-                for (; it != end; ++it) {
-                    ChessGameData future(data);
-                    if (it->MakeMove(future)) {
-                        actval = minimizer(future, depth + 1, alpha, beta);
-                        if (maxval < actval || result.origin.x == -1) {
-                            maxval = actval;
-                            alpha = actval;
-                            result = ChessMove(*it);
-                        }
-                    }
+            }
+
+        } else if (legalMoves.size == 1) {
+            // With only one move there is nothing to think about.
+            bestMove_ = ChessMove(legalMoves.moves[0]);
+
+        } else if (thinkWithBook(legalMoves) || thinkWithTablebase(legalMoves)) {
+            // The opening book or the tablebases know the best move of the position.
+
+        } else {
+            // Try first the best move of a previous search of the same position.
+            ChessTranspositionTable::Entry entry;
+            int hashMove = ChessTranspositionTable::NO_MOVE;
+            if (table_->Probe(board_.Hash(), entry)) {
+                hashMove = entry.move;
+            }
+            sortMoves(board_, legalMoves, hashMove, 0);
+            launchHelpers();
+
+            // Search deeper and deeper until the budget is over. The best move of each
+            // iteration is searched first in the next one, so when an iteration is
+            // stopped, the best move found so far is at least as good as the old one.
+            // The odd helpers start one ply deeper, to not follow the same steps than
+            // the other threads and to fill the table in advance.
+            for (int depth = helperIndex_ % 2; depth < depthBudget_ && !stop_; ++depth) {
+                maxDepth_ = depth;
+                int score, index = minimax(board_, legalMoves, score);
+                if (index != -1) {
+                    auto move = legalMoves.moves[index];
+                    sortFirst(legalMoves, move);
+                    bestMove_ = ChessMove(move);
+                    score_ = score;
+                }
+                if (!stop_) depth_ = depth + 1;
+                // The next iteration will need more time than all the previous ones.
+                if (clock_.getElapsedTime().asMilliseconds() * 2 >= timeBudget_ ||
+                    stats_.nodes * 2 >= nodeBudget_) {
+                    break;
                 }
             }
+            stopHelpers();
+        }
+    }
+    ready_ = true;
+}
+
+//--------------------------------------------------------------------------------
+
+bool ChessMiniMax::thinkWithBook(ChessGameData::MoveList & moves) {
+    // The moves of the book are played only when they are legal in this game.
+    int move = book_->Probe(board_);
+    for (int i = 0; i < moves.size && move != ChessOpeningBook::NO_MOVE; ++i) {
+        if (moves.moves[i] == move) {
+            bestMove_ = ChessMove(move);
+            return true;
+        }
+    }
+    return false;
+}
+
+//--------------------------------------------------------------------------------
+
+bool ChessMiniMax::thinkWithTablebase(ChessGameData::MoveList & moves) {
+    // With a known draw the search will try to get something better.
+    int distance;
+    if (!tablebase_->Probe(board_, distance) || distance == 0) return false;
+
+    // Select the fastest victory or the slowest defeat, the positions out of the
+    // tables are the ones where the lone king kills a piece, so they are a draw.
+    ChessGameData::MoveUndo undo;
+    int result = -1, maxval = INITIAL_ALPHA;
+    for (int i = 0; i < moves.size; ++i) {
+        int actval = 0;
+        board_.DoMove(moves.moves[i], undo);
+        if (tablebase_->Probe(board_, distance) && distance != 0) {
+            actval = distance < 0 ? AI_VICTORY + distance : AI_DEFEAT + distance;
+        }
+        board_.UndoMove(undo);
+        if (maxval < actval) {
+            maxval = actval;
+            result = i;
         }
     }
-    ChessGameData::ShowErrorMessages(true);
+    bestMove_ = ChessMove(moves.moves[result]);
+    return true;
+}
+
+//--------------------------------------------------------------------------------
+
+void ChessMiniMax::launchHelpers() {
+    // Each helper thinks with its own copy of the board and its own move ordering,
+    // inside a job of the think service. Only the workers of the pool that the main
+    // search doesn't use can run them, so the searches don't use more threads than
+    // the pool has and the main search never waits for a helper inside the queue.
+    auto * service = ThinkService::Instance();
+    if (service->Workers() == 0) service->Initialize();
+    int count = thinkTask_ ? service->Workers() - 1 : service->Workers();
+    ForEach(helpers_, [&] (ChessMiniMax * helper) {
+        if (count-- <= 0) return;
+        helper->board_ = board_;
+        helper->state_ = state_;
+        helper->depthBudget_ = depthBudget_;
+        helper->reset();
+        helper->task_ = service->Submit([helper] (const ThinkTask & task) {
+            helper->thinkTask_ = &task;
+            helper->think();
+            helper->thinkTask_ = nullptr;
+        });
+    });
+}
+
+//--------------------------------------------------------------------------------
+
+void ChessMiniMax::stopHelpers() {
+    // The main thread decides the move, so when it ends the helpers are useless.
+    // All of them are stopped before waiting, because the helpers still inside the
+    // queue of the pool need the threads of the other ones.
+    ForEach(helpers_, [] (ChessMiniMax * helper) {
+        helper->stop_ = true;
+        if (helper->task_) helper->task_->Cancel();
+    });
+    ForEach(helpers_, [this] (ChessMiniMax * helper) {
+        if (!helper->task_) return;
+        helper->task_->Wait();
+        helper->task_ = nullptr;
+        stats_.nodes += helper->stats_.nodes;
+        stats_.tableHits += helper->stats_.tableHits;
+        stats_.cutoffs += helper->stats_.cutoffs;
+        stats_.firstCutoffs += helper->stats_.firstCutoffs;
+    });
+}
+
+//--------------------------------------------------------------------------------
+
+void ChessMiniMax::deleteHelpers() {
+    ForEach(helpers_, [] (ChessMiniMax * helper) {
+        SafeDelete(helper);
+    });
+    helpers_.clear();
+}
+
+//--------------------------------------------------------------------------------
+
+void ChessMiniMax::sortFirst(ChessGameData::MoveList & moves, int move) {
+    // Move a value to the head of the list, keeping the order of the other ones.
+    for (int i = 0; i < moves.size; ++i) {
+        if (moves.moves[i] == move) {
+            std::copy_backward(moves.moves, moves.moves + i, moves.moves + i + 1);
+            moves.moves[0] = move;
+            break;
+        }
+    }
+}
+
+//--------------------------------------------------------------------------------
+
+void ChessMiniMax::sortMoves(ChessGameData & data, ChessGameData::MoveList & moves,
+    int hashMove, int depth) {
+    // Give a score to each move: the best move of the table, then the captures of
+    // the most valuable victims with the least valuable attackers, then the killer
+    // moves that pruned other branches at the same depth and then the history.
+    int scores[ChessGameData::MAX_MOVES];
+    auto & history = history_[data.Turn()];
+    for (int i = 0; i < moves.size; ++i) {
+        auto move = moves.moves[i];
+        auto & attacker = data.pieces_[data.board_[ChessGameData::GetMoveOrigin(move)]];
+        auto victimIndex = data.board_[ChessGameData::GetMoveDestination(move)];
+        int victimType = victimIndex != ChessGameData::PIECE_NOT_FOUND ?
+            data.pieces_[victimIndex].type : ChessGameData::DEAD_PIECE;
+        if (attacker.type == ChessGameData::PAWN_PIECE) {
+            auto dest = ChessBitboard::GetCoords(ChessGameData::GetMoveDestination(move));
+            if (dest.x != attacker.position.x && victimType == ChessGameData::DEAD_PIECE) {
+                victimType = ChessGameData::PAWN_PIECE;
+            } else if (dest.y == 0 || dest.y == ChessGameData::BOARD_SIZE - 1) {
+                victimType = ChessGameData::QUEEN_PIECE;
+            }
+        }
+
+        if (move == hashMove) {
+            scores[i] = HASH_MOVE_SCORE;
+        } else if (victimType != ChessGameData::DEAD_PIECE) {
+            scores[i] = CAPTURE_SCORE + PIECES1_VALUES[victimType] * VICTIM_FACTOR -
+                PIECES1_VALUES[attacker.type];
+        } else if (move == killers_[depth][0]) {
+            scores[i] = KILLER_SCORE + 1;
+        } else if (move == killers_[depth][1]) {
+            scores[i] = KILLER_SCORE;
+        } else {
+            scores[i] = history[move];
+        }
+    }
+
+    // Sort the moves with the scores, the lists are small enough to do it by insertion.
+    for (int i = 1; i < moves.size; ++i) {
+        int move = moves.moves[i], score = scores[i], j = i - 1;
+        for (; j >= 0 && scores[j] < score; --j) {
+            moves.moves[j + 1] = moves.moves[j];
+            scores[j + 1] = scores[j];
+        }
+        moves.moves[j + 1] = move;
+        scores[j + 1] = score;
+    }
+}
+
+//--------------------------------------------------------------------------------
+
+void ChessMiniMax::updateKillers(ChessGameData & data, int move, int depth) {
+    // Only the quiet moves are saved, because the captures are sorted before.
+    if (data.board_[ChessGameData::GetMoveDestination(move)] == ChessGameData::PIECE_NOT_FOUND) {
+        if (killers_[depth][0] != move) {
+            killers_[depth][1] = killers_[depth][0];
+            killers_[depth][0] = move;
+        }
+        int remaining = maxDepth_ - depth + 1;
+        auto & history = history_[data.Turn()];
+        history[move] += remaining * remaining;
+        if (history[move] > MAX_HISTORY) {
+            // Keep the values of the history under the killer moves.
+            for (int i = 0; i < ChessGameData::MAX_MOVE_CODES; ++i) {
+                history[i] /= 2;
+            }
+        }
+    }
+}
+
+//--------------------------------------------------------------------------------
+
+int ChessMiniMax::getScoreToTable(int score, int depth) {
+    // The victories and defeats are saved relative to the position, not to the root.
+    if (score >= MATE_BOUND) return score + depth;
+    if (score <= -MATE_BOUND) return score - depth;
+    return score;
+}
+
+//--------------------------------------------------------------------------------
+
+int ChessMiniMax::getScoreFromTable(int score, int depth) {
+    if (score >= MATE_BOUND) return score - depth;
+    if (score <= -MATE_BOUND) return score + depth;
+    return score;
+}
+
+//--------------------------------------------------------------------------------
+
+bool ChessMiniMax::probeTable(ChessGameData & data, int depth, int alpha, int beta,
+    int & move, int & score) {
+    // Find the position in the table and check if the old search was deep enough.
+    ChessTranspositionTable::Entry entry;
+    move = ChessTranspositionTable::NO_MOVE;
+    if (table_->Probe(data.Hash(), entry)) {
+        move = entry.move;
+        if (entry.depth > maxDepth_ - depth) {
+            score = getScoreFromTable(entry.score, depth);
+            if (entry.bound == ChessTranspositionTable::BOUND_EXACT ||
+                (entry.bound == ChessTranspositionTable::BOUND_LOWER && score >= beta) ||
+                (entry.bound == ChessTranspositionTable::BOUND_UPPER && score <= alpha)) {
+                ++stats_.tableHits;
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+//--------------------------------------------------------------------------------
+
+void ChessMiniMax::storeTable(ChessGameData & data, int depth, int alpha, int beta,
+    int move, int score) {
+    // A stopped search doesn't give a valid result.
+    if (!stop_) {
+        int bound = score <= alpha ? ChessTranspositionTable::BOUND_UPPER :
+                    score >= beta  ? ChessTranspositionTable::BOUND_LOWER :
+                                     ChessTranspositionTable::BOUND_EXACT;
+        table_->Store(data.Hash(), move, getScoreToTable(score, depth),
+            maxDepth_ - depth + 1, bound);
+    }
+}
+
+//--------------------------------------------------------------------------------
+
+bool ChessMiniMax::probeTablebase(ChessGameData & data, int depth, int & score) {
+    // The distance of the tables is from the side with the turn to the mate.
+    int distance;
+    if (ChessBitboard::Count(data.getOccupancy()) <= ChessTablebase::MAX_PIECES &&
+        tablebase_->Probe(data, distance) && distance != 0) {
+        if (data.Turn() == data.PlayerSide()) distance = -distance;
+        score = distance > 0 ? AI_VICTORY - depth - distance : AI_DEFEAT + depth - distance;
+        return true;
+    }
+    return false;
+}
+
+//--------------------------------------------------------------------------------
+
+void ChessMiniMax::checkBudget() {
+    if (clock_.getElapsedTime().asMilliseconds() >= timeBudget_ || stats_.nodes >= nodeBudget_ ||
+        (thinkTask_ && thinkTask_->Cancelled())) {
+        stop_ = true;
+    }
+}
+
+//--------------------------------------------------------------------------------
+
+int ChessMiniMax::minimax(ChessGameData & data, ChessGameData::MoveList & moves, int & score) {
+    // For each move we'll try to get the maximum result.
+    ChessGameData::MoveUndo undo;
+    int result = -1, actval, maxval = INITIAL_ALPHA;
+    int alpha = INITIAL_ALPHA, beta = INITIAL_BETA;
+    for (int i = 0; i < moves.size; ++i) {
+        data.DoMove(moves.moves[i], undo);
+        actval = minimizer(data, 1, alpha, beta);
+        data.UndoMove(undo);
+        // A stopped search doesn't give a valid result.
+        if (stop_) break;
+        if (maxval < actval || result == -1) {
+            maxval = actval;
+            alpha = actval;
+            result = i;
+        }
+    }
+    score = maxval;
     return result;
 }
 
@@ -218,34 +659,55 @@ ChessMove ChessMiniMax::minimax(ChessGameData & data, int depth, int alpha, int
 
 int ChessMiniMax::minimizer(ChessGameData & data, int depth, int alpha, int beta) {
     // If we reach the maximum depth o the game is over, we'll evaluate the current
-    // state of the game. If the current side does not have any moves the game ends,
-    // so is not necesary to check if we have or not moves when there is no game over.
+    // state of the game. When the current side does not have any legal move, there
+    // is a stalemate that we'll evaluate as a draw, because a side in check can move.
     if (checkStop(data, depth)) {
         return evaluate(data, depth);
     } else {
+        // Check if the position is inside the tablebases or if it was searched before
+        // with enough depth.
+        int bestMove, actval;
+        if (probeTablebase(data, depth, actval) ||
+            probeTable(data, depth, alpha, beta, bestMove, actval)) {
+            return actval;
+        }
+
         // If the game is not over, get all the moves inside the board.
-        ChessMoveVector moves;
-        getPossibleAllMoves(data, moves);
+        ChessGameData::MoveList moves;
+        data.GetPseudoLegalMoves(moves);
+        sortMoves(data, moves, bestMove, depth);
 
         // We'll initialize some variables.
-        int actval, minval = INITIAL_BETA;
-        auto it = moves.begin(), end = moves.end();
+        ChessGameData::MoveUndo undo;
+        bool anyMove = false;
+        int oldAlpha = alpha, oldBeta = beta, minval = INITIAL_BETA;
         // And then for each move we'll try to get the minimum result.
-        for (; it != end; ++it) {
-            ChessGameData future(data);
-            if (it->MakeMove(future)) {
-                actval = maximizer(future, depth + 1, alpha, beta);
+        for (int i = 0; i < moves.size; ++i) {
+            if (data.DoMove(moves.moves[i], undo)) {
+                actval = maximizer(data, depth + 1, alpha, beta);
+                data.UndoMove(undo);
+                anyMove = true;
 
                 if(minval > actval) {
                     minval = actval;
+                    bestMove = moves.moves[i];
+                }
+
+                if(beta > actval) {
                     beta = actval;
                 }
 
-                if(alpha > beta) {
-                    return minval;
+                if(alpha >= beta) {
+                    // Save the move that pruned the other branches.
+                    ++stats_.cutoffs;
+                    if (i == 0) ++stats_.firstCutoffs;
+                    updateKillers(data, moves.moves[i], depth);
+                    break;
                 }
             }
         }
+        if (!anyMove) minval = AI_DRAW;
+        storeTable(data, depth, oldAlpha, oldBeta, bestMove, minval);
         return minval;
     }
 }
@@ -254,34 +716,55 @@ int ChessMiniMax::minimizer(ChessGameData & data, int depth, int alpha, int beta
 
 int ChessMiniMax::maximizer(ChessGameData & data, int depth, int alpha, int beta) {
     // If we reach the maximum depth o the game is over, we'll evaluate the current
-    // state of the game. If the current side does not have any moves the game ends,
-    // so is not necesary to check if we have or not moves when there is no game over.
+    // state of the game. When the current side does not have any legal move, there
+    // is a stalemate that we'll evaluate as a draw, because a side in check can move.
     if (checkStop(data, depth)) {
         return evaluate(data, depth);
     } else {
+        // Check if the position is inside the tablebases or if it was searched before
+        // with enough depth.
+        int bestMove, actval;
+        if (probeTablebase(data, depth, actval) ||
+            probeTable(data, depth, alpha, beta, bestMove, actval)) {
+            return actval;
+        }
+
         // If the game is not over, get all the moves inside the board.
-        ChessMoveVector moves;
-        getPossibleAllMoves(data, moves);
+        ChessGameData::MoveList moves;
+        data.GetPseudoLegalMoves(moves);
+        sortMoves(data, moves, bestMove, depth);
 
         // We'll initialize some variables.
-        int actval, maxval = INITIAL_ALPHA;
-        auto it = moves.begin(), end = moves.end();
+        ChessGameData::MoveUndo undo;
+        bool anyMove = false;
+        int oldAlpha = alpha, oldBeta = beta, maxval = INITIAL_ALPHA;
         // And then for each move we'll try to get the maximum result.
-        for (; it != end; ++it) {
-            ChessGameData future(data);
-            if (it->MakeMove(future)) {
-                actval = minimizer(future, depth + 1, alpha, beta);
+        for (int i = 0; i < moves.size; ++i) {
+            if (data.DoMove(moves.moves[i], undo)) {
+                actval = minimizer(data, depth + 1, alpha, beta);
+                data.UndoMove(undo);
+                anyMove = true;
 
                 if(maxval < actval) {
                     maxval = actval;
+                    bestMove = moves.moves[i];
+                }
+
+                if(alpha < actval) {
                     alpha = actval;
                 }
 
-                if(alpha > beta) {
-                    return maxval;
+                if(alpha >= beta) {
+                    // Save the move that pruned the other branches.
+                    ++stats_.cutoffs;
+                    if (i == 0) ++stats_.firstCutoffs;
+                    updateKillers(data, moves.moves[i], depth);
+                    break;
                 }
             }
         }
+        if (!anyMove) maxval = AI_DRAW;
+        storeTable(data, depth, oldAlpha, oldBeta, bestMove, maxval);
         return maxval;
     }
 }
@@ -289,30 +772,28 @@ int ChessMiniMax::maximizer(ChessGameData & data, int depth, int alpha, int beta
 //--------------------------------------------------------------------------------
 
 bool ChessMiniMax::checkStop(ChessGameData & data, int depth) {
-    return maxDepth_ < depth || data.GameOver() ||
-           data.WhiteCheck() || data.BlackCheck();
+    // A king under attack ends the search, because the next move will kill it.
+    if ((++stats_.nodes & CHECK_BUDGET_MASK) == 0) checkBudget();
+    return stop_ || maxDepth_ < depth || data.GameOver() ||
+        data.isKingAttacked(OPPOSITE_SIDE[data.Turn()]);
 }
 
 //--------------------------------------------------------------------------------
 
 int ChessMiniMax::evaluate(ChessGameData & data, int depth) {
-    if (data.PlayerSide() == ChessGameData::WHITE_SIDE) {
-        if (data.BlackCheck()) {
-            return AI_DEFEAT + depth;
-        } else if (data.WhiteCheck()) {
-            return AI_VICTORY + depth;
-        } else {
-            return evaluate(data);
-        }
-    } else {
-        if (data.WhiteCheck()) {
-            return AI_DEFEAT + depth;
-        } else if (data.BlackCheck()) {
-            return AI_VICTORY + depth;
-        } else {
-            return evaluate(data);
-        }
+    // The victories and the defeats are better the sooner and the later they come.
+    if (data.GameOver()) {
+        if (data.Winner() == ChessGameData::GAME_DRAW) return AI_DRAW;
+        return data.Winner() == ChessGameData::AI_WINNER ?
+            AI_VICTORY - depth : AI_DEFEAT + depth;
+    }
+    // When a king is under attack, the game will be over in the next move.
+    int enemySide = OPPOSITE_SIDE[data.Turn()];
+    if (data.isKingAttacked(enemySide)) {
+        return enemySide == data.PlayerSide() ?
+            AI_VICTORY - depth - 1 : AI_DEFEAT + depth + 1;
     }
+    return evaluate(data);
 }
 
 //--------------------------------------------------------------------------------
@@ -320,6 +801,7 @@ int ChessMiniMax::evaluate(ChessGameData & data, int depth) {
 int ChessMiniMax::evaluate(ChessGameData & data) {
     if (data.GameOver()) {
         // When there is a winner, there is no other option in life.
+        if (data.Winner() == ChessGameData::GAME_DRAW) return AI_DRAW;
         return data.Winner() == ChessGameData::AI_WINNER ? AI_VICTORY : AI_DEFEAT;
 
     } else {
@@ -328,6 +810,13 @@ int ChessMiniMax::evaluate(ChessGameData & data) {
         int threatPoints[ChessGameData::MAX_SIDES] = { 0, 0 };
         int positionPoints[ChessGameData::MAX_SIDES] = { 0, 0 };
 
+        // Get the attack maps of both sides, only the side of the current turn can
+        // make a threat, because the other side must wait to make a move.
+        ChessGameData::Bitboard attacks[ChessGameData::MAX_SIDES] = {
+            data.getAttacks(ChessGameData::WHITE_SIDE),
+            data.getAttacks(ChessGameData::BLACK_SIDE)
+        };
+
         // Check each alive piece in the game to evaluate the alive, position and threat factors.
         for (int i = 0; i < ChessGameData::MAX_PIECES; ++i) {
             auto & victim = data.pieces_[i];
@@ -335,7 +824,8 @@ int ChessMiniMax::evaluate(ChessGameData & data) {
                 int pieceValue = PIECES2_VALUES[victim.type];
                 alivePoints[victim.side] += pieceValue;
                 positionPoints[victim.side] += pieceValue * evaluatePosition(data, victim);
-                if (victim.type != ChessGameData::KING_PIECE && isInDanger(data, victim)) {
+                if (victim.type != ChessGameData::KING_PIECE && victim.side != data.Turn() &&
+                    isInDanger(data, victim, attacks)) {
                     threatPoints[OPPOSITE_SIDE[victim.side]] += pieceValue;
                 }
             }
@@ -423,105 +913,105 @@ int ChessMiniMax::evaluatePositionQueenOrRook(ChessGameData & data, ChessGameDat
 
 //--------------------------------------------------------------------------------
 
-bool ChessMiniMax::isInDanger(ChessGameData & data, ChessGameData::Piece & victim) {
-    // Get all the threats to the current pieces.
-    std::vector<int> enemies;
-    findThreats(data, victim, enemies);
-    if (enemies.empty()) return false;
-
-    // Get all the allies to the current pieces.
-    std::vector<int> allies;
-    findDefenses(data, victim, allies);
-    if (allies.empty()) return true;
-
-    // Calculate the value of the enemies and sort it.
-    for (unsigned int k = 0; k < enemies.size(); ++k) {
-        enemies[k] = PIECES1_VALUES[data.pieces_[enemies[k]].type];
-    }
-    std::sort(enemies.begin(), enemies.end());
-
-    // Calculate the value of the allies and sort it. But before the
-    // sort operatio we'll add a negative value to be able to set the
-    // current piece as the head of the list of values in the attack.
-    for (unsigned int k = 0; k < allies.size(); ++k) {
-        allies[k] = PIECES1_VALUES[data.pieces_[allies[k]].type];
-    }
-    allies.push_back(-1);
-    std::sort(allies.begin(), allies.end());
-    allies[0] = PIECES1_VALUES[victim.type];
-
-    bool oneMoreTime;
-    int lost = 0, gain = 0;
-    unsigned int i = 0, j = 0;
-    do {
-        // We start thinking that we're going to exit the loop.
-        oneMoreTime = false;
-        // The enemy moves first and test the value of the lowest
-        // piece with the current in danger in this moment.
-        if (enemies[i] <= allies[j]) {
-            lost += allies[j]; ++j;
-            // Check that we still have allies to attack the enemy.
-            if (j < allies.size()) {
-                // We'll move if our lowest piece in value is worse
-                // than the current piece of the enemy.
-                if (enemies[i] >= allies[j]) {
-                    gain += enemies[i]; ++i;
-                    // Check that the enemy has pieces to attack.
-                    if (i < enemies.size()) {
-                        oneMoreTime = true;
-                    }
-                }
-            }
-        }
-    } while (oneMoreTime);
-
-    // The victim will be in danger if the lost is bigger than the gain.
-    return lost > gain;
+bool ChessMiniMax::isInDanger(ChessGameData & data, ChessGameData::Piece & victim,
+    const ChessGameData::Bitboard * attacks) {
+    // A piece without enemies around is safe and without allies is in danger.
+    auto square = ChessBitboard::GetSquare(victim.position);
+    if (!ChessBitboard::IsSet(attacks[OPPOSITE_SIDE[victim.side]], square)) return false;
+    if (!ChessBitboard::IsSet(attacks[victim.side], square)) return true;
+    // Otherwise the piece will be in danger if the enemy wins the exchange.
+    return staticExchange(data, square, OPPOSITE_SIDE[victim.side]) > 0;
 }
 
 //--------------------------------------------------------------------------------
 
-void ChessMiniMax::findDefenses(ChessGameData & data, ChessGameData::Piece & victim,
-    std::vector<int> & allies) {
-    // Our victim is going to the enemy side, madness!!!
-    auto backUp = victim;
-    victim.side = OPPOSITE_SIDE[victim.side];
-    // Test if any ally piece can get into your position and destroy you.
-    for (int i = 0; i < ChessGameData::MAX_PIECES; ++i) {
-        auto & ally = data.pieces_[i];
-        if (ally.side == backUp.side && ally.NotDead()) {
-            ChessGameData future(data);
-            if (future.MakeMove(ally.position, victim.position)) {
-                allies.push_back(i);
-            }
-        }
+int ChessMiniMax::staticExchange(ChessGameData & data, int square, int side) {
+    // Get all the pieces that can capture in the square, from both sides.
+    auto occupancy = data.getOccupancy();
+    auto attackers = data.getAttackers(square, occupancy);
+    auto & whites = data.typeBoards_[ChessGameData::WHITE_SIDE];
+    auto & blacks = data.typeBoards_[ChessGameData::BLACK_SIDE];
+    auto diagonals = whites[ChessGameData::BISHOP_PIECE] | blacks[ChessGameData::BISHOP_PIECE] |
+        whites[ChessGameData::QUEEN_PIECE] | blacks[ChessGameData::QUEEN_PIECE];
+    auto orthogonals = whites[ChessGameData::ROOK_PIECE] | blacks[ChessGameData::ROOK_PIECE] |
+        whites[ChessGameData::QUEEN_PIECE] | blacks[ChessGameData::QUEEN_PIECE];
+
+    // Each side captures with its least valuable piece, and the pieces behind the
+    // capturer that move in the same line join the exchange.
+    int gains[ChessGameData::MAX_PIECES + 1], count = 0, type;
+    gains[0] = PIECES1_VALUES[data.pieces_[data.board_[square]].type];
+    auto from = getLeastValuable(data, attackers & data.sideBoards_[side], type);
+    while (from != ChessBitboard::EMPTY) {
+        ++count;
+        gains[count] = PIECES1_VALUES[type] - gains[count - 1];
+        if (-gains[count - 1] < 0 && gains[count] < 0) break;
+        occupancy ^= from;
+        attackers ^= from;
+        attackers |= (ChessBitboard::RookAttacks(square, occupancy) & orthogonals) |
+                     (ChessBitboard::BishopAttacks(square, occupancy) & diagonals);
+        attackers &= occupancy;
+        side = OPPOSITE_SIDE[side];
+        from = getLeastValuable(data, attackers & data.sideBoards_[side], type);
+    }
+
+    // Each side can stop the exchange when the next capture loses material.
+    while (count > 1) {
+        --count;
+        gains[count - 1] = -(-gains[count - 1] > gains[count] ? -gains[count - 1] : gains[count]);
     }
-    victim = backUp;
+    return count > 0 ? gains[0] : 0;
 }
 
 //--------------------------------------------------------------------------------
 
-void ChessMiniMax::findThreats(ChessGameData & data, ChessGameData::Piece & victim,
-    std::vector<int> & enemies) {
-    // Test if any enemy can get into your position and finish your life.
-    int enemySide = OPPOSITE_SIDE[victim.side];
-    for (int i = 0; i < ChessGameData::MAX_PIECES; ++i) {
-        auto & enemy = data.pieces_[i];
-        if (enemy.side == enemySide && enemy.NotDead()) {
-            ChessGameData future(data);
-            if (future.MakeMove(enemy.position, victim.position)) {
-                enemies.push_back(i);
+ChessGameData::Bitboard ChessMiniMax::getLeastValuable(ChessGameData & data,
+    ChessGameData::Bitboard attackers, int & type) {
+    // The types are sorted by value: pawn, knight, bishop, rook, queen and king.
+    static const int TYPES_BY_VALUE[ChessGameData::PIECE_TYPES] = {
+        ChessGameData::PAWN_PIECE, ChessGameData::KNIGHT_PIECE, ChessGameData::BISHOP_PIECE,
+        ChessGameData::ROOK_PIECE, ChessGameData::QUEEN_PIECE, ChessGameData::KING_PIECE
+    };
+    if (attackers != ChessBitboard::EMPTY) {
+        for (int i = 0; i < ChessGameData::PIECE_TYPES; ++i) {
+            type = TYPES_BY_VALUE[i];
+            auto victims = attackers & (data.typeBoards_[ChessGameData::WHITE_SIDE][type] |
+                data.typeBoards_[ChessGameData::BLACK_SIDE][type]);
+            if (victims != ChessBitboard::EMPTY) {
+                return victims & (~victims + 1);
             }
         }
     }
+    return ChessBitboard::EMPTY;
 }
 
 //********************************************************************************
 // Constructors, destructor and operators
 //********************************************************************************
 
-ChessMiniMax::ChessMiniMax() {}
+ChessMiniMax::ChessMiniMax() : maxDepth_(0), depth_(0), score_(AI_DRAW),
+    state_(NORMAL_STATE), timeBudget_(EASY_TIME_BUDGET), nodeBudget_(EASY_NODE_BUDGET),
+    depthBudget_(MAX_DEPTH), checkmate_(false), stop_(false), ready_(false),
+    thinkTask_(nullptr), table_(new ChessTranspositionTable()),
+    tablebase_(new ChessTablebase()),
+    book_(new ChessOpeningBook()), helperIndex_(0) {
+    std::memset(&stats_, 0, sizeof(stats_));
+    std::memset(history_, 0, sizeof(history_));
+}
 
 //--------------------------------------------------------------------------------
 
-ChessMiniMax::~ChessMiniMax() {}
+ChessMiniMax::ChessMiniMax(const ChessMiniMax & owner, int index) : maxDepth_(0), depth_(0),
+    score_(AI_DRAW), state_(owner.state_), timeBudget_(HELPER_TIME_BUDGET),
+    nodeBudget_(HELPER_NODE_BUDGET), depthBudget_(owner.depthBudget_), checkmate_(false),
+    stop_(false), ready_(false), thinkTask_(nullptr), table_(owner.table_),
+    tablebase_(owner.tablebase_), book_(owner.book_), helperIndex_(index) {
+    std::memset(&stats_, 0, sizeof(stats_));
+    std::memset(history_, 0, sizeof(history_));
+}
+
+//--------------------------------------------------------------------------------
+
+ChessMiniMax::~ChessMiniMax() {
+    Cancel();
+    deleteHelpers();
+}
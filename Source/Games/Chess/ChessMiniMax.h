@@ -24,8 +24,14 @@
 #define __CHESS_MINIMAX_HEADER__
 
 #include <vector>
+#include <memory>
 #include <SFML/Graphics/Rect.hpp>
+#include <SFML/System/Clock.hpp>
+#include <System/ThinkService.h>
 #include <Games/Chess/ChessGameData.h>
+#include <Games/Chess/ChessTranspositionTable.h>
+#include <Games/Chess/ChessTablebase.h>
+#include <Games/Chess/ChessOpeningBook.h>
 
 /**
  * This structure represents a move in the game.
@@ -35,6 +41,7 @@ struct ChessMove {
     sf::Vector2i destination;
     ChessMove();
     ChessMove(const sf::Vector2i & orig, const sf::Vector2i & dest);
+    ChessMove(int move);
     bool MakeMove(ChessGameData & victim);
 };
 
@@ -44,10 +51,45 @@ struct ChessMove {
 typedef std::vector<ChessMove> ChessMoveVector;
 
 /**
- * This class represents the mini-max algorithm.
+ * This class represents the mini-max algorithm. The search uses iterative deepening
+ * inside a time and node budget, and it can be executed in the think service.
+ * With more than one thread, the helpers search the same root with their own
+ * boards inside other jobs of the think service, and they share the results
+ * through the transposition table (lazy SMP).
+ * The opening book and the tablebases of the endings give the moves they know.
  */
 class ChessMiniMax {
 public:
+    //--------------------------------------------------------------------------------
+    // Constants
+    //--------------------------------------------------------------------------------
+
+    static const int MAX_DEPTH = 64;
+    static const int MAX_THREADS = 64;
+    static const int DRAW_SCORE = 0;
+
+    //--------------------------------------------------------------------------------
+    // Types
+    //--------------------------------------------------------------------------------
+
+    struct Statistics {
+        long long nodes;        // The number of visited positions.
+        long long tableHits;    // The positions solved with the transposition table.
+        long long cutoffs;      // The positions pruned by the alpha-beta algorithm.
+        long long firstCutoffs; // The positions pruned with the first move searched.
+    };
+
+    //--------------------------------------------------------------------------------
+    // Properties
+    //--------------------------------------------------------------------------------
+
+    bool Ready() const { return ready_; }
+    long long Nodes() const { return stats_.nodes; }
+    int Depth() const { return depth_; }
+    int Score() const { return score_; }
+    const Statistics & Stats() const { return stats_; }
+    int Threads() const { return static_cast<int>(helpers_.size()) + 1; }
+
     //--------------------------------------------------------------------------------
     // Methods
     //--------------------------------------------------------------------------------
@@ -55,6 +97,16 @@ public:
     void Initialize(int difficulty);
     ChessMove Execute(ChessGameData & data);
 
+    void TableSize(int megabytes);
+    void Threads(int count);
+    void Budget(int milliseconds, long long nodes, int depth);
+    void LoadBook(const std::string & path);
+    void LoadTablebase(const std::string & directory);
+
+    void Launch(const ChessGameData & data);
+    ChessMove Finish(ChessGameData & data);
+    void Cancel();
+
     //--------------------------------------------------------------------------------
     // Constructors, destructor and operators
     //--------------------------------------------------------------------------------
@@ -63,22 +115,68 @@ public:
     virtual ~ChessMiniMax();
 
 private:
+    ChessMiniMax(const ChessMiniMax & owner, int index);
     //--------------------------------------------------------------------------------
     // Fields
     //--------------------------------------------------------------------------------
 
     int maxDepth_;
+    int depth_;
+    int score_;
     int state_;
 
+    int timeBudget_;
+    long long nodeBudget_;
+    int depthBudget_;
+    Statistics stats_;
+
+    ChessGameData board_;
+    ChessMove bestMove_;
+    bool checkmate_;
+
+    volatile bool stop_;
+    volatile bool ready_;
+    sf::Clock clock_;
+    SharedThinkTask task_;
+    const ThinkTask * thinkTask_;
+
+    std::shared_ptr<ChessTranspositionTable> table_;
+    std::shared_ptr<ChessTablebase> tablebase_;
+    std::shared_ptr<ChessOpeningBook> book_;
+    std::vector<ChessMiniMax *> helpers_;
+    int helperIndex_;
+    int killers_[MAX_DEPTH + 1][2];
+    int history_[ChessGameData::MAX_SIDES][ChessGameData::MAX_MOVE_CODES];
+
     //--------------------------------------------------------------------------------
     // Methods
     //--------------------------------------------------------------------------------
 
     void checkState(ChessGameData & data);
 
-    void getPossibleAllMoves(ChessGameData & data, ChessMoveVector & moves);
-
-    ChessMove minimax(ChessGameData & data, int depth, int alpha, int beta);
+    void prepare(const ChessGameData & data);
+    void reset();
+    void think();
+    bool thinkWithBook(ChessGameData::MoveList & moves);
+    bool thinkWithTablebase(ChessGameData::MoveList & moves);
+    void launchHelpers();
+    void stopHelpers();
+    void deleteHelpers();
+    void checkBudget();
+
+    static void sortFirst(ChessGameData::MoveList & moves, int move);
+    void sortMoves(ChessGameData & data, ChessGameData::MoveList & moves,
+        int hashMove, int depth);
+    void updateKillers(ChessGameData & data, int move, int depth);
+    static int getScoreToTable(int score, int depth);
+    static int getScoreFromTable(int score, int depth);
+    bool probeTable(ChessGameData & data, int depth, int alpha, int beta,
+        int & move, int & score);
+    void storeTable(ChessGameData & data, int depth, int alpha, int beta,
+        int move, int score);
+    bool probeTablebase(ChessGameData & data, int depth, int & score);
+
+    int minimax(ChessGameData & data, ChessGameData::MoveList & moves, int & score);
     int minimizer(ChessGameData & data, int depth, int alpha, int beta);
     int maximizer(ChessGameData & data, int depth, int alpha, int beta);
 
@@ -91,11 +189,11 @@ private:
     int evaluatePositionNormal(ChessGameData::Piece & victim);
     int evaluatePositionQueenOrRook(ChessGameData & data, ChessGameData::Piece & victim);
 
-    bool isInDanger(ChessGameData & data, ChessGameData::Piece & victim);
-    void findDefenses(ChessGameData & data, ChessGameData::Piece & victim,
-        std::vector<int> & allies);
-    void findThreats(ChessGameData & data, ChessGameData::Piece & victim,
-        std::vector<int> & enemies);
+    bool isInDanger(ChessGameData & data, ChessGameData::Piece & victim,
+        const ChessGameData::Bitboard * attacks);
+    int staticExchange(ChessGameData & data, int square, int side);
+    static ChessGameData::Bitboard getLeastValuable(ChessGameData & data,
+        ChessGameData::Bitboard attackers, int & type);
 };
 
 #endif
@@ -0,0 +1,271 @@
+/******************************************************************************
+ Copyright (c) 2014 Gorka Surez Garca
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ DEALINGS IN THE SOFTWARE.
+******************************************************************************/
+
+#include "ChessOpeningBook.h"
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <Games/Chess/ChessMiniMax.h>
+
+//********************************************************************************
+// Constants
+//********************************************************************************
+
+const size_t KEY_SIZE    = 8;
+const size_t MOVE_SIZE   = 2;
+const size_t WEIGHT_SIZE = 2;
+const size_t ENTRY_SIZE  = KEY_SIZE + MOVE_SIZE + WEIGHT_SIZE;
+
+const size_t MAGIC_SIZE  = 4;
+const size_t HEADER_SIZE = MAGIC_SIZE + KEY_SIZE;
+const char HEADER_MAGIC[] = "CBK1";
+
+const int MAX_WEIGHT = 0xFFFF;
+
+/**
+ * The openings of the book, with the moves written as the origin and destination
+ * cells. The castling is written as the move of the king.
+ */
+const char * OPENINGS[] = {
+    // Ruy Lopez
+    "e2e4 e7e5 g1f3 b8c6 f1b5 a7a6 b5a4 g8f6 e1g1 f8e7 f1e1 b7b5 a4b3 d7d6 c2c3 e8g8",
+    // Italian game
+    "e2e4 e7e5 g1f3 b8c6 f1c4 f8c5 c2c3 g8f6 d2d3 d7d6 e1g1 e8g8",
+    // Scotch game
+    "e2e4 e7e5 g1f3 b8c6 d2d4 e5d4 f3d4 g8f6 d4c6 b7c6 e4e5 d8e7",
+    // Petroff defense
+    "e2e4 e7e5 g1f3 g8f6 f3e5 d7d6 e5f3 f6e4 d2d4 d6d5 f1d3",
+    // Sicilian defense, Najdorf variation
+    "e2e4 c7c5 g1f3 d7d6 d2d4 c5d4 f3d4 g8f6 b1c3 a7a6 c1e3 e7e5 d4b3 c8e6",
+    // Sicilian defense, accelerated dragon
+    "e2e4 c7c5 g1f3 b8c6 d2d4 c5d4 f3d4 g7g6 b1c3 f8g7 c1e3 g8f6",
+    // Sicilian defense, closed variation
+    "e2e4 c7c5 b1c3 b8c6 g2g3 g7g6 f1g2 f8g7 d2d3 d7d6",
+    // French defense
+    "e2e4 e7e6 d2d4 d7d5 b1c3 g8f6 c1g5 f8e7 e4e5 f6d7 g5e7 d8e7",
+    // Caro-Kann defense
+    "e2e4 c7c6 d2d4 d7d5 b1c3 d5e4 c3e4 c8f5 e4g3 f5g6 h2h4 h7h6",
+    // Scandinavian defense
+    "e2e4 d7d5 e4d5 d8d5 b1c3 d5a5 d2d4 g8f6 g1f3 c8f5",
+    // Queen's gambit declined
+    "d2d4 d7d5 c2c4 e7e6 b1c3 g8f6 c1g5 f8e7 e2e3 e8g8 g1f3 h7h6",
+    // Queen's gambit accepted
+    "d2d4 d7d5 c2c4 d5c4 g1f3 g8f6 e2e3 e7e6 f1c4 c7c5 e1g1 a7a6",
+    // Slav defense
+    "d2d4 d7d5 c2c4 c7c6 g1f3 g8f6 b1c3 d5c4 a2a4 c8f5",
+    // King's indian defense
+    "d2d4 g8f6 c2c4 g7g6 b1c3 f8g7 e2e4 d7d6 g1f3 e8g8 f1e2 e7e5",
+    // Nimzo-indian defense
+    "d2d4 g8f6 c2c4 e7e6 b1c3 f8b4 e2e3 e8g8 f1d3 d7d5 g1f3 c7c5",
+    // Queen's indian defense
+    "d2d4 g8f6 c2c4 e7e6 g1f3 b7b6 g2g3 c8b7 f1g2 f8e7 e1g1 e8g8",
+    // English opening
+    "c2c4 e7e5 b1c3 g8f6 g1f3 b8c6 g2g3 d7d5 c4d5 f6d5",
+    // Reti opening
+    "g1f3 d7d5 g2g3 g8f6 f1g2 e7e6 e1g1 f8e7 d2d3 e8g8"
+};
+
+const int MAX_OPENINGS = sizeof(OPENINGS) / sizeof(OPENINGS[0]);
+
+//********************************************************************************
+// Util functions
+//********************************************************************************
+
+/**
+ * Adds a number to a buffer, with the lowest bytes first.
+ */
+static void PutValue(std::vector<unsigned char> & victim, unsigned long long value, size_t size) {
+    for (size_t i = 0; i < size; ++i) {
+        victim.push_back(static_cast<unsigned char>((value >> (i * 8)) & 0xFF));
+    }
+}
+
+/**
+ * Gets a number from a buffer, with the lowest bytes first.
+ */
+static unsigned long long GetValue(const unsigned char * data, size_t size) {
+    unsigned long long result = 0;
+    for (size_t i = 0; i < size; ++i) {
+        result |= static_cast<unsigned long long>(data[i]) << (i * 8);
+    }
+    return result;
+}
+
+//********************************************************************************
+// Methods (Public)
+//********************************************************************************
+
+void ChessOpeningBook::Load(const std::string & path) {
+    if (data_ != nullptr) return;
+
+    // Map the file of the book when it was built before with the same keys.
+    if (file_.Open(path)) {
+        auto data = reinterpret_cast<const unsigned char *>(file_.Data());
+        if (isValid(data, file_.Size())) {
+            data_ = data + HEADER_SIZE;
+            size_ = (file_.Size() - HEADER_SIZE) / ENTRY_SIZE;
+            return;
+        }
+        file_.Close();
+    }
+
+    // Otherwise build the book and save it for the next time.
+    build(memory_);
+    size_ = (memory_.size() - HEADER_SIZE) / ENTRY_SIZE;
+    std::ofstream output(path.c_str(), std::ios::out | std::ios::trunc | std::ios::binary);
+    if (output.is_open()) {
+        output.write(reinterpret_cast<const char *>(&memory_[0]), memory_.size());
+        output.close();
+    }
+    if (file_.Open(path) && file_.Size() == memory_.size()) {
+        data_ = reinterpret_cast<const unsigned char *>(file_.Data());
+        Buffer().swap(memory_);
+    } else {
+        file_.Close();
+        data_ = &memory_[0];
+    }
+    data_ += HEADER_SIZE;
+}
+
+//--------------------------------------------------------------------------------
+
+int ChessOpeningBook::Probe(const ChessGameData & data) const {
+    if (data_ == nullptr) return NO_MOVE;
+
+    // Find the first entry of the position with a binary search.
+    auto key = data.Hash();
+    size_t first = 0, last = size_;
+    while (first < last) {
+        size_t middle = first + (last - first) / 2;
+        if (getEntry(data_, middle).key < key) {
+            first = middle + 1;
+        } else {
+            last = middle;
+        }
+    }
+
+    // Select one of the moves of the position, with the weight as the probability.
+    int total = 0;
+    for (size_t i = first; i < size_ && getEntry(data_, i).key == key; ++i) {
+        total += getEntry(data_, i).weight;
+    }
+    if (total > 0) {
+        int selected = std::rand() % total;
+        for (size_t i = first; ; ++i) {
+            auto entry = getEntry(data_, i);
+            if (selected < entry.weight) return entry.move;
+            selected -= entry.weight;
+        }
+    }
+    return NO_MOVE;
+}
+
+//********************************************************************************
+// Methods (Private)
+//********************************************************************************
+
+ChessOpeningBook::HashKey ChessOpeningBook::getSignature() {
+    // The key of the initial position changes when the keys of the pieces change.
+    ChessGameData game;
+    game.Start(false, ChessGameData::HARD_LEVEL, ChessGameData::WHITE_SIDE);
+    return game.Hash();
+}
+
+//--------------------------------------------------------------------------------
+
+bool ChessOpeningBook::isValid(const unsigned char * data, size_t size) {
+    return size >= HEADER_SIZE && (size - HEADER_SIZE) % ENTRY_SIZE == 0 &&
+        std::memcmp(data, HEADER_MAGIC, MAGIC_SIZE) == 0 &&
+        GetValue(data + MAGIC_SIZE, KEY_SIZE) == getSignature();
+}
+
+//--------------------------------------------------------------------------------
+
+ChessOpeningBook::Entry ChessOpeningBook::getEntry(const unsigned char * data, size_t index) {
+    const unsigned char * victim = data + index * ENTRY_SIZE;
+    Entry result;
+    result.key = GetValue(victim, KEY_SIZE);
+    result.move = static_cast<int>(GetValue(victim + KEY_SIZE, MOVE_SIZE));
+    result.weight = static_cast<int>(GetValue(victim + KEY_SIZE + MOVE_SIZE, WEIGHT_SIZE));
+    return result;
+}
+
+//--------------------------------------------------------------------------------
+
+void ChessOpeningBook::build(Buffer & victim) {
+    // Play the moves of each opening and save the position before each move.
+    std::vector<Entry> entries;
+    for (int i = 0; i < MAX_OPENINGS; ++i) {
+        ChessGameData game;
+        game.Start(false, ChessGameData::HARD_LEVEL, ChessGameData::WHITE_SIDE);
+        std::istringstream input(OPENINGS[i]);
+        std::string name;
+        while (input >> name && name.size() == 4) {
+            sf::Vector2i origin(name[0] - 'a', name[1] - '1');
+            sf::Vector2i destination(name[2] - 'a', name[3] - '1');
+            Entry entry;
+            entry.key = game.Hash();
+            entry.move = ChessGameData::GetMove(ChessBitboard::GetSquare(origin),
+                ChessBitboard::GetSquare(destination));
+            entry.weight = 1;
+            if (!ChessMove(origin, destination).MakeMove(game)) break;
+            entries.push_back(entry);
+        }
+    }
+
+    // Sort the entries by position and join the moves repeated in many openings,
+    // so the most common moves are the most weighted.
+    std::sort(entries.begin(), entries.end(), [] (const Entry & left, const Entry & right) {
+        return left.key < right.key || (left.key == right.key && left.move < right.move);
+    });
+    std::vector<Entry> moves;
+    for (size_t i = 0; i < entries.size(); ++i) {
+        if (!moves.empty() && moves.back().key == entries[i].key &&
+            moves.back().move == entries[i].move) {
+            moves.back().weight = std::min(moves.back().weight + 1, MAX_WEIGHT);
+        } else {
+            moves.push_back(entries[i]);
+        }
+    }
+
+    // And write the header and the entries.
+    victim.clear();
+    victim.insert(victim.end(), HEADER_MAGIC, HEADER_MAGIC + MAGIC_SIZE);
+    PutValue(victim, getSignature(), KEY_SIZE);
+    for (size_t i = 0; i < moves.size(); ++i) {
+        PutValue(victim, moves[i].key, KEY_SIZE);
+        PutValue(victim, moves[i].move, MOVE_SIZE);
+        PutValue(victim, moves[i].weight, WEIGHT_SIZE);
+    }
+}
+
+//********************************************************************************
+// Constructors, destructor and operators
+//********************************************************************************
+
+ChessOpeningBook::ChessOpeningBook() : data_(nullptr), size_(0) {}
+
+//--------------------------------------------------------------------------------
+
+ChessOpeningBook::~ChessOpeningBook() {}
@@ -0,0 +1,99 @@
+/******************************************************************************
+ Copyright (c) 2014 Gorka Surez Garca
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ DEALINGS IN THE SOFTWARE.
+******************************************************************************/
+
+#ifndef __CHESS_OPENING_BOOK_HEADER__
+#define __CHESS_OPENING_BOOK_HEADER__
+
+#include <string>
+#include <vector>
+#include <System/MappedFile.h>
+#include <Games/Chess/ChessGameData.h>
+
+/**
+ * This class represents the opening book of the AI. The book is a file with the
+ * moves of some well known openings sorted by the key of the position, so it is
+ * mapped from disk and searched with a binary search. The file is built from the
+ * openings inside the code, when it doesn't exist or it doesn't match the keys.
+ */
+class ChessOpeningBook {
+public:
+    //--------------------------------------------------------------------------------
+    // Constants
+    //--------------------------------------------------------------------------------
+
+    static const int NO_MOVE = -1;
+
+    //--------------------------------------------------------------------------------
+    // Properties
+    //--------------------------------------------------------------------------------
+
+    bool IsLoaded() const { return data_ != nullptr; }
+    size_t Size() const { return size_; }
+
+    //--------------------------------------------------------------------------------
+    // Methods
+    //--------------------------------------------------------------------------------
+
+    void Load(const std::string & path);
+    int Probe(const ChessGameData & data) const;
+
+    //--------------------------------------------------------------------------------
+    // Constructors, destructor and operators
+    //--------------------------------------------------------------------------------
+
+    ChessOpeningBook();
+    ~ChessOpeningBook();
+
+private:
+    //--------------------------------------------------------------------------------
+    // Types
+    //--------------------------------------------------------------------------------
+
+    typedef ChessGameData::HashKey HashKey;
+    typedef std::vector<unsigned char> Buffer;
+
+    struct Entry {
+        HashKey key;
+        int move;
+        int weight;
+    };
+
+    //--------------------------------------------------------------------------------
+    // Fields
+    //--------------------------------------------------------------------------------
+
+    MappedFile file_;
+    Buffer memory_;
+    const unsigned char * data_;
+    size_t size_;
+
+    //--------------------------------------------------------------------------------
+    // Methods
+    //--------------------------------------------------------------------------------
+
+    static HashKey getSignature();
+    static bool isValid(const unsigned char * data, size_t size);
+    static Entry getEntry(const unsigned char * data, size_t index);
+    static void build(Buffer & victim);
+};
+
+#endif
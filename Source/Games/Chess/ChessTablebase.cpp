@@ -0,0 +1,372 @@
+/******************************************************************************
+ Copyright (c) 2014 Gorka Surez Garca
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ DEALINGS IN THE SOFTWARE.
+******************************************************************************/
+
+#include "ChessTablebase.h"
+#include <fstream>
+#include <cstring>
+
+//********************************************************************************
+// Constants
+//********************************************************************************
+
+const int STRONG_TURN = 0;
+const int WEAK_TURN   = 1;
+const int MAX_TURNS   = 2;
+
+const int STRONG_KING = 0;
+const int WEAK_KING   = 1;
+const int FIRST_PIECE = 2;
+
+const int ALL_SQUARES   = 0;
+const int DARK_SQUARES  = 1;
+const int LIGHT_SQUARES = 2;
+
+const int DOMAIN_SIZES[] = { 64, 32, 32 };
+
+const ChessGameData::Bitboard DOMAIN_MASKS[] = {
+    0xFFFFFFFFFFFFFFFFULL, 0xAA55AA55AA55AA55ULL, 0x55AA55AA55AA55AAULL
+};
+
+const unsigned char UNKNOWN_VALUE = 0;
+const unsigned char INVALID_VALUE = 255;
+const unsigned char NEVER_LOST    = 255;
+
+const size_t HEADER_SIZE = 4;
+const char HEADER_MAGIC[] = "CTB";
+
+/**
+ * The pieces of the side that is not alone in each ending. The bishops are
+ * stored by the color of their squares, because two bishops of the same color
+ * can't give a mate.
+ */
+struct Ending {
+    const char * name;
+    int pieces;
+    int types[ChessTablebase::MAX_PIECES - FIRST_PIECE];
+    int domains[ChessTablebase::MAX_PIECES - FIRST_PIECE];
+};
+
+const Ending ENDINGS[ChessTablebase::MAX_ENDINGS] = {
+    { "KQK",  1, { ChessGameData::QUEEN_PIECE,  ChessGameData::DEAD_PIECE   },
+                 { ALL_SQUARES,  ALL_SQUARES   } },
+    { "KRK",  1, { ChessGameData::ROOK_PIECE,   ChessGameData::DEAD_PIECE   },
+                 { ALL_SQUARES,  ALL_SQUARES   } },
+    { "KBBK", 2, { ChessGameData::BISHOP_PIECE, ChessGameData::BISHOP_PIECE },
+                 { DARK_SQUARES, LIGHT_SQUARES } }
+};
+
+//********************************************************************************
+// Util functions
+//********************************************************************************
+
+/**
+ * Gets the index of a square inside the squares of a domain.
+ */
+static int GetDomainIndex(int domain, int square) {
+    return domain == ALL_SQUARES ? square : square / 2;
+}
+
+/**
+ * Gets the square of an index inside the squares of a domain.
+ */
+static int GetDomainSquare(int domain, int index) {
+    if (domain == ALL_SQUARES) return index;
+    int row = index / 4, parity = domain == DARK_SQUARES ? (row & 1) : 1 - (row & 1);
+    return ChessBitboard::GetSquare(row, (index % 4) * 2 + parity);
+}
+
+/**
+ * Gets the attacks of a piece with a board occupancy.
+ */
+static ChessGameData::Bitboard GetPieceAttacks(int type, int square,
+    ChessGameData::Bitboard occupancy) {
+    switch (type) {
+    case ChessGameData::ROOK_PIECE:   return ChessBitboard::RookAttacks(square, occupancy);
+    case ChessGameData::KNIGHT_PIECE: return ChessBitboard::KnightAttacks(square);
+    case ChessGameData::BISHOP_PIECE: return ChessBitboard::BishopAttacks(square, occupancy);
+    case ChessGameData::QUEEN_PIECE:  return ChessBitboard::QueenAttacks(square, occupancy);
+    case ChessGameData::KING_PIECE:   return ChessBitboard::KingAttacks(square);
+    }
+    return ChessBitboard::EMPTY;
+}
+
+//********************************************************************************
+// Methods (Public)
+//********************************************************************************
+
+void ChessTablebase::Load(const std::string & directory) {
+    for (int i = 0; i < MAX_ENDINGS; ++i) {
+        auto & table = tables_[i];
+        if (table.data != nullptr) continue;
+
+        // Map the file of the table when it was generated before.
+        auto path = directory + "Chess" + ENDINGS[i].name + ".bin";
+        char header[HEADER_SIZE] = { HEADER_MAGIC[0], HEADER_MAGIC[1], HEADER_MAGIC[2],
+            static_cast<char>('0' + i) };
+        table.size = getSize(i);
+        if (table.file.Open(path) && table.file.Size() == HEADER_SIZE + table.size &&
+            std::memcmp(table.file.Data(), header, HEADER_SIZE) == 0) {
+            table.data = reinterpret_cast<const unsigned char *>(table.file.Data() + HEADER_SIZE);
+            continue;
+        }
+        table.file.Close();
+
+        // Otherwise generate the table and save it for the next time.
+        generate(i, table.memory);
+        std::ofstream output(path.c_str(), std::ios::out | std::ios::trunc | std::ios::binary);
+        if (output.is_open()) {
+            output.write(header, HEADER_SIZE);
+            output.write(reinterpret_cast<const char *>(&table.memory[0]), table.size);
+            output.close();
+        }
+        if (table.file.Open(path) && table.file.Size() == HEADER_SIZE + table.size) {
+            table.data = reinterpret_cast<const unsigned char *>(table.file.Data() + HEADER_SIZE);
+            Buffer().swap(table.memory);
+        } else {
+            table.file.Close();
+            table.data = &table.memory[0];
+        }
+    }
+}
+
+//--------------------------------------------------------------------------------
+
+/**
+ * Finds the current position in the tables. The distance is zero with a draw, or
+ * the plies to the mate plus one, positive when the side with the turn wins and
+ * negative when it loses.
+ */
+bool ChessTablebase::Probe(const ChessGameData & data, int & distance) const {
+    if (ChessBitboard::Count(data.getOccupancy()) > MAX_PIECES) return false;
+
+    // Find the side with the lone king.
+    int weakSide = ChessGameData::WHITE_SIDE;
+    if (data.sideBoards_[weakSide] != data.typeBoards_[weakSide][ChessGameData::KING_PIECE]) {
+        weakSide = ChessGameData::BLACK_SIDE;
+        if (data.sideBoards_[weakSide] != data.typeBoards_[weakSide][ChessGameData::KING_PIECE]) {
+            return false;
+        }
+    }
+    int strongSide = ChessGameData::MAX_SIDES - 1 - weakSide;
+    auto & types = data.typeBoards_[strongSide];
+    auto weakKing = data.typeBoards_[weakSide][ChessGameData::KING_PIECE];
+    if (types[ChessGameData::KING_PIECE] == ChessBitboard::EMPTY ||
+        weakKing == ChessBitboard::EMPTY) {
+        return false;
+    }
+
+    Position position;
+    position.turn = data.Turn() == strongSide ? STRONG_TURN : WEAK_TURN;
+    position.squares[STRONG_KING] = ChessBitboard::First(types[ChessGameData::KING_PIECE]);
+    position.squares[WEAK_KING] = ChessBitboard::First(weakKing);
+
+    // Find the ending with the same pieces of the other side.
+    auto pieces = data.sideBoards_[strongSide] & ~types[ChessGameData::KING_PIECE];
+    for (int i = 0; i < MAX_ENDINGS; ++i) {
+        auto & ending = ENDINGS[i];
+        auto victims = pieces;
+        bool found = IsLoaded(i);
+        for (int j = 0; j < ending.pieces && found; ++j) {
+            auto candidates = victims & types[ending.types[j]] & DOMAIN_MASKS[ending.domains[j]];
+            if (candidates != ChessBitboard::EMPTY) {
+                position.squares[FIRST_PIECE + j] = ChessBitboard::PopFirst(candidates);
+                victims &= ~ChessBitboard::GetMask(position.squares[FIRST_PIECE + j]);
+            } else {
+                found = false;
+            }
+        }
+        if (found && victims == ChessBitboard::EMPTY) {
+            auto value = tables_[i].data[getIndex(i, position)];
+            if (value == INVALID_VALUE) return false;
+            distance = position.turn == STRONG_TURN ? value : -value;
+            return true;
+        }
+    }
+    return false;
+}
+
+//********************************************************************************
+// Methods (Private)
+//********************************************************************************
+
+size_t ChessTablebase::getSize(int ending) {
+    size_t size = MAX_TURNS * ChessBitboard::MAX_SQUARES * ChessBitboard::MAX_SQUARES;
+    for (int i = 0; i < ENDINGS[ending].pieces; ++i) {
+        size *= DOMAIN_SIZES[ENDINGS[ending].domains[i]];
+    }
+    return size;
+}
+
+//--------------------------------------------------------------------------------
+
+size_t ChessTablebase::getIndex(int ending, const Position & position) {
+    size_t index = position.turn;
+    index = index * ChessBitboard::MAX_SQUARES + position.squares[STRONG_KING];
+    index = index * ChessBitboard::MAX_SQUARES + position.squares[WEAK_KING];
+    for (int i = 0; i < ENDINGS[ending].pieces; ++i) {
+        int domain = ENDINGS[ending].domains[i];
+        index = index * DOMAIN_SIZES[domain] +
+            GetDomainIndex(domain, position.squares[FIRST_PIECE + i]);
+    }
+    return index;
+}
+
+//--------------------------------------------------------------------------------
+
+void ChessTablebase::getPosition(int ending, size_t index, Position & position) {
+    for (int i = ENDINGS[ending].pieces - 1; i >= 0; --i) {
+        int domain = ENDINGS[ending].domains[i];
+        position.squares[FIRST_PIECE + i] = GetDomainSquare(domain,
+            static_cast<int>(index % DOMAIN_SIZES[domain]));
+        index /= DOMAIN_SIZES[domain];
+    }
+    position.squares[WEAK_KING] = static_cast<int>(index % ChessBitboard::MAX_SQUARES);
+    index /= ChessBitboard::MAX_SQUARES;
+    position.squares[STRONG_KING] = static_cast<int>(index % ChessBitboard::MAX_SQUARES);
+    position.turn = static_cast<int>(index / ChessBitboard::MAX_SQUARES);
+}
+
+//--------------------------------------------------------------------------------
+
+ChessTablebase::Bitboard ChessTablebase::getAttacks(int ending, const Position & position,
+    Bitboard occupancy) {
+    auto result = ChessBitboard::KingAttacks(position.squares[STRONG_KING]);
+    for (int i = 0; i < ENDINGS[ending].pieces; ++i) {
+        result |= GetPieceAttacks(ENDINGS[ending].types[i],
+            position.squares[FIRST_PIECE + i], occupancy);
+    }
+    return result;
+}
+
+//--------------------------------------------------------------------------------
+
+ChessTablebase::Bitboard ChessTablebase::getOccupancy(int ending, const Position & position) {
+    auto result = ChessBitboard::EMPTY;
+    for (int i = 0; i < FIRST_PIECE + ENDINGS[ending].pieces; ++i) {
+        result |= ChessBitboard::GetMask(position.squares[i]);
+    }
+    return result;
+}
+
+//--------------------------------------------------------------------------------
+
+void ChessTablebase::generate(int ending, Buffer & victim) {
+    auto & info = ENDINGS[ending];
+    size_t size = getSize(ending), half = size / MAX_TURNS;
+    int pieces = FIRST_PIECE + info.pieces;
+    victim.assign(size, UNKNOWN_VALUE);
+    Buffer counters(half, 0);
+    std::vector<size_t> losses, wins;
+    Position position;
+
+    // Find the invalid positions, the mates and the number of moves of the lone king.
+    for (size_t i = 0; i < size; ++i) {
+        getPosition(ending, i, position);
+        auto occupancy = getOccupancy(ending, position);
+        auto weakKing = position.squares[WEAK_KING];
+        auto weakMoves = ChessBitboard::KingAttacks(weakKing);
+        auto attacks = getAttacks(ending, position, occupancy & ~ChessBitboard::GetMask(weakKing));
+        if (ChessBitboard::Count(occupancy) != pieces) {
+            victim[i] = INVALID_VALUE;
+        } else if (position.turn == STRONG_TURN) {
+            // The lone king can't be in check when the other side has the turn.
+            if (ChessBitboard::IsSet(attacks, weakKing)) victim[i] = INVALID_VALUE;
+        } else if (ChessBitboard::IsSet(weakMoves, position.squares[STRONG_KING])) {
+            victim[i] = INVALID_VALUE;
+        } else {
+            auto moves = weakMoves & ~attacks;
+            if ((moves & occupancy) != ChessBitboard::EMPTY) {
+                // The lone king can kill a piece without any defense, so it's a draw.
+                counters[i - half] = NEVER_LOST;
+            } else if (moves == ChessBitboard::EMPTY) {
+                if (ChessBitboard::IsSet(attacks, weakKing)) {
+                    victim[i] = 1;
+                    losses.push_back(i);
+                } else {
+                    counters[i - half] = NEVER_LOST;
+                }
+            } else {
+                counters[i - half] = static_cast<unsigned char>(ChessBitboard::Count(moves));
+            }
+        }
+    }
+
+    // Go back from the lost positions to the won ones, and from the won positions
+    // to the ones where all the moves of the lone king go to a won position.
+    for (int distance = 1; !losses.empty() && distance + 2 < INVALID_VALUE; distance += 2) {
+        wins.clear();
+        for (size_t i = 0; i < losses.size(); ++i) {
+            getPosition(ending, losses[i], position);
+            auto occupancy = getOccupancy(ending, position);
+            for (int j = 0; j < pieces; ++j) {
+                if (j == WEAK_KING) continue;
+                int square = position.squares[j];
+                int type = j == STRONG_KING ? ChessGameData::KING_PIECE :
+                    info.types[j - FIRST_PIECE];
+                auto origins = GetPieceAttacks(type, square, occupancy) & ~occupancy;
+                while (origins != ChessBitboard::EMPTY) {
+                    Position previous = position;
+                    previous.turn = STRONG_TURN;
+                    previous.squares[j] = ChessBitboard::PopFirst(origins);
+                    auto index = getIndex(ending, previous);
+                    if (victim[index] == UNKNOWN_VALUE) {
+                        victim[index] = static_cast<unsigned char>(distance + 1);
+                        wins.push_back(index);
+                    }
+                }
+            }
+        }
+
+        losses.clear();
+        for (size_t i = 0; i < wins.size(); ++i) {
+            getPosition(ending, wins[i], position);
+            auto occupancy = getOccupancy(ending, position);
+            auto origins = ChessBitboard::KingAttacks(position.squares[WEAK_KING]) & ~occupancy;
+            while (origins != ChessBitboard::EMPTY) {
+                Position previous = position;
+                previous.turn = WEAK_TURN;
+                previous.squares[WEAK_KING] = ChessBitboard::PopFirst(origins);
+                auto index = getIndex(ending, previous);
+                auto & counter = counters[index - half];
+                if (victim[index] == UNKNOWN_VALUE && counter != NEVER_LOST && --counter == 0) {
+                    victim[index] = static_cast<unsigned char>(distance + 2);
+                    losses.push_back(index);
+                }
+            }
+        }
+    }
+}
+
+//********************************************************************************
+// Constructors, destructor and operators
+//********************************************************************************
+
+ChessTablebase::ChessTablebase() {
+    for (int i = 0; i < MAX_ENDINGS; ++i) {
+        tables_[i].data = nullptr;
+        tables_[i].size = 0;
+    }
+}
+
+//--------------------------------------------------------------------------------
+
+ChessTablebase::~ChessTablebase() {}
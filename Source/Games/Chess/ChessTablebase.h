@@ -0,0 +1,107 @@
+/******************************************************************************
+ Copyright (c) 2014 Gorka Surez Garca
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ DEALINGS IN THE SOFTWARE.
+******************************************************************************/
+
+#ifndef __CHESS_TABLEBASE_HEADER__
+#define __CHESS_TABLEBASE_HEADER__
+
+#include <string>
+#include <vector>
+#include <System/MappedFile.h>
+#include <Games/Chess/ChessGameData.h>
+
+/**
+ * This class represents the tablebases of the endings with a lone king. Each table
+ * stores for every position the distance to the mate in plies, and it is generated
+ * with a retrograde analysis the first time, then it is saved and mapped from disk.
+ */
+class ChessTablebase {
+public:
+    //--------------------------------------------------------------------------------
+    // Constants
+    //--------------------------------------------------------------------------------
+
+    static const int KQK_ENDING  = 0;
+    static const int KRK_ENDING  = 1;
+    static const int KBBK_ENDING = 2;
+    static const int MAX_ENDINGS = 3;
+
+    static const int MAX_PIECES = 4;
+
+    //--------------------------------------------------------------------------------
+    // Properties
+    //--------------------------------------------------------------------------------
+
+    bool IsLoaded(int ending) const { return tables_[ending].data != nullptr; }
+
+    //--------------------------------------------------------------------------------
+    // Methods
+    //--------------------------------------------------------------------------------
+
+    void Load(const std::string & directory);
+    bool Probe(const ChessGameData & data, int & distance) const;
+
+    //--------------------------------------------------------------------------------
+    // Constructors, destructor and operators
+    //--------------------------------------------------------------------------------
+
+    ChessTablebase();
+    ~ChessTablebase();
+
+private:
+    //--------------------------------------------------------------------------------
+    // Types
+    //--------------------------------------------------------------------------------
+
+    typedef ChessGameData::Bitboard Bitboard;
+    typedef std::vector<unsigned char> Buffer;
+
+    struct Table {
+        MappedFile file;
+        Buffer memory;
+        const unsigned char * data;
+        size_t size;
+    };
+
+    struct Position {
+        int turn;
+        int squares[MAX_PIECES];
+    };
+
+    //--------------------------------------------------------------------------------
+    // Fields
+    //--------------------------------------------------------------------------------
+
+    Table tables_[MAX_ENDINGS];
+
+    //--------------------------------------------------------------------------------
+    // Methods
+    //--------------------------------------------------------------------------------
+
+    static size_t getSize(int ending);
+    static size_t getIndex(int ending, const Position & position);
+    static void getPosition(int ending, size_t index, Position & position);
+    static Bitboard getAttacks(int ending, const Position & position, Bitboard occupancy);
+    static Bitboard getOccupancy(int ending, const Position & position);
+    static void generate(int ending, Buffer & victim);
+};
+
+#endif
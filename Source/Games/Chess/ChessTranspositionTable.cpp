@@ -0,0 +1,168 @@
+/******************************************************************************
+ Copyright (c) 2014 Gorka Surez Garca
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ DEALINGS IN THE SOFTWARE.
+******************************************************************************/
+
+#include "ChessTranspositionTable.h"
+#include <cstring>
+
+//********************************************************************************
+// Constants
+//********************************************************************************
+
+const int MOVE_BITS  = 12;
+const int SCORE_BITS = 32;
+const int DEPTH_BITS =  8;
+const int BOUND_BITS =  2;
+const int AGE_BITS   =  8;
+
+const int SCORE_SHIFT = MOVE_BITS;
+const int DEPTH_SHIFT = SCORE_SHIFT + SCORE_BITS;
+const int BOUND_SHIFT = DEPTH_SHIFT + DEPTH_BITS;
+const int AGE_SHIFT   = BOUND_SHIFT + BOUND_BITS;
+
+const int MAX_AGE = (1 << AGE_BITS) - 1;
+
+const int MEGABYTE = 1024 * 1024;
+
+//********************************************************************************
+// Methods (Public)
+//********************************************************************************
+
+void ChessTranspositionTable::Resize(int megabytes) {
+    // Get the largest power of two number of buckets inside the size.
+    if (megabytes < 1) megabytes = 1;
+    HashKey count = 1;
+    while (count * 2 * sizeof(Bucket) <= static_cast<HashKey>(megabytes) * MEGABYTE) {
+        count *= 2;
+    }
+
+    // Align the buckets with the cache lines of the memory.
+    memory_.reset(new char[static_cast<size_t>(count * sizeof(Bucket)) + CACHE_LINE]);
+    auto address = reinterpret_cast<size_t>(memory_.get());
+    buckets_ = reinterpret_cast<Bucket *>((address + CACHE_LINE - 1) & ~(CACHE_LINE - 1));
+    mask_ = count - 1;
+    size_ = megabytes;
+    Clear();
+}
+
+//--------------------------------------------------------------------------------
+
+void ChessTranspositionTable::Clear() {
+    std::memset(buckets_, 0, static_cast<size_t>((mask_ + 1) * sizeof(Bucket)));
+    age_ = 0;
+}
+
+//--------------------------------------------------------------------------------
+
+void ChessTranspositionTable::NewSearch() {
+    age_ = (age_ + 1) & MAX_AGE;
+}
+
+//--------------------------------------------------------------------------------
+
+bool ChessTranspositionTable::Probe(HashKey key, Entry & victim) const {
+    auto & bucket = getBucket(key);
+    for (int i = 0; i < BUCKET_SLOTS; ++i) {
+        auto data = bucket.slots[i].data;
+        if ((bucket.slots[i].check ^ data) == key && data != 0) {
+            unpackData(data, victim);
+            return true;
+        }
+    }
+    return false;
+}
+
+//--------------------------------------------------------------------------------
+
+void ChessTranspositionTable::Store(HashKey key, int move, int score, int depth, int bound) {
+    // Find the slot of the same position or the less valuable one, where the
+    // entries of the old searches are worse than any entry of the current one.
+    auto & bucket = getBucket(key);
+    Slot * victim = nullptr;
+    int worst = 0;
+    for (int i = 0; i < BUCKET_SLOTS; ++i) {
+        auto & slot = bucket.slots[i];
+        auto data = slot.data;
+        if ((slot.check ^ data) == key && data != 0) {
+            // Keep the previous best move when the new search doesn't find one.
+            Entry previous;
+            unpackData(data, previous);
+            if (move == NO_MOVE) move = previous.move;
+            if (bound != BOUND_EXACT && previous.depth > depth &&
+                getAge(data) == age_) {
+                return;
+            }
+            victim = &slot;
+            break;
+        }
+        int value = static_cast<int>((data >> DEPTH_SHIFT) & ((1 << DEPTH_BITS) - 1)) -
+            ((age_ - getAge(data)) & MAX_AGE) * 256;
+        if (victim == nullptr || value < worst) {
+            victim = &slot;
+            worst = value;
+        }
+    }
+
+    auto data = packData(move, score, depth, bound, age_);
+    victim->check = key ^ data;
+    victim->data = data;
+}
+
+//********************************************************************************
+// Methods (Private)
+//********************************************************************************
+
+ChessTranspositionTable::EntryData ChessTranspositionTable::packData(int move, int score,
+    int depth, int bound, int age) {
+    return static_cast<EntryData>(move & ((1 << MOVE_BITS) - 1)) |
+        (static_cast<EntryData>(static_cast<unsigned int>(score)) << SCORE_SHIFT) |
+        (static_cast<EntryData>(depth & ((1 << DEPTH_BITS) - 1)) << DEPTH_SHIFT) |
+        (static_cast<EntryData>(bound & ((1 << BOUND_BITS) - 1)) << BOUND_SHIFT) |
+        (static_cast<EntryData>(age & MAX_AGE) << AGE_SHIFT);
+}
+
+//--------------------------------------------------------------------------------
+
+void ChessTranspositionTable::unpackData(EntryData data, Entry & victim) {
+    victim.move = static_cast<int>(data & ((1 << MOVE_BITS) - 1));
+    victim.score = static_cast<int>(static_cast<unsigned int>(data >> SCORE_SHIFT));
+    victim.depth = static_cast<int>((data >> DEPTH_SHIFT) & ((1 << DEPTH_BITS) - 1));
+    victim.bound = static_cast<int>((data >> BOUND_SHIFT) & ((1 << BOUND_BITS) - 1));
+}
+
+//--------------------------------------------------------------------------------
+
+int ChessTranspositionTable::getAge(EntryData data) {
+    return static_cast<int>((data >> AGE_SHIFT) & MAX_AGE);
+}
+
+//********************************************************************************
+// Constructors, destructor and operators
+//********************************************************************************
+
+ChessTranspositionTable::ChessTranspositionTable() : size_(0), buckets_(nullptr),
+    mask_(0), age_(0) {
+    Resize(DEFAULT_SIZE);
+}
+
+//--------------------------------------------------------------------------------
+
+ChessTranspositionTable::~ChessTranspositionTable() {}
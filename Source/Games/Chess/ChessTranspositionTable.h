@@ -0,0 +1,124 @@
+/******************************************************************************
+ Copyright (c) 2014 Gorka Surez Garca
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ DEALINGS IN THE SOFTWARE.
+******************************************************************************/
+
+#ifndef __CHESS_TRANSPOSITION_TABLE_HEADER__
+#define __CHESS_TRANSPOSITION_TABLE_HEADER__
+
+#include <memory>
+#include <Games/Chess/ChessZobrist.h>
+
+/**
+ * This class represents a cache of searched positions, indexed by their hash keys.
+ * Each bucket of entries fills a cache line, and each entry stores the key mixed
+ * with the data, so a torn entry written by other thread is never accepted.
+ */
+class ChessTranspositionTable {
+public:
+    //--------------------------------------------------------------------------------
+    // Types
+    //--------------------------------------------------------------------------------
+
+    typedef ChessZobrist::HashKey HashKey;
+
+    struct Entry {
+        int move, score, depth, bound;
+    };
+
+    //--------------------------------------------------------------------------------
+    // Constants
+    //--------------------------------------------------------------------------------
+
+    static const int DEFAULT_SIZE = 16;
+
+    static const int NO_MOVE = 0xFFF;
+
+    static const int BOUND_NONE  = 0;
+    static const int BOUND_UPPER = 1;
+    static const int BOUND_LOWER = 2;
+    static const int BOUND_EXACT = 3;
+
+    //--------------------------------------------------------------------------------
+    // Properties
+    //--------------------------------------------------------------------------------
+
+    int Size() const { return size_; }
+
+    //--------------------------------------------------------------------------------
+    // Methods
+    //--------------------------------------------------------------------------------
+
+    void Resize(int megabytes);
+    void Clear();
+    void NewSearch();
+
+    bool Probe(HashKey key, Entry & victim) const;
+    void Store(HashKey key, int move, int score, int depth, int bound);
+
+    //--------------------------------------------------------------------------------
+    // Constructors, destructor and operators
+    //--------------------------------------------------------------------------------
+
+    ChessTranspositionTable();
+    ~ChessTranspositionTable();
+
+private:
+    //--------------------------------------------------------------------------------
+    // Types
+    //--------------------------------------------------------------------------------
+
+    typedef unsigned long long EntryData;
+
+    // The fields are read only once by probe, because other threads can write them.
+    struct Slot {
+        volatile HashKey check;
+        volatile EntryData data;
+    };
+
+    static const int BUCKET_SLOTS = 4;
+    static const int CACHE_LINE   = 64;
+
+    struct Bucket {
+        Slot slots[BUCKET_SLOTS];
+    };
+
+    //--------------------------------------------------------------------------------
+    // Fields
+    //--------------------------------------------------------------------------------
+
+    int size_;
+    std::unique_ptr<char[]> memory_;
+    Bucket * buckets_;
+    HashKey mask_;
+    int age_;
+
+    //--------------------------------------------------------------------------------
+    // Methods
+    //--------------------------------------------------------------------------------
+
+    Bucket & getBucket(HashKey key) const { return buckets_[key & mask_]; }
+
+    static EntryData packData(int move, int score, int depth, int bound, int age);
+    static void unpackData(EntryData data, Entry & victim);
+    static int getAge(EntryData data);
+};
+
+#endif
@@ -0,0 +1,69 @@
+/******************************************************************************
+ Copyright (c) 2014 Gorka Surez Garca
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ DEALINGS IN THE SOFTWARE.
+******************************************************************************/
+
+#include "ChessZobrist.h"
+
+//********************************************************************************
+// Static
+//********************************************************************************
+
+bool ChessZobrist::initialized_ = false;
+
+ChessZobrist::HashKey ChessZobrist::pieceKeys_[MAX_SIDES][PIECE_TYPES][MAX_SQUARES];
+ChessZobrist::HashKey ChessZobrist::markKeys_[MAX_MARKS][MAX_SQUARES];
+ChessZobrist::HashKey ChessZobrist::sideKey_ = 0ULL;
+
+//********************************************************************************
+// Methods
+//********************************************************************************
+
+void ChessZobrist::Initialize() {
+    if (initialized_) return;
+
+    // A fixed seed xorshift generator, so the keys are the same in every run.
+    HashKey seed = 0x2545F4914F6CDD1DULL;
+    auto random = [&] () -> HashKey {
+        seed ^= seed >> 12; seed ^= seed << 25; seed ^= seed >> 27;
+        return seed * 2685821657736338717ULL;
+    };
+
+    for (int i = 0; i < MAX_SIDES; ++i) {
+        for (int j = 0; j < PIECE_TYPES; ++j) {
+            for (int k = 0; k < MAX_SQUARES; ++k) {
+                pieceKeys_[i][j][k] = random();
+            }
+        }
+    }
+
+    // The pieces without a mark don't change the hash of the board.
+    for (int k = 0; k < MAX_SQUARES; ++k) {
+        markKeys_[0][k] = 0ULL;
+    }
+    for (int i = 1; i < MAX_MARKS; ++i) {
+        for (int k = 0; k < MAX_SQUARES; ++k) {
+            markKeys_[i][k] = random();
+        }
+    }
+
+    sideKey_ = random();
+    initialized_ = true;
+}
@@ -0,0 +1,72 @@
+/******************************************************************************
+ Copyright (c) 2014 Gorka Surez Garca
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ DEALINGS IN THE SOFTWARE.
+******************************************************************************/
+
+#ifndef __CHESS_ZOBRIST_HEADER__
+#define __CHESS_ZOBRIST_HEADER__
+
+/**
+ * This static class contains the random keys to hash the positions of the board.
+ */
+class ChessZobrist {
+private:
+    ChessZobrist() {}
+    ~ChessZobrist() {}
+
+public:
+    //--------------------------------------------------------------------------------
+    // Types
+    //--------------------------------------------------------------------------------
+
+    typedef unsigned long long HashKey;
+
+    //--------------------------------------------------------------------------------
+    // Constants
+    //--------------------------------------------------------------------------------
+
+    static const int MAX_SIDES   =  2;
+    static const int PIECE_TYPES =  6;
+    static const int MAX_MARKS   =  4;
+    static const int MAX_SQUARES = 64;
+
+    //--------------------------------------------------------------------------------
+    // Methods
+    //--------------------------------------------------------------------------------
+
+    static void Initialize();
+
+    static HashKey PieceKey(int side, int type, int square) { return pieceKeys_[side][type][square]; }
+    static HashKey MarkKey(int mark, int square)            { return markKeys_[mark][square];        }
+    static HashKey SideKey()                                { return sideKey_;                       }
+
+private:
+    //--------------------------------------------------------------------------------
+    // Fields
+    //--------------------------------------------------------------------------------
+
+    static bool initialized_;
+
+    static HashKey pieceKeys_[MAX_SIDES][PIECE_TYPES][MAX_SQUARES];
+    static HashKey markKeys_[MAX_MARKS][MAX_SQUARES];
+    static HashKey sideKey_;
+};
+
+#endif
@@ -445,7 +445,7 @@ void GenericLogic::updateGhostState(int time) {
  */
 void GenericLogic::clearCell(PuckmanEntity & puckman, const sf::Vector2i & cell) {
     puckman.SetSlow();
-    maze_->Data()[cell.y][cell.x] = Maze::CLEAN;
+    maze_->SetCell(cell.y, cell.x, Maze::CLEAN);
     lastCellCleared_ = cell;
 }
 
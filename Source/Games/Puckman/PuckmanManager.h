@@ -30,6 +30,10 @@
 #include <System/AbstractState.h>
 #include <Games/Puckman/PuckmanEnums.h>
 
+namespace sf {
+    class VertexArray;
+}
+
 namespace Puckman {
     class GameData;
     class InsertCoinState;
@@ -106,6 +110,7 @@ namespace Puckman {
         void ClearCell(int row, int col);
         void DrawTile(int row, int col, int index, const sf::Color & color);
         void DrawTile(int row, int col, int index);
+        void AppendTile(sf::VertexArray & victim, int row, int col, int index);
 
         int GetIndexFromChar(char c);
         void DrawText(int row, int col, const std::string & text, const sf::Color & color);
@@ -75,6 +75,15 @@ void Manager::DrawTile(int row, int col, int index) {
     DrawTile(row, col, index, sf::Color::White);
 }
 
+//--------------------------------------------------------------------------------
+
+/**
+ * Adds a tile to a vertex array, with the coordinates of the cell inside the maze.
+ */
+void Manager::AppendTile(sf::VertexArray & victim, int row, int col, int index) {
+    data_->tiles_[index].Append(victim, col * CELL_WIDTH, row * CELL_HEIGHT);
+}
+
 //********************************************************************************
 // Text Methods
 //********************************************************************************
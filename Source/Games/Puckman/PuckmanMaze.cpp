@@ -21,6 +21,10 @@
 ******************************************************************************/
 
 #include "PuckmanMaze.h"
+#include <SFML/Graphics/RenderTexture.hpp>
+#include <SFML/Graphics/Sprite.hpp>
+#include <SFML/Graphics/VertexArray.hpp>
+#include <System/CoreManager.h>
 #include <Games/Puckman/PuckmanManager.h>
 #include <Games/Puckman/PuckmanGhost.h>
 #include <Games/Puckman/PuckmanSprites.h>
@@ -111,6 +115,20 @@ void Maze::Initialize() {
     }
     doorOpen_ = false;
     numberOfDots_ = MAXIMUM_DOTS;
+    dirtyCells_.clear();
+    redrawLayer_ = true;
+}
+
+//--------------------------------------------------------------------------------
+
+/**
+ * Changes a cell of the maze.
+ */
+void Maze::SetCell(int row, int col, int value) {
+    if (data_[row][col] != value) {
+        data_[row][col] = value;
+        dirtyCells_.push_back(sf::Vector2i(col, row));
+    }
 }
 
 //--------------------------------------------------------------------------------
@@ -119,15 +137,67 @@ void Maze::Initialize() {
  * Draws the maze on the screen.
  */
 void Maze::Draw(Manager * manager) {
-    for (int i = 0; i < ROWS; ++i) {
-        for (int j = 0; j < COLUMS; ++j) {
-            manager->DrawTile(i, j, data_[i][j]);
+    if (updateLayer(manager)) {
+        // When the layer is updated, we'll draw it on the screen.
+        sf::Sprite sprite(layer_->getTexture());
+        sf::Vector2i position = manager->CellCoordsToVector2(0, 0);
+        sprite.setPosition((float)position.x, (float)position.y);
+        CoreManager::Reference().Draw(sprite);
+    } else {
+        // Without the layer, we'll draw every tile on the screen.
+        for (int i = 0; i < ROWS; ++i) {
+            for (int j = 0; j < COLUMS; ++j) {
+                manager->DrawTile(i, j, data_[i][j]);
+            }
         }
     }
 }
 
 //--------------------------------------------------------------------------------
 
+/**
+ * Draws inside the layer the cells changed after the last update.
+ */
+bool Maze::updateLayer(Manager * manager) {
+    if (!useLayer_ || !manager->Tileset()) return false;
+    // First, we'll create the layer if we don't have one.
+    if (!layer_) {
+        layer_.reset(new sf::RenderTexture());
+        if (!layer_->create(COLUMS * Manager::CELL_WIDTH, ROWS * Manager::CELL_HEIGHT)) {
+            layer_.reset(nullptr);
+            useLayer_ = false;
+            return false;
+        }
+        redrawLayer_ = true;
+    }
+    // Second, we'll get the tiles of all the maze or only of the changed cells.
+    if (redrawLayer_ || !dirtyCells_.empty()) {
+        sf::VertexArray vertices(sf::Quads);
+        if (redrawLayer_) {
+            for (int i = 0; i < ROWS; ++i) {
+                for (int j = 0; j < COLUMS; ++j) {
+                    manager->AppendTile(vertices, i, j, data_[i][j]);
+                }
+            }
+        } else {
+            for (int k = 0, len = dirtyCells_.size(); k < len; ++k) {
+                const sf::Vector2i & cell = dirtyCells_[k];
+                manager->AppendTile(vertices, cell.y, cell.x, data_[cell.y][cell.x]);
+            }
+        }
+        // And finally, we'll replace the old pixels of the cells with the new tiles.
+        sf::RenderStates states(sf::BlendNone, sf::Transform::Identity,
+            manager->Tileset().get(), nullptr);
+        layer_->draw(vertices, states);
+        layer_->display();
+        dirtyCells_.clear();
+        redrawLayer_ = false;
+    }
+    return true;
+}
+
+//--------------------------------------------------------------------------------
+
 /**
  * Checks if a cell is walkable or not.
  */
@@ -242,7 +312,7 @@ bool Maze::CheckGhostCoords(int x, int y) {
 /**
  * Constructs a new object.
  */
-Maze::Maze() {
+Maze::Maze() : layer_(nullptr), dirtyCells_(), redrawLayer_(true), useLayer_(true) {
     Initialize();
 }
 
@@ -252,7 +322,8 @@ Maze::Maze() {
  * The copy constructor of the object.
  */
 Maze::Maze(const Maze & source) : doorOpen_(source.doorOpen_),
-    numberOfDots_(source.numberOfDots_) {
+    numberOfDots_(source.numberOfDots_), layer_(nullptr), dirtyCells_(),
+    redrawLayer_(true), useLayer_(true) {
     for (int i = 0; i < ROWS; ++i) {
         for (int j = 0; j < COLUMS; ++j) {
             data_[i][j] = source.data_[i][j];
@@ -266,3 +337,21 @@ Maze::Maze(const Maze & source) : doorOpen_(source.doorOpen_),
  * The destructor of the object.
  */
 Maze::~Maze() {}
+
+//--------------------------------------------------------------------------------
+
+/**
+ * The assign operator of the object.
+ */
+Maze & Maze::operator =(const Maze & source) {
+    doorOpen_ = source.doorOpen_;
+    numberOfDots_ = source.numberOfDots_;
+    for (int i = 0; i < ROWS; ++i) {
+        for (int j = 0; j < COLUMS; ++j) {
+            data_[i][j] = source.data_[i][j];
+        }
+    }
+    dirtyCells_.clear();
+    redrawLayer_ = true;
+    return *this;
+}
@@ -23,14 +23,21 @@
 #ifndef __PUCKMAN_MAZE_HEADER__
 #define __PUCKMAN_MAZE_HEADER__
 
+#include <memory>
+#include <vector>
 #include <SFML/Graphics/Rect.hpp>
 
+namespace sf {
+    class RenderTexture;
+}
+
 namespace Puckman {
     class Ghost;
     class Manager;
 
     /**
-     * This class represents the maze of the game.
+     * This class represents the maze of the game. The tiles are drawn once inside
+     * a layer texture, and only the cells changed later are drawn again.
      */
     class Maze {
     public:
@@ -139,7 +146,7 @@ namespace Puckman {
         //--------------------------------------------------------------------------------
 
         // The data of the maze.
-        Table & Data() { return data_; }
+        const Table & Data() const { return data_; }
 
         // This tells to the program if the door is open for the ghosts.
         bool DoorOpen() { return doorOpen_; }
@@ -161,6 +168,7 @@ namespace Puckman {
         static bool IsGhostInTheStartPoint(const Ghost & ghost);
 
         void Initialize();
+        void SetCell(int row, int col, int value);
         void Draw(Manager * manager);
         bool CheckSpriteCoords(int x, int y);
         bool CheckGhostCoords(int x, int y);
@@ -172,6 +180,7 @@ namespace Puckman {
         Maze();
         Maze(const Maze & source);
         virtual ~Maze();
+        Maze & operator =(const Maze & source);
 
     private:
         //--------------------------------------------------------------------------------
@@ -182,11 +191,24 @@ namespace Puckman {
         bool doorOpen_;
         int numberOfDots_;
 
+        // The layer with the tiles of the maze.
+        std::unique_ptr<sf::RenderTexture> layer_;
+
+        // The cells changed after the last time the layer was drawn.
+        std::vector<sf::Vector2i> dirtyCells_;
+
+        // This tells to the program if all the layer has to be drawn again.
+        bool redrawLayer_;
+
+        // This tells to the program if the layer can be used.
+        bool useLayer_;
+
         //--------------------------------------------------------------------------------
         // Methods
         //--------------------------------------------------------------------------------
 
         bool isCellWalkable(int row, int col);
+        bool updateLayer(Manager * manager);
     };
 }
 
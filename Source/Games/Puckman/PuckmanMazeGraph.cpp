@@ -23,7 +23,6 @@
 #include "PuckmanMazeGraph.h"
 #include <System/CoreManager.h>
 #include <System/MathUtil.h>
-#include <System/ForEach.h>
 #include <Games/Puckman/PuckmanManager.h>
 #include <Games/Puckman/PuckmanPuckmanEntity.h>
 #include <Games/Puckman/PuckmanGhost.h>
@@ -47,7 +46,7 @@ MazeGraph::Node::Node(int row, int col) {
     Col = col;
     X = col * Manager::CELL_WIDTH - Maze::SPRITE_SEP_X;
     Y = row * Manager::CELL_HEIGHT - Maze::SPRITE_SEP_Y;
-    Dirs.clear();
+    Dirs = 0;
 }
 
 //--------------------------------------------------------------------------------
@@ -112,12 +111,88 @@ void MazeGraph::resetMap() {
 //--------------------------------------------------------------------------------
 
 /**
- * Sets a cell of the map with a value.
+ * Builds the set of directions of every cell of the maze.
  */
-void MazeGraph::setMapValue(int row, int col, bool value) {
-    if(row < 0) row += Manager::ROWS;
-    if(col < 0) col += Manager::COLUMS;
-    map_[row % Manager::ROWS][col % Manager::COLUMS] = value;
+void MazeGraph::buildMasks() {
+    for (int i = 0; i < Maze::ROWS; ++i) {
+        for (int j = 0; j < Maze::COLUMS; ++j) {
+            DirectionMask dirs = 0;
+            if(getMapValue(i - 1, j)) dirs |= GetDirectionFlag(MovingDirection::Up);
+            if(getMapValue(i + 1, j)) dirs |= GetDirectionFlag(MovingDirection::Down);
+            if(getMapValue(i, j - 1)) dirs |= GetDirectionFlag(MovingDirection::Left);
+            if(getMapValue(i, j + 1)) dirs |= GetDirectionFlag(MovingDirection::Right);
+            masks_[i][j] = dirs;
+        }
+    }
+}
+
+//--------------------------------------------------------------------------------
+
+/**
+ * Builds the table with the shortest paths between the walkable cells.
+ */
+void MazeGraph::buildPaths() {
+    // First, we'll give an index inside the table to every walkable cell.
+    std::vector<sf::Vector2i> cells;
+    for (int i = 0; i < Maze::ROWS; ++i) {
+        for (int j = 0; j < Maze::COLUMS; ++j) {
+            if(map_[i][j]) {
+                indexes_[i][j] = static_cast<int>(cells.size());
+                cells.push_back(sf::Vector2i(j, i));
+            } else {
+                indexes_[i][j] = NO_INDEX;
+            }
+        }
+    }
+    cellCount_ = static_cast<int>(cells.size());
+
+    // Second, we'll make a breadth-first search from every cell to get the distance
+    // to the rest of the cells, moving through the maze like the entities do.
+    distances_.assign(cellCount_ * cellCount_, static_cast<unsigned char>(UNREACHABLE));
+    std::vector<int> queue(cellCount_);
+    for(int orig = 0; orig < cellCount_; orig++) {
+        unsigned char * distances = &distances_[orig * cellCount_];
+        int first = 0, last = 0;
+        distances[orig] = 0;
+        queue[last++] = orig;
+        while(first < last) {
+            int current = queue[first++];
+            DirectionMask dirs = masks_[cells[current].y][cells[current].x];
+            for(int k = 0; k < DIRECTIONS; k++) {
+                MovingDirectionEnum dir = static_cast<MovingDirectionEnum>(k);
+                if(dirs & GetDirectionFlag(dir)) {
+                    sf::Vector2i next = GetNextPoint(cells[current], dir);
+                    int index = indexes_[next.y][next.x];
+                    if(distances[index] == UNREACHABLE) {
+                        distances[index] = distances[current] + 1;
+                        queue[last++] = index;
+                    }
+                }
+            }
+        }
+    }
+
+    // Finally, we'll link every cell of the maze with the nearest cell of the
+    // corridors, that are the cells reachable from the intersections, because
+    // the destinations of the ghosts can be walls or cells outside the corridors.
+    int corridor = indexes_[nodes_[0].Row][nodes_[0].Col];
+    const unsigned char * reachable = &distances_[corridor * cellCount_];
+    for (int i = 0; i < Maze::ROWS; ++i) {
+        for (int j = 0; j < Maze::COLUMS; ++j) {
+            sf::Vector2i cell(j, i);
+            int best = NO_INDEX, bestDistance = 0;
+            for(int k = 0; k < cellCount_; k++) {
+                if(reachable[k] != UNREACHABLE) {
+                    int distance = getDistance(cell, cells[k]);
+                    if(best == NO_INDEX || distance < bestDistance) {
+                        best = k;
+                        bestDistance = distance;
+                    }
+                }
+            }
+            nearest_[i][j] = best;
+        }
+    }
 }
 
 //--------------------------------------------------------------------------------
@@ -134,33 +209,34 @@ bool MazeGraph::getMapValue(int row, int col) {
 //--------------------------------------------------------------------------------
 
 /**
- * Locks a cell in the map.
+ * Gets the index of a cell inside the paths table.
  */
-void MazeGraph::lockCell(const sf::Vector2i & cell) {
-    setMapValue(cell.y, cell.x, false);
+int MazeGraph::getCellIndex(const sf::Vector2i & cell) {
+    if(0 <= cell.x && cell.x < Maze::COLUMS && 0 <= cell.y && cell.y < Maze::ROWS) {
+        return indexes_[cell.y][cell.x];
+    } else {
+        return NO_INDEX;
+    }
 }
 
 //--------------------------------------------------------------------------------
 
 /**
- * Unlocks a cell in the map.
+ * Gets the index of the nearest corridor cell to a destination.
  */
-void MazeGraph::unlockCell(const sf::Vector2i & cell) {
-    setMapValue(cell.y, cell.x, true);
+int MazeGraph::getTargetIndex(const sf::Vector2i & cell) {
+    int row = std::max(0, std::min(cell.y, Maze::ROWS - 1));
+    int col = std::max(0, std::min(cell.x, Maze::COLUMS - 1));
+    return nearest_[row][col];
 }
 
 //--------------------------------------------------------------------------------
 
 /**
- * Gets all the posible directions from a cell.
+ * Gets the length of the shortest path between two cells of the paths table.
  */
-MazeGraph::MovingDirections MazeGraph::GetDirections(int row, int col) {
-    MovingDirections list;
-    if(getMapValue(row - 1, col)) list.push_back(MovingDirection::Up);
-    if(getMapValue(row + 1, col)) list.push_back(MovingDirection::Down);
-    if(getMapValue(row, col - 1)) list.push_back(MovingDirection::Left);
-    if(getMapValue(row, col + 1)) list.push_back(MovingDirection::Right);
-    return list;
+int MazeGraph::getPathDistance(int orig, int dest) {
+    return distances_[orig * cellCount_ + dest];
 }
 
 //--------------------------------------------------------------------------------
@@ -168,85 +244,19 @@ MazeGraph::MovingDirections MazeGraph::GetDirections(int row, int col) {
 /**
  * Gets all the posible directions from a cell.
  */
-MazeGraph::MovingDirections MazeGraph::GetDirections(const sf::Vector2i & orig,
-    const sf::Vector2i & dest) {
-    MovingDirections list;
-    if(orig.y < dest.y) {
-        if(orig.x < dest.x) { // NW
-            if((dest.y - orig.y) <= (dest.x - orig.x)) {
-                if(getMapValue(orig.y + 1, orig.x)) list.push_back(MovingDirection::Down);
-                if(getMapValue(orig.y, orig.x + 1)) list.push_back(MovingDirection::Right);
-                if(getMapValue(orig.y, orig.x - 1)) list.push_back(MovingDirection::Left);
-                if(getMapValue(orig.y - 1, orig.x)) list.push_back(MovingDirection::Up);
-            } else {
-                if(getMapValue(orig.y, orig.x + 1)) list.push_back(MovingDirection::Right);
-                if(getMapValue(orig.y + 1, orig.x)) list.push_back(MovingDirection::Down);
-                if(getMapValue(orig.y - 1, orig.x)) list.push_back(MovingDirection::Up);
-                if(getMapValue(orig.y, orig.x - 1)) list.push_back(MovingDirection::Left);
-            }
-        } else if(orig.x == dest.x) { // N
-            if(getMapValue(orig.y + 1, orig.x)) list.push_back(MovingDirection::Down);
-            if(getMapValue(orig.y, orig.x + 1)) list.push_back(MovingDirection::Right);
-            if(getMapValue(orig.y, orig.x - 1)) list.push_back(MovingDirection::Left);
-            if(getMapValue(orig.y - 1, orig.x)) list.push_back(MovingDirection::Up);
-        } else { // NE
-            if((dest.y - orig.y) <= (orig.x - dest.x)) {
-                if(getMapValue(orig.y + 1, orig.x)) list.push_back(MovingDirection::Down);
-                if(getMapValue(orig.y, orig.x - 1)) list.push_back(MovingDirection::Left);
-                if(getMapValue(orig.y, orig.x + 1)) list.push_back(MovingDirection::Right);
-                if(getMapValue(orig.y - 1, orig.x)) list.push_back(MovingDirection::Up);
-            } else {
-                if(getMapValue(orig.y, orig.x - 1)) list.push_back(MovingDirection::Left);
-                if(getMapValue(orig.y + 1, orig.x)) list.push_back(MovingDirection::Down);
-                if(getMapValue(orig.y - 1, orig.x)) list.push_back(MovingDirection::Up);
-                if(getMapValue(orig.y, orig.x + 1)) list.push_back(MovingDirection::Right);
-            }
-        }
-    } else if(orig.y == dest.y) {
-        if(orig.x < dest.x) { // W
-            if(getMapValue(orig.y, orig.x + 1)) list.push_back(MovingDirection::Right);
-            if(getMapValue(orig.y - 1, orig.x)) list.push_back(MovingDirection::Up);
-            if(getMapValue(orig.y + 1, orig.x)) list.push_back(MovingDirection::Down);
-            if(getMapValue(orig.y, orig.x - 1)) list.push_back(MovingDirection::Left);
-        } else if(orig.x > dest.x) { // E
-            if(getMapValue(orig.y, orig.x - 1)) list.push_back(MovingDirection::Left);
-            if(getMapValue(orig.y - 1, orig.x)) list.push_back(MovingDirection::Up);
-            if(getMapValue(orig.y + 1, orig.x)) list.push_back(MovingDirection::Down);
-            if(getMapValue(orig.y, orig.x + 1)) list.push_back(MovingDirection::Right);
-        }
-    } else {
-        if(orig.x < dest.x) { // SW
-            if((orig.y - dest.y) <= (dest.x - orig.x)) {
-                if(getMapValue(orig.y - 1, orig.x)) list.push_back(MovingDirection::Up);
-                if(getMapValue(orig.y, orig.x + 1)) list.push_back(MovingDirection::Right);
-                if(getMapValue(orig.y, orig.x - 1)) list.push_back(MovingDirection::Left);
-                if(getMapValue(orig.y + 1, orig.x)) list.push_back(MovingDirection::Down);
-            } else {
-                if(getMapValue(orig.y, orig.x + 1)) list.push_back(MovingDirection::Right);
-                if(getMapValue(orig.y - 1, orig.x)) list.push_back(MovingDirection::Up);
-                if(getMapValue(orig.y + 1, orig.x)) list.push_back(MovingDirection::Down);
-                if(getMapValue(orig.y, orig.x - 1)) list.push_back(MovingDirection::Left);
-            }
-        } else if(orig.x == dest.x) { // S
-            if(getMapValue(orig.y - 1, orig.x)) list.push_back(MovingDirection::Up);
-            if(getMapValue(orig.y, orig.x + 1)) list.push_back(MovingDirection::Right);
-            if(getMapValue(orig.y, orig.x - 1)) list.push_back(MovingDirection::Left);
-            if(getMapValue(orig.y + 1, orig.x)) list.push_back(MovingDirection::Down);
-        } else { // SE
-            if((orig.y - dest.y) <= (orig.x - dest.x)) {
-                if(getMapValue(orig.y - 1, orig.x)) list.push_back(MovingDirection::Up);
-                if(getMapValue(orig.y, orig.x - 1)) list.push_back(MovingDirection::Left);
-                if(getMapValue(orig.y, orig.x + 1)) list.push_back(MovingDirection::Right);
-                if(getMapValue(orig.y + 1, orig.x)) list.push_back(MovingDirection::Down);
-            } else {
-                if(getMapValue(orig.y, orig.x - 1)) list.push_back(MovingDirection::Left);
-                if(getMapValue(orig.y - 1, orig.x)) list.push_back(MovingDirection::Up);
-                if(getMapValue(orig.y + 1, orig.x)) list.push_back(MovingDirection::Down);
-                if(getMapValue(orig.y, orig.x + 1)) list.push_back(MovingDirection::Right);
-            }
-        }
-    }
-    return list;
+MazeGraph::DirectionMask MazeGraph::GetDirections(int row, int col) {
+    if(row < 0) row += Manager::ROWS;
+    if(col < 0) col += Manager::COLUMS;
+    return masks_[row % Manager::ROWS][col % Manager::COLUMS];
+}
+
+//--------------------------------------------------------------------------------
+
+/**
+ * Gets the flag of a direction inside a direction mask.
+ */
+MazeGraph::DirectionMask MazeGraph::GetDirectionFlag(MovingDirectionEnum dir) {
+    return dir < DIRECTIONS ? static_cast<DirectionMask>(1 << dir) : 0;
 }
 
 //--------------------------------------------------------------------------------
@@ -296,51 +306,6 @@ int MazeGraph::getDistance(const sf::Vector2i & orig, const sf::Vector2i & dest)
 
 //--------------------------------------------------------------------------------
 
-/**
- * Checks if there is a direct path.
- */
-bool MazeGraph::findDirectPath(const sf::Vector2i & orig, const sf::Vector2i & dest,
-    MovingDirectionEnum lastDir, int max) {
-    // The first thing to check is if we are in the destination.
-    if(orig != dest) {
-        // If we aren't in the destination, we'll get the current distance to it.
-        int currentDistance = getDistance(orig, dest);
-        if(max >= currentDistance) {
-            // If we go in the right direction, we'll lock this cell to test it.
-            bool result = false;
-            lockCell(orig);
-
-            // We'll check if the current cell is an intersection or not.
-            if(IsOnIntersection(orig.y, orig.x)) {
-                // If we're on an intersection, we'll first get the possible directions.
-                MovingDirections dirs = GetDirections(orig, dest);
-                ForEach(dirs, [&] (MovingDirectionEnum dir) {
-                    // Then for each possible direction, we'll check if we have a direct
-                    // path with it. When a direction returns true, the algorithm stops.
-                    if(!result) {
-                        result = findDirectPath(GetNextPoint(orig, dir), dest, dir, currentDistance);
-                    }
-                });
-            } else {
-                // If we're not on an intersection, we'll check the next cell.
-                result = findDirectPath(GetNextPoint(orig, lastDir), dest, lastDir, currentDistance);
-            }
-
-            // Finally, we'll unlock the cell and return the result of the algorithm.
-            unlockCell(orig);
-            return result;
-        } else {
-            // If we don't go in the right direction, we don't have a direct path.
-            return false;
-        }
-    } else {
-        // If we are in the destination, we find a direct path.
-        return true;
-    }
-}
-
-//--------------------------------------------------------------------------------
-
 /**
  * Gets the opposite direction from another one.
  */
@@ -357,53 +322,60 @@ MovingDirectionEnum MazeGraph::GetOppositeDirection(MovingDirectionEnum dir) {
 //--------------------------------------------------------------------------------
 
 /**
- * Erase a direction from an array.
+ * Counts the directions inside a mask.
  */
-MazeGraph::MovingDirections MazeGraph::eraseDirection(const MovingDirections & dirs,
-    MovingDirectionEnum dir) {
-    MovingDirections list;
-    ForEach(dirs, [&] (MovingDirectionEnum d) {
-        if(d != dir) {
-            list.push_back(d);
+int MazeGraph::countDirections(DirectionMask dirs) {
+    int count = 0;
+    for(; dirs; dirs &= dirs - 1) {
+        count++;
+    }
+    return count;
+}
+
+//--------------------------------------------------------------------------------
+
+/**
+ * Gets a direction inside a mask by its position.
+ */
+MovingDirectionEnum MazeGraph::getDirection(DirectionMask dirs, int index) {
+    for(int k = 0; k < DIRECTIONS; k++) {
+        MovingDirectionEnum dir = static_cast<MovingDirectionEnum>(k);
+        if(dirs & GetDirectionFlag(dir)) {
+            if(index == 0) return dir;
+            index--;
         }
-    });
-    return list;
+    }
+    return MovingDirection::None;
 }
 
 //--------------------------------------------------------------------------------
 
 /**
- * Gets a random direction from a list.
+ * Gets a random direction from a mask.
  */
-MovingDirectionEnum MazeGraph::getRandomDirection(MovingEntity & entity,
-    const MovingDirections & dirs) {
-    if(dirs.size() > 0) {
-        // If the list isn't empty, we'll erase the opposite direction from the list.
+MovingDirectionEnum MazeGraph::getRandomDirection(MovingEntity & entity, DirectionMask dirs) {
+    if(dirs) {
+        // If the mask isn't empty, we'll erase the opposite direction from the mask.
         MovingDirectionEnum opdir = GetOppositeDirection(entity.Direction());
-        MovingDirections options = eraseDirection(dirs, opdir);
-        // Then, we'll check the new list is empty.
-        if(options.size() == 0) {
-            // If the new list is empty, we'll return the unique direction in the old list.
-            return dirs[0];
-        } else if(options.size() == 1) {
-            // If the new list isn't empty, but only have one element, we'll return that one.
-            return options[0];
+        DirectionMask options = dirs & ~GetDirectionFlag(opdir);
+        int count = countDirections(options);
+        // Then, we'll check the new mask is empty.
+        if(count == 0) {
+            // If the new mask is empty, we'll return the unique direction in the old mask.
+            return getDirection(dirs, 0);
+        } else if(count == 1) {
+            // If the new mask isn't empty, but only have one element, we'll return that one.
+            return getDirection(options, 0);
+        } else if(options & GetDirectionFlag(entity.Direction())) {
+            // If the new mask isn't empty and have more than one element, we'll check if
+            // in the new mask is the last direction of the entity to follow that one.
+            return entity.Direction();
         } else {
-            // If the new list isn't empty and have more than one element, we'll check if
-            // in the new list is the last direction of the entity to follow that one.
-            auto it = options.begin(), end = options.end();
-            for (; it != end; ++it) {
-                MovingDirectionEnum d = *it;
-                if(d == entity.Direction()) {
-                    return d;
-                }
-            }
-
-            // If not, we'll get a random element from the new list.
-            return options[core_->Random(options.size())];
+            // If not, we'll get a random element from the new mask.
+            return getDirection(options, core_->Random(count));
         }
     } else {
-        // If the list is empty, we have none direction to return.
+        // If the mask is empty, we have none direction to return.
         return MovingDirection::None;
     }
 }
@@ -411,41 +383,37 @@ MovingDirectionEnum MazeGraph::getRandomDirection(MovingEntity & entity,
 //--------------------------------------------------------------------------------
 
 /**
- * Gets a random direction from a list.
+ * Gets a random direction from a mask.
  */
-MovingDirectionEnum MazeGraph::getRandomDirection(const MovingDirections & dirs) {
-    return dirs[core_->Random(dirs.size())];
+MovingDirectionEnum MazeGraph::getRandomDirection(DirectionMask dirs) {
+    int count = countDirections(dirs);
+    return count > 0 ? getDirection(dirs, core_->Random(count)) : MovingDirection::None;
 }
 
 //--------------------------------------------------------------------------------
 
 /**
- * Checks if a direction exists inside the array.
+ * Checks if a direction exists inside the mask.
  */
-MovingDirectionEnum MazeGraph::checkDirectionInList(const MovingDirections & dirs,
+MovingDirectionEnum MazeGraph::checkDirectionInMask(DirectionMask dirs,
     MovingDirectionEnum dir) {
-    auto it = dirs.begin(), end = dirs.end();
-    for (; it != end; ++it) {
-        MovingDirectionEnum d = *it;
-        if(d == dir) return dir;
-    }
-    return MovingDirection::None;
+    return (dirs & GetDirectionFlag(dir)) ? dir : MovingDirection::None;
 }
 
 //--------------------------------------------------------------------------------
 
 /**
- * Gets the direct direction if exists in the list.
+ * Gets the direct direction if exists in the mask.
  */
-MovingDirectionEnum MazeGraph::getDirectDirection(const sf::Vector2i & orig, const sf::Vector2i & dest, const MovingDirections & dirs) {
+MovingDirectionEnum MazeGraph::getDirectDirection(const sf::Vector2i & orig, const sf::Vector2i & dest, DirectionMask dirs) {
     if(orig.y == dest.y && orig.x < dest.x) { // W
-        return checkDirectionInList(dirs, MovingDirection::Right);
+        return checkDirectionInMask(dirs, MovingDirection::Right);
     } else if(orig.y == dest.y && orig.x > dest.x) { // E
-        return checkDirectionInList(dirs, MovingDirection::Left);
+        return checkDirectionInMask(dirs, MovingDirection::Left);
     } else if(orig.x == dest.x && orig.y < dest.y) { // N
-        return checkDirectionInList(dirs, MovingDirection::Down);
+        return checkDirectionInMask(dirs, MovingDirection::Down);
     } else if(orig.x == dest.x && orig.y > dest.y) { // S
-        return checkDirectionInList(dirs, MovingDirection::Up);
+        return checkDirectionInMask(dirs, MovingDirection::Up);
     } else {
         return MovingDirection::None;
     }
@@ -462,24 +430,40 @@ MovingDirectionEnum MazeGraph::GetDirection(MovingEntity & entity, const sf::Vec
     // And then we'll check if we're not in the destination.
     if(orig != dest) {
         // If we aren't in the destination, we'll get the possible directions.
-        MovingDirections dirs = GetDirections(orig, dest);
+        DirectionMask dirs = GetDirections(orig.y, orig.x);
         MovingDirectionEnum result = MovingDirection::None;
-        // We also need the distance from the entity to the destination cell.
-        int maxDistance = getDistance(orig, dest);
-
-        // Then, we'll lock the origin cell and try to find the first possible
-        // direction with a direct path available. After the test we'll unlock
-        // the cell to reset the maze map.
-        lockCell(orig);
-        ForEach(dirs, [&] (MovingDirectionEnum dir) {
-            if(result == MovingDirection::None &&
-                findDirectPath(GetNextPoint(orig, dir), dest, dir, maxDistance)) {
-                result = dir;
+        // Then, we'll look in the paths table for the neighbour cell with the shortest
+        // path to the destination. When the destination is a wall or a cell outside the
+        // corridors, we'll go to the nearest corridor cell to that destination.
+        int target = getTargetIndex(dest);
+        if(target != NO_INDEX) {
+            int index = getCellIndex(orig);
+            if(index == target) {
+                // If we are as near as we can be, we don't have to move anywhere.
+                return MovingDirection::None;
             }
-        });
-        unlockCell(orig);
+            // When two cells have the same distance, we'll take the cell nearest
+            // to the destination in a straight line.
+            int bestDistance = UNREACHABLE, bestLine = 0;
+            for(int k = 0; k < DIRECTIONS; k++) {
+                MovingDirectionEnum dir = static_cast<MovingDirectionEnum>(k);
+                if(dirs & GetDirectionFlag(dir)) {
+                    sf::Vector2i point = GetNextPoint(orig, dir);
+                    int next = getCellIndex(point);
+                    if(next != NO_INDEX) {
+                        int distance = getPathDistance(next, target);
+                        int line = getDistance(point, dest);
+                        if(distance < bestDistance || (distance == bestDistance && line < bestLine)) {
+                            bestDistance = distance;
+                            bestLine = line;
+                            result = dir;
+                        }
+                    }
+                }
+            }
+        }
 
-        // When there isn't a direct path, we'll try to get the direct direction.
+        // When there isn't a path, we'll try to get the direct direction.
         if(result == MovingDirection::None) {
             result = getDirectDirection(orig, dest, dirs);
         }
@@ -512,8 +496,8 @@ MovingDirectionEnum MazeGraph::GetEscapeDirection(Ghost & ghost, PuckmanEntity &
     // First, we'll get the cell of the ghost.
     sf::Vector2i orig = Maze::SpriteCoordsToMaze(ghost.X, ghost.Y);
     // Second, we'll get the possible directions.
-    MovingDirections dirs = GetDirections(orig.y, orig.x);
-    if(dirs.size() > 0) {
+    DirectionMask dirs = GetDirections(orig.y, orig.x);
+    if(dirs) {
         MovingDirectionEnum opdir;
         // Third, we'll check if puckman is in the same line.
         sf::Vector2i orig2 = Maze::SpriteCoordsToMaze(puckman.X, puckman.Y);
@@ -528,13 +512,13 @@ MovingDirectionEnum MazeGraph::GetEscapeDirection(Ghost & ghost, PuckmanEntity &
             // to avoid the ghost to repeat a loop between two intersections.
             opdir = GetOppositeDirection(ghost.Direction());
         }
-        // Here, we'll erase the selected opposite direction from the list.
-        MovingDirections options = eraseDirection(dirs, opdir);
-        if(options.size() > 0) {
+        // Here, we'll erase the selected opposite direction from the mask.
+        DirectionMask options = dirs & ~GetDirectionFlag(opdir);
+        if(options) {
             // And finally, we'll return a random direction.
-            return options[core_->Random(options.size())];
+            return getRandomDirection(options);
         } else {
-            return dirs[0];
+            return getDirection(dirs, 0);
         }
     } else {
         return MovingDirection::None;
@@ -550,9 +534,9 @@ MovingDirectionEnum MazeGraph::GetRandomDirection(MovingEntity & entity) {
     // First, we'll get the origin cell of the entity.
     sf::Vector2i orig = Maze::SpriteCoordsToMaze(entity.X, entity.Y);
     // Second, we'll the possible directions of the cell.
-    MovingDirections dirs = GetDirections(orig.y, orig.x);
+    DirectionMask dirs = GetDirections(orig.y, orig.x);
     // And, finally we'll return a random direction.
-    return getRandomDirection(dirs); ;
+    return getRandomDirection(dirs);
 }
 
 //--------------------------------------------------------------------------------
@@ -562,21 +546,7 @@ MovingDirectionEnum MazeGraph::GetRandomDirection(MovingEntity & entity) {
  */
 const MazeGraph::Node & MazeGraph::GetNode(MovingEntity & entity) {
     sf::Vector2i cell = Maze::SpriteCoordsToMaze(entity.X, entity.Y);
-    // First, we'll seek the current row.
-    for(int i = 0; i < ROWS; i++) {
-        if(rows_[i].Row == cell.y) {
-            // Second, we'll seek the current column.
-            for(int j = 0; j < COLS[i]; j++) {
-                if(rows_[i].Cols[j].Col == cell.x) {
-                    // Finally, if we find a node with the same row and column
-                    // we'll return that node to the user.
-                    return rows_[i].Cols[j];
-                }
-            }
-        }
-    }
-    // But when no node have the same coordinates we'll return the invalid node.
-    return NOT_FOUND;
+    return GetNode(cell.y, cell.x);
 }
 
 //--------------------------------------------------------------------------------
@@ -585,18 +555,10 @@ const MazeGraph::Node & MazeGraph::GetNode(MovingEntity & entity) {
  * Gets a node of the graph.
  */
 const MazeGraph::Node & MazeGraph::GetNode(int row, int col) {
-    // First, we'll seek the current row.
-    for(int i = 0; i < ROWS; i++) {
-        if(rows_[i].Row == row) {
-            // Second, we'll seek the current column.
-            for(int j = 0; j < COLS[i]; j++) {
-                if(rows_[i].Cols[j].Col == col) {
-                    // Finally, if we find a node with the same row and column
-                    // we'll return that node to the user.
-                    return rows_[i].Cols[j];
-                }
-            }
-        }
+    // When the coordinates have a node, we'll return that node to the user.
+    if(0 <= row && row < Maze::ROWS && 0 <= col && col < Maze::COLUMS &&
+        nodeIndexes_[row][col] != NO_INDEX) {
+        return nodes_[nodeIndexes_[row][col]];
     }
     // But when no node have the same coordinates we'll return the invalid node.
     return NOT_FOUND;
@@ -627,8 +589,7 @@ bool MazeGraph::IsOnIntersection(int row, int col) {
  */
 bool MazeGraph::IsNearToIntersection(MovingEntity & entity) {
     sf::Vector2i cell = Maze::SpriteCoordsToMaze(entity.X, entity.Y);
-    return GetNode(cell.y - 1, cell.x).IsValid() || GetNode(cell.y + 1, cell.x).IsValid() ||
-           GetNode(cell.y, cell.x - 1).IsValid() || GetNode(cell.y, cell.x + 1).IsValid();
+    return IsNearToIntersection(cell.y, cell.x);
 }
 
 //--------------------------------------------------------------------------------
@@ -663,50 +624,26 @@ MazeGraph::MazeGraph() {
         /* 50 Row 29 */ 1, 3, 6, 9, 12, 15, 18, 21, 24, 26,
         /* 60 Row 32 */ 1, 12, 15, 26
     };
-    const int DU = 0x01, DD = 0x02, DL = 0x04, DR = 0x08;
-    const int DIR_VALUES[] = {
-        /*  0 Row  4 */ DD|DR, DD|DL|DR, DD|DL, DD|DR, DD|DL|DR, DD|DL,
-        /*  6 Row  8 */ DD|DR|DU, DD|DL|DR|DU, DD|DL|DR, DL|DR|DU,
-                        DL|DR|DU, DD|DL|DR, DD|DL|DR|DU, DD|DL|DU,
-        /* 14 Row 11 */ DR|DU, DD|DL|DU, DR|DU, DD|DL,
-                        DD|DR, DL|DU, DD|DR|DU, DL|DU,
-        /* 22 Row 14 */ DD|DR, DL|DR|DU, DL|DR|DU, DD|DL,
-        /* 26 Row 17 */ DD|DL|DR|DU, DD|DL|DU, DD|DR|DU, DD|DL|DR|DU,
-        /* 30 Row 20 */ DD|DR|DU, DD|DL|DU,
-        /* 32 Row 23 */ DD|DR, DD|DL|DR|DU, DL|DR|DU, DD|DL,
-                        DD|DR, DL|DR|DU, DD|DL|DR|DU, DD|DL,
-        /* 40 Row 26 */ DR|DU, DD|DL, DD|DR|DU, DD|DL|DR, DL|DR|DU,
-                        DL|DR|DU, DD|DL|DR, DD|DL|DU, DD|DR, DL|DU,
-        /* 50 Row 29 */ DD|DR, DL|DR|DU, DL|DU, DR|DU, DD|DL,
-                        DD|DR, DL|DU, DR|DU, DL|DR|DU, DD|DL,
-        /* 60 Row 32 */ DR|DU, DL|DR|DU, DL|DR|DU, DL|DU
-    };
 
-    rows_.assign(ROWS, RowNode());
+    resetMap();
+    buildMasks();
 
-    for(int i = 0; i < ROWS; i++) {
-        rows_[i].Row = ROW_VALUES[i];
-        rows_[i].Y = ROW_VALUES[i] * Manager::CELL_HEIGHT - Maze::SPRITE_SEP_Y;
-        rows_[i].Cols.assign(COLS[i], Node());
+    for (int i = 0; i < Maze::ROWS; ++i) {
+        for (int j = 0; j < Maze::COLUMS; ++j) {
+            nodeIndexes_[i][j] = NO_INDEX;
+        }
+    }
 
+    for(int i = 0; i < ROWS; i++) {
         for(int j = 0; j < COLS[i]; j++) {
-            auto col = COL_VALUES[COL_STARTS[i] + j];
-            auto dirsMask = DIR_VALUES[COL_STARTS[i] + j];
-            rows_[i].Cols[j].Row = rows_[i].Row;
-            rows_[i].Cols[j].Col = COL_VALUES[COL_STARTS[i] + j];
-            rows_[i].Cols[j].X = COL_VALUES[COL_STARTS[i] + j] * Manager::CELL_WIDTH - Maze::SPRITE_SEP_X;
-            rows_[i].Cols[j].Y = rows_[i].Y;
-
-            MovingDirections dirs;
-            if (dirsMask | DU) dirs.push_back(MovingDirection::Up);
-            if (dirsMask | DD) dirs.push_back(MovingDirection::Down);
-            if (dirsMask | DL) dirs.push_back(MovingDirection::Left);
-            if (dirsMask | DR) dirs.push_back(MovingDirection::Right);
-            rows_[i].Cols[j].Dirs = dirs;
+            Node node(ROW_VALUES[i], COL_VALUES[COL_STARTS[i] + j]);
+            node.Dirs = masks_[node.Row][node.Col];
+            nodeIndexes_[node.Row][node.Col] = static_cast<int>(nodes_.size());
+            nodes_.push_back(node);
         }
     }
 
-    resetMap();
+    buildPaths();
 }
 
 //--------------------------------------------------------------------------------
@@ -715,12 +652,18 @@ MazeGraph::MazeGraph() {
  * The copy constructor of the object.
  */
 MazeGraph::MazeGraph(const MazeGraph & source) {
-    rows_ = source.rows_;
+    nodes_ = source.nodes_;
     for (int i = 0; i < Maze::ROWS; ++i) {
         for (int j = 0; j < Maze::COLUMS; ++j) {
             map_[i][j] = source.map_[i][j];
+            masks_[i][j] = source.masks_[i][j];
+            nodeIndexes_[i][j] = source.nodeIndexes_[i][j];
+            indexes_[i][j] = source.indexes_[i][j];
+            nearest_[i][j] = source.nearest_[i][j];
         }
     }
+    cellCount_ = source.cellCount_;
+    distances_ = source.distances_;
 }
 
 //--------------------------------------------------------------------------------
@@ -736,11 +679,17 @@ MazeGraph::~MazeGraph() {}
  * The assign operator of the object.
  */
 MazeGraph & MazeGraph::operator =(const MazeGraph & source) {
-    rows_ = source.rows_;
+    nodes_ = source.nodes_;
     for (int i = 0; i < Maze::ROWS; ++i) {
         for (int j = 0; j < Maze::COLUMS; ++j) {
             map_[i][j] = source.map_[i][j];
+            masks_[i][j] = source.masks_[i][j];
+            nodeIndexes_[i][j] = source.nodeIndexes_[i][j];
+            indexes_[i][j] = source.indexes_[i][j];
+            nearest_[i][j] = source.nearest_[i][j];
         }
     }
+    cellCount_ = source.cellCount_;
+    distances_ = source.distances_;
     return *this;
 }
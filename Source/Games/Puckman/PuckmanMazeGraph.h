@@ -42,7 +42,8 @@ namespace Puckman {
         // Types
         //--------------------------------------------------------------------------------
 
-        typedef std::vector<MovingDirectionEnum> MovingDirections;
+        /** The set of directions, with a bit for each one of them. */
+        typedef unsigned char DirectionMask;
 
         /** This structure represents a node in the graph. */
         struct Node {
@@ -54,8 +55,8 @@ namespace Puckman {
             int X;
             /** The y coordinate of the intersection. */
             int Y;
-            /** The list of directions of the node. */
-            MovingDirections Dirs;
+            /** The set of directions of the node. */
+            DirectionMask Dirs;
 
             /** Constructs a new structure. */
             Node(int row = 0, int col = 0);
@@ -67,9 +68,8 @@ namespace Puckman {
         // Methods
         //--------------------------------------------------------------------------------
 
-        MovingDirections GetDirections(int row, int col);
-        MovingDirections GetDirections(const sf::Vector2i & orig,
-            const sf::Vector2i & dest);
+        DirectionMask GetDirections(int row, int col);
+        static DirectionMask GetDirectionFlag(MovingDirectionEnum dir);
         sf::Vector2i GetNextPoint(const sf::Vector2i & orig, MovingDirectionEnum dir);
         MovingDirectionEnum GetOppositeDirection(MovingDirectionEnum dir);
         MovingDirectionEnum GetDirection(MovingEntity & entity, const sf::Vector2i & dest);
@@ -102,36 +102,49 @@ namespace Puckman {
         // This is the number of columns in each row of the graph.
         static const int COLS[];
 
+        // This is the number of directions in a direction mask.
+        static const int DIRECTIONS = 4;
+
         // This is the not found node.
         static const Node NOT_FOUND;
 
-        //--------------------------------------------------------------------------------
-        // Types
-        //--------------------------------------------------------------------------------
+        // This is the number of cells in the maze.
+        static const int CELLS = Maze::ROWS * Maze::COLUMS;
 
-        /** This structure represents a row node. */
-        struct RowNode {
-            /** The row of the node. */
-            int Row;
-            /** The y coordinate of the intersection. */
-            int Y;
-            /** The list of columns of the node. */
-            std::vector<Node> Cols;
+        // This is the index of a cell that isn't inside the paths table.
+        static const int NO_INDEX = -1;
 
-            /** Constructs a new structure. */
-            RowNode() : Row(0), Y(0), Cols() {}
-        };
+        // This is the distance between two cells without any path between them.
+        static const unsigned char UNREACHABLE = 0xFF;
 
         //--------------------------------------------------------------------------------
         // Fields
         //--------------------------------------------------------------------------------
 
-        // The list of rows in the graph.
-        std::vector<RowNode> rows_;
+        // The list of nodes in the graph.
+        std::vector<Node> nodes_;
 
         // The map of the maze.
         bool map_[Maze::ROWS][Maze::COLUMS];
 
+        // The set of directions of each cell of the maze.
+        DirectionMask masks_[Maze::ROWS][Maze::COLUMS];
+
+        // The index of the node of each cell of the maze.
+        int nodeIndexes_[Maze::ROWS][Maze::COLUMS];
+
+        // The index of each walkable cell inside the paths table.
+        int indexes_[Maze::ROWS][Maze::COLUMS];
+
+        // The nearest cell of the corridors for each cell of the maze.
+        int nearest_[Maze::ROWS][Maze::COLUMS];
+
+        // The number of walkable cells inside the paths table.
+        int cellCount_;
+
+        // The shortest distances between every pair of walkable cells.
+        std::vector<unsigned char> distances_;
+
         // Used to call the random number generator.
         CoreManager * core_;
 
@@ -140,22 +153,21 @@ namespace Puckman {
         //--------------------------------------------------------------------------------
 
         void resetMap();
-        void setMapValue(int row, int col, bool value);
+        void buildMasks();
+        void buildPaths();
         bool getMapValue(int row, int col);
-        void lockCell(const sf::Vector2i & cell);
-        void unlockCell(const sf::Vector2i & cell);
+        int getCellIndex(const sf::Vector2i & cell);
+        int getTargetIndex(const sf::Vector2i & cell);
+        int getPathDistance(int orig, int dest);
         int getDistance(const sf::Vector2i & orig, const sf::Vector2i & dest);
-        bool findDirectPath(const sf::Vector2i & orig, const sf::Vector2i & dest,
-            MovingDirectionEnum lastDir, int max);
-        MovingDirections eraseDirection(const MovingDirections & dirs,
-            MovingDirectionEnum dir);
-        MovingDirectionEnum getRandomDirection(MovingEntity & entity,
-            const MovingDirections & dirs);
-        MovingDirectionEnum getRandomDirection(const MovingDirections & dirs);
-        MovingDirectionEnum checkDirectionInList(const MovingDirections & dirs,
+        int countDirections(DirectionMask dirs);
+        MovingDirectionEnum getDirection(DirectionMask dirs, int index);
+        MovingDirectionEnum getRandomDirection(MovingEntity & entity, DirectionMask dirs);
+        MovingDirectionEnum getRandomDirection(DirectionMask dirs);
+        MovingDirectionEnum checkDirectionInMask(DirectionMask dirs,
             MovingDirectionEnum dir);
         MovingDirectionEnum getDirectDirection(const sf::Vector2i & orig,
-            const sf::Vector2i & dest, const MovingDirections & dirs);
+            const sf::Vector2i & dest, DirectionMask dirs);
     };
 }
 
@@ -0,0 +1,94 @@
+/******************************************************************************
+ Copyright (c) 2014 Gorka Surez Garca
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ DEALINGS IN THE SOFTWARE.
+******************************************************************************/
+
+#include "PuzzleBenchmark.h"
+#include <cstdio>
+#include <cstdlib>
+#include <SFML/System/Clock.hpp>
+#include <Games/Puzzle/Solver/Generator.h>
+
+//********************************************************************************
+// Constants
+//********************************************************************************
+
+const std::string LEVELS_OPTION = "-puzzle-levels";
+
+//********************************************************************************
+// Methods (Public)
+//********************************************************************************
+
+bool PuzzleBenchmark::Execute(int argc, char ** argv, int & result) {
+    // Find the benchmark option in the command line arguments.
+    std::vector<std::string> args(argv, argv + argc);
+    result = EXIT_SUCCESS;
+    if (args.size() > 1 && args[1] == LEVELS_OPTION) {
+        int failures = Levels(getArgument(args, 2, DEFAULT_LEVELS_RANGE),
+            getArgument(args, 3, DEFAULT_LEVELS_LENGTH),
+            getArgument(args, 4, DEFAULT_LEVELS_COUNT));
+        result = failures > 0 ? EXIT_FAILURE : EXIT_SUCCESS;
+        return true;
+    }
+    return false;
+}
+
+//--------------------------------------------------------------------------------
+
+int PuzzleBenchmark::Levels(int range, int length, int count) {
+    // Generate a pack of levels with the same length of the shortest solution, and
+    // write each level with its tiles from the top-left cell.
+    NPuzzle::PatternDatabase database;
+    database.Load("");
+    unsigned int seed = static_cast<unsigned int>(range * 1000 + length);
+    NPuzzle::Generator generator(seed, &database);
+
+    std::vector<NPuzzle::Puzzle> levels;
+    sf::Clock clock;
+    int added = generator.GetLevels(range, length, count, levels);
+    auto time = clock.getElapsedTime().asMicroseconds();
+
+    for (size_t i = 0; i < levels.size(); ++i) {
+        std::string tiles;
+        auto data = levels[i].GetData();
+        for (size_t j = 0; j < data.size(); ++j) {
+            if (j > 0) tiles += ",";
+            tiles += std::to_string(static_cast<long long>(data[j]));
+        }
+        std::printf("level=%d range=%d length=%d tiles=%s\n", static_cast<int>(i),
+            range, length, tiles.c_str());
+    }
+    std::printf("benchmark=levels range=%d length=%d count=%d time=%.3f rate=%.0f\n",
+        range, length, added, time / 1000.0, time > 0 ? added * 1000000.0 / time : 0.0);
+    std::fflush(stdout);
+    return added < count ? 1 : 0;
+}
+
+//********************************************************************************
+// Methods (Private)
+//********************************************************************************
+
+int PuzzleBenchmark::getArgument(const std::vector<std::string> & args, int index, int defval) {
+    if (index < static_cast<int>(args.size())) {
+        int value = std::atoi(args[index].c_str());
+        if (value > 0) return value;
+    }
+    return defval;
+}
@@ -20,44 +20,45 @@
  DEALINGS IN THE SOFTWARE.
 ******************************************************************************/
 
-#ifndef __NPUZZLE_POINT_H__
-#define __NPUZZLE_POINT_H__
-
-namespace NPuzzle {
-    /**
-     * This structure represents a point inside a puzzle.
-     */
-    struct Point {
-        //----------------------------------------------------------------------------
-        // Fields
-        //----------------------------------------------------------------------------
-
-        unsigned int i, j;
-
-        //----------------------------------------------------------------------------
-        // Constructors, destructor and operators
-        //----------------------------------------------------------------------------
-
-        Point() : i(0), j(0) {}
-        Point(unsigned int a, unsigned int b) : i(a), j(b) {}
-
-        bool operator== (const Point & rhs) const {
-            return i == rhs.i && j == rhs.j;
-        }
-
-        bool operator!= (const Point & rhs) const {
-            return i != rhs.i || j != rhs.j;
-        }
-
-        //----------------------------------------------------------------------------
-        // Methods
-        //----------------------------------------------------------------------------
-
-        Point GetUpPoint() const { return Point(i - 1, j); }
-        Point GetDownPoint() const { return Point(i + 1, j); }
-        Point GetLeftPoint() const { return Point(i, j - 1); }
-        Point GetRightPoint() const { return Point(i, j + 1); }
-    };
-}
-
-#endif
\ No newline at end of file
+#ifndef __PUZZLE_BENCHMARK_HEADER__
+#define __PUZZLE_BENCHMARK_HEADER__
+
+#include <string>
+#include <vector>
+
+/**
+ * This static class contains the benchmarks of the puzzle logic, that are executed
+ * from the command line without the user interface. Each result is written as a
+ * line of "name=value" fields in the standard output.
+ */
+class PuzzleBenchmark {
+private:
+    PuzzleBenchmark() {}
+    ~PuzzleBenchmark() {}
+
+public:
+    //--------------------------------------------------------------------------------
+    // Constants
+    //--------------------------------------------------------------------------------
+
+    static const int DEFAULT_LEVELS_RANGE  = 4;
+    static const int DEFAULT_LEVELS_LENGTH = 40;
+    static const int DEFAULT_LEVELS_COUNT  = 1000;
+
+    //--------------------------------------------------------------------------------
+    // Methods
+    //--------------------------------------------------------------------------------
+
+    static bool Execute(int argc, char ** argv, int & result);
+
+    static int Levels(int range, int length, int count);
+
+private:
+    //--------------------------------------------------------------------------------
+    // Methods
+    //--------------------------------------------------------------------------------
+
+    static int getArgument(const std::vector<std::string> & args, int index, int defval);
+};
+
+#endif
@@ -22,6 +22,7 @@
 
 #include "PuzzleManager.h"
 #include <vector>
+#include <memory>
 #include <SFML/Graphics/Texture.hpp>
 #include <SFML/Graphics/Image.hpp>
 #include <SFML/System/Time.hpp>
@@ -30,11 +31,14 @@
 #include <System/Texture2D.h>
 #include <System/Sound.h>
 #include <System/Mouse.h>
+#include <System/Keyboard.h>
 #include <System/MathUtil.h>
+#include <System/ThinkService.h>
 #include <Menu/DesktopState.h>
 #include <Games/Puzzle/PuzzleGameState.h>
 #include <Games/Puzzle/Solver/Generator.h>
 #include <Games/Puzzle/Solver/Solver.h>
+#include <Games/Puzzle/Solver/PatternDatabase.h>
 
 //********************************************************************************
 // Defines
@@ -43,9 +47,9 @@
 #define INITIAL_STATE 0
 #define PLAYING_STATE 1
 
-#define MAX_PIECES 16
+#define MAX_PIECES NPuzzle::Puzzle::MAX_CELLS
 
-#define SIDE_LENGTH NPuzzle::Puzzle::RANGE
+#define SOLVER_MOVE_DELAY 150
 
 //********************************************************************************
 // InnerData
@@ -58,7 +62,9 @@ struct PuzzleManager::InnerData {
     Texture2D puzzleTextures[MAX_PIECES];
 
     int gameState;
+    int range;
     NPuzzle::Puzzle board;
+    NPuzzle::Generator generator;
     sf::IntRect puzzleArea;
     sf::Vector2i pieceSizes;
 
@@ -66,15 +72,69 @@ struct PuzzleManager::InnerData {
     Sound clickSound;
     Sound winSound;
 
+    std::shared_ptr<NPuzzle::PatternDatabase> database;
+    std::shared_ptr<ThinkJob<NPuzzle::Solver::MoveVector>> solverTask;
+    NPuzzle::Solver::MoveVector solverMoves;
+    size_t solverIndex;
+    int solverTime;
+
+    bool Solving() const {
+        return solverTask || solverIndex < solverMoves.size();
+    }
+
+    void CancelSolver() {
+        if (solverTask) {
+            solverTask->Cancel();
+            solverTask = nullptr;
+        }
+        solverMoves.clear();
+        solverIndex = 0;
+        solverTime = 0;
+    }
+
     sf::Vector2i GetTableCoords() {
         auto & mouseCoords = CoreManager::Instance()->GetMousePosition();
         if (MathUtil::PointInside(mouseCoords, puzzleArea)) {
-            return sf::Vector2i(
+            auto coords = sf::Vector2i(
                 (mouseCoords.x - puzzleArea.left) / pieceSizes.x,
                 (mouseCoords.y - puzzleArea.top) / pieceSizes.y
             );
-        } else {
-            return sf::Vector2i(-1, -1);
+            if (coords.x < board.GetRange() && coords.y < board.GetRange()) {
+                return coords;
+            }
+        }
+        return sf::Vector2i(-1, -1);
+    }
+
+    void LoadPieces() {
+        // Set the size of the pieces with the side of the board.
+        int side = board.GetRange();
+        int w = puzzleTexture.Width() / side, h = puzzleTexture.Height() / side;
+        pieceSizes = sf::Vector2i(w, h);
+
+        // Setting the blank piece texture.
+        const auto BORDER_COLOR = AtariPalette::Hue00Lum00;
+
+        sf::Image blankImage;
+        blankImage.create(w, h, AtariPalette::Hue00Lum14);
+
+        for (int i = 0; i < w; ++i) {
+            blankImage.setPixel(i, 0, BORDER_COLOR);
+            blankImage.setPixel(i, h - 1, BORDER_COLOR);
+        }
+        for (int i = 0; i < h; ++i) {
+            blankImage.setPixel(0, i, BORDER_COLOR);
+            blankImage.setPixel(w - 1, i, BORDER_COLOR);
+        }
+
+        SharedTexture blankSurface = std::make_shared<sf::Texture>();
+        blankSurface->loadFromImage(blankImage);
+        puzzleTextures[0].Load(blankSurface);
+
+        // Setting the pieces textures.
+        for (int i = 1; i < board.GetSize(); ++i) {
+            auto area = sf::IntRect((i % side) * w, (i / side) * h, w, h);
+            puzzleTextures[i].Load(puzzleSurface, area);
         }
     }
 };
@@ -112,8 +172,6 @@ void PuzzleManager::Initialize() {
 
         // Set some initial data.
         int w = data_->puzzleTexture.Width(), h = data_->puzzleTexture.Height();
-        data_->pieceSizes = sf::Vector2i(w / SIDE_LENGTH, h / SIDE_LENGTH);
-
         data_->puzzleArea = sf::IntRect(
             (CoreManager::LOW_WIDTH - w) / 2,
             ((CoreManager::LOW_HEIGHT - 24 - h) / 2) + 24,
@@ -122,38 +180,11 @@ void PuzzleManager::Initialize() {
         );
 
         data_->gameState = INITIAL_STATE;
-        data_->board = NPuzzle::Puzzle();
-
-        // Setting the blank piece texture.
-        const auto BORDER_COLOR = AtariPalette::Hue00Lum00;
-        w = data_->pieceSizes.x, h = data_->pieceSizes.y;
-
-        sf::Image blankImage;
-        blankImage.create(w, h, AtariPalette::Hue00Lum14);
-
-        for (int i = 0; i < w; ++i) {
-            blankImage.setPixel(i, 0, BORDER_COLOR);
-            blankImage.setPixel(i, h - 1, BORDER_COLOR);
-        }
-        for (int i = 0; i < h; ++i) {
-            blankImage.setPixel(0, i, BORDER_COLOR);
-            blankImage.setPixel(w - 1, i, BORDER_COLOR);
-        }
-
-        SharedTexture blankSurface = std::make_shared<sf::Texture>();
-        blankSurface->loadFromImage(blankImage);
-        data_->puzzleTextures[0].Load(blankSurface);
-
-        // Setting the pieces textures.
-        int x = w, y = 0;
-        for (int i = 1; i < MAX_PIECES; ++i) {
-            auto area = sf::IntRect(x, y, w, h);
-            data_->puzzleTextures[i].Load(data_->puzzleSurface, area);
-            x += w;
-            if (x >= data_->puzzleArea.width) {
-                x = 0; y += h;
-            }
-        }
+        data_->range = NPuzzle::Puzzle::DEFAULT_RANGE;
+        data_->board = NPuzzle::Puzzle(data_->range);
+        data_->database = std::make_shared<NPuzzle::PatternDatabase>();
+        data_->CancelSolver();
+        data_->LoadPieces();
 
         // Load the sounds of the game.
         data_->keyboardSound.Load("Content/Sounds/SharedKey.wav");
@@ -172,6 +203,9 @@ void PuzzleManager::Initialize() {
  */
 void PuzzleManager::Release() {
     if (initialized_ && data_) {
+        // Stop the solver of the puzzle.
+        data_->CancelSolver();
+
         // Wait to the sound to end.
         data_->keyboardSound.WaitUntilStop();
         data_->clickSound.WaitUntilStop();
@@ -203,44 +237,56 @@ void PuzzleManager::Release() {
  */
 void PuzzleManager::StartGame() {
     data_->gameState = PLAYING_STATE;
+    data_->CancelSolver();
 
-    auto candidates = NPuzzle::GenerateRandomCandidate();
-    NPuzzle::Puzzle puzzle(candidates);
-    NPuzzle::Solver solver(puzzle);
-    if (solver.Solve()) {
-        data_->board = puzzle;
-    } else {
-        const auto EMPTY = NPuzzle::Puzzle::EMPTY;
-        if (candidates[0] != EMPTY && candidates[1] != EMPTY) {
-            std::swap(candidates[0], candidates[1]);
-        } else {
-            std::swap(candidates[2], candidates[3]);
-        }
-        data_->board = NPuzzle::Puzzle(candidates);
-    }
+    data_->board = data_->generator.GetRandom(data_->range);
+    data_->LoadPieces();
 
     CoreManager::Instance()->SetNextState(MakeSharedState<PuzzleGameState>());
 }
 
 //--------------------------------------------------------------------------------
 
+/**
+ * Solves the current game, showing the moves of the solution.
+ */
+void PuzzleManager::SolveGame() {
+    if (data_->gameState == PLAYING_STATE && !data_->Solving()) {
+        // Submit a copy of the board to search the solution in the background.
+        auto board = data_->board;
+        auto database = data_->database;
+        data_->solverTask = ThinkService::Instance()->Submit<NPuzzle::Solver::MoveVector>(
+            [board, database] (const ThinkTask & task) -> NPuzzle::Solver::MoveVector {
+                // The first job loads the tables, and the next ones wait for it.
+                database->Load("");
+                NPuzzle::Solver solver(board, database.get());
+                if (solver.Solve(&task)) {
+                    return solver.GetMoves();
+                } else {
+                    return NPuzzle::Solver::MoveVector();
+                }
+            }
+        );
+    }
+}
+
+//--------------------------------------------------------------------------------
+
 /**
  * Draws the game.
  */
 void PuzzleManager::DrawGame() {
     if (data_->gameState == PLAYING_STATE) {
-        int limit = data_->puzzleArea.left + data_->puzzleArea.width;
-        int x = data_->puzzleArea.left, y = data_->puzzleArea.top;
-        for (int i = 0; i < SIDE_LENGTH; ++i) {
-            for (int j = 0; j < SIDE_LENGTH; ++j) {
+        int side = data_->board.GetRange();
+        int y = data_->puzzleArea.top;
+        for (int i = 0; i < side; ++i) {
+            int x = data_->puzzleArea.left;
+            for (int j = 0; j < side; ++j) {
                 auto index = data_->board.GetData(i, j);
                 data_->puzzleTextures[index].Draw(x, y);
                 x += data_->pieceSizes.x;
-                if (x >= limit) {
-                    x = data_->puzzleArea.left;
-                    y += data_->pieceSizes.y;
-                }
             }
+            y += data_->pieceSizes.y;
         }
     } else {
         data_->puzzleTexture.Draw(data_->puzzleArea.left, data_->puzzleArea.top);
@@ -253,7 +299,42 @@ void PuzzleManager::DrawGame() {
  * Updates the game.
  */
 void PuzzleManager::UpdateGame(const sf::Time & timeDelta) {
-    if (data_->gameState == PLAYING_STATE) {
+    // The number keys start a new game with another side of the board.
+    const Keyboard::Key SIDE_KEYS[] = {
+        Keyboard::Num3, Keyboard::Num4, Keyboard::Num5, Keyboard::Num6
+    };
+    for (int i = 0; i < 4; ++i) {
+        if (Keyboard::IsKeyUp(SIDE_KEYS[i])) {
+            data_->range = NPuzzle::Puzzle::MIN_RANGE + i;
+            StartGame();
+            return;
+        }
+    }
+
+    if (data_->gameState == PLAYING_STATE && data_->Solving()) {
+        if (data_->solverTask) {
+            // Wait for the solver to find the moves.
+            if (data_->solverTask->Finished()) {
+                data_->solverMoves = data_->solverTask->Result();
+                data_->solverTask = nullptr;
+                data_->solverIndex = 0;
+                data_->solverTime = 0;
+            }
+        } else {
+            // Show the next move of the solution.
+            data_->solverTime += timeDelta.asMilliseconds();
+            if (data_->solverTime >= SOLVER_MOVE_DELAY) {
+                data_->solverTime = 0;
+                auto move = data_->solverMoves[data_->solverIndex++];
+                NPuzzle::Solver::MakeMove(data_->board, move);
+                if (data_->board.Solved()) {
+                    data_->CancelSolver();
+                    data_->gameState = INITIAL_STATE;
+                    WinSound().Play();
+                }
+            }
+        }
+    } else if (data_->gameState == PLAYING_STATE) {
         auto coords = data_->GetTableCoords();
         if (coords.x != -1 && coords.y != -1 && Mouse::IsButtonUp(Mouse::Left)) {
             const auto EMPTY = NPuzzle::Puzzle::EMPTY;
@@ -56,6 +56,7 @@ public:
 
     // Game
     void StartGame();
+    void SolveGame();
     void DrawGame();
     void UpdateGame(const sf::Time & timeDelta);
 
@@ -25,7 +25,6 @@
 #include <System/CoreManager.h>
 #include <System/AtariPalette.h>
 #include <System/Sound.h>
-#include <System/Texture2D.h>
 #include <System/SimpleLabel.h>
 #include <System/TexturedButton.h>
 #include <Games/Puzzle/PuzzleManager.h>
@@ -45,10 +44,6 @@ void PuzzleSharedState::Initialize() {
     auto * manager = PuzzleManager::Instance();
     auto & tileset = manager->Tileset();
 
-    barPosition_ = sf::Vector2i(480, 0);
-    barTexture_.reset(new Texture2D());
-    barTexture_->Load(tileset, sf::IntRect(0, 137, 160, 24));
-
     newGameLabel_.reset(new SimpleLabel("New Game", 8, 6,
         AtariPalette::Hue00Lum00, core->Retro70Font()));
 
@@ -58,10 +53,14 @@ void PuzzleSharedState::Initialize() {
     exitLabel_.reset(new SimpleLabel("Exit", 328, 6,
         AtariPalette::Hue00Lum00, core->Retro70Font()));
 
+    solveLabel_.reset(new SimpleLabel("Solve", 488, 6,
+        AtariPalette::Hue00Lum00, core->Retro70Font()));
+
     if (language == TEXT_LANGUAGE_SPANISH) {
         newGameLabel_->Text("Nueva Partida");
         aboutLabel_->Text("Sobre...");
         exitLabel_->Text("Salir");
+        solveLabel_->Text("Resolver");
     }
 
     newGameButton_.reset(new TexturedButton());
@@ -90,18 +89,28 @@ void PuzzleSharedState::Initialize() {
         manager->ClickSound().Play();
         core->SetNextState(MakeSharedState<PuzzleExitState>());
     });
+
+    solveButton_.reset(new TexturedButton());
+    solveButton_->Initialize(480, 0, tileset,
+        sf::IntRect(0, 65, 160, 24), sf::IntRect(0, 89, 160, 24),
+        sf::IntRect(0, 113, 160, 24));
+    solveButton_->OnClick([manager] (TexturedButton &) {
+        manager->ClickSound().Play();
+        manager->SolveGame();
+    });
 }
 
 //--------------------------------------------------------------------------------
 
 void PuzzleSharedState::Release() {
-    barTexture_.reset(nullptr);
     newGameLabel_.reset(nullptr);
     aboutLabel_.reset(nullptr);
     exitLabel_.reset(nullptr);
+    solveLabel_.reset(nullptr);
     newGameButton_.reset(nullptr);
     aboutButton_.reset(nullptr);
     exitButton_.reset(nullptr);
+    solveButton_.reset(nullptr);
 }
 
 //--------------------------------------------------------------------------------
@@ -110,12 +119,12 @@ void PuzzleSharedState::Draw(const sf::Time & timeDelta) {
     newGameButton_->Draw();
     aboutButton_->Draw();
     exitButton_->Draw();
+    solveButton_->Draw();
 
     newGameLabel_->Draw();
     aboutLabel_->Draw();
     exitLabel_->Draw();
-
-    barTexture_->Draw(barPosition_);
+    solveLabel_->Draw();
 }
 
 //--------------------------------------------------------------------------------
@@ -124,6 +133,7 @@ void PuzzleSharedState::Update(const sf::Time & timeDelta) {
     newGameButton_->Update();
     aboutButton_->Update();
     exitButton_->Update();
+    solveButton_->Update();
 }
 
 //********************************************************************************
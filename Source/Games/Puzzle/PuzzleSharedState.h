@@ -26,7 +26,6 @@
 #include <SFML/Graphics/Rect.hpp>
 #include <System/AbstractState.h>
 
-class Texture2D;
 class SimpleLabel;
 class TexturedButton;
 
@@ -56,16 +55,15 @@ private:
     // Fields
     //--------------------------------------------------------------------------------
 
-    sf::Vector2i barPosition_;
-    std::unique_ptr<Texture2D> barTexture_;
-
     std::unique_ptr<SimpleLabel> newGameLabel_;
     std::unique_ptr<SimpleLabel> aboutLabel_;
     std::unique_ptr<SimpleLabel> exitLabel_;
+    std::unique_ptr<SimpleLabel> solveLabel_;
 
     std::unique_ptr<TexturedButton> newGameButton_;
     std::unique_ptr<TexturedButton> aboutButton_;
     std::unique_ptr<TexturedButton> exitButton_;
+    std::unique_ptr<TexturedButton> solveButton_;
 };
 
 #endif
@@ -21,37 +21,160 @@
 ******************************************************************************/
 
 #include "Generator.h"
-#include "Puzzle.h"
+#include "Solver.h"
 
-#include <random>
+#include <set>
 #include <ctime>
 
 namespace NPuzzle {
     //********************************************************************************
-    // Functions
+    // Constants
+    //********************************************************************************
+
+    const int MAX_MOVES = 4;
+
+    const int OPPOSITE_MOVES[] = {
+        Solver::MOVE_DOWN, Solver::MOVE_UP, Solver::MOVE_RIGHT, Solver::MOVE_LEFT
+    };
+
+    //********************************************************************************
+    // Constructors, destructor and operators
     //********************************************************************************
 
     /**
-     * Generates a random n-puzzle candidate.
+     * Constructs a new object.
      */
-    std::vector<int> GenerateRandomCandidate() {
-        const int MAX_ELEMS = Puzzle::RANGE * Puzzle::RANGE;
+    Generator::Generator(const PatternDatabase * database) :
+        _engine(static_cast<unsigned long>(time(NULL))), _database(database) {}
 
-        std::default_random_engine generator(static_cast<unsigned long>(time(NULL)));
-        std::uniform_int_distribution<int> distribution(0, MAX_ELEMS - 1);
+    //--------------------------------------------------------------------------------
 
-        std::vector<int> result;
-        std::vector<int> victims;
-        for(int i = 0; i < MAX_ELEMS; ++i) {
-            victims.push_back(i);
-        }
+    /**
+     * Constructs a new object, with a seed to get always the same puzzles.
+     */
+    Generator::Generator(unsigned int seed, const PatternDatabase * database) :
+        _engine(seed), _database(database) {}
+
+    //********************************************************************************
+    // Methods
+    //********************************************************************************
 
-        while(!victims.empty()) {
-            int i = distribution(generator) % victims.size();
-            result.push_back(victims[i]);
-            victims.erase(victims.begin() + i);
+    /**
+     * Gets a random puzzle. The tiles are shuffled and, when the permutation has the
+     * wrong parity, the first two tiles are swapped. That swap pairs each puzzle
+     * that can't be solved with one that can, so all of them are equally likely.
+     */
+    Puzzle Generator::GetRandom(int range) {
+        if(!Puzzle::IsValidRange(range)) range = Puzzle::DEFAULT_RANGE;
+        std::vector<int> data(range * range);
+        for(int i = 0, size = range * range; i < size; ++i) {
+            int j = getRandom(i + 1);
+            data[i] = data[j];
+            data[j] = i;
         }
 
+        Puzzle result(range, data);
+        if(!Solver::IsSolvable(result)) {
+            std::swap(data[result.GetCell(1)], data[result.GetCell(2)]);
+            result = Puzzle(range, data);
+        }
         return result;
     }
+
+    //--------------------------------------------------------------------------------
+
+    /**
+     * Gets a puzzle where the shortest solution has an exact number of moves. The
+     * walks from the goal that always increase the estimation prove the length
+     * without any search. When those walks get stuck, which happens with the
+     * longest solutions, random boards up to 4x4 are solved until one of them has
+     * the right length.
+     */
+    bool Generator::GetByLength(int range, int length, Puzzle & victim) {
+        if(!Puzzle::IsValidRange(range) || length < 0) return false;
+        for(int i = 0; i < MAX_WALKS; ++i) {
+            int budget = length * WALK_BUDGET;
+            victim = Puzzle(range);
+            if(walkUphill(victim, 0, length, Solver::NO_MOVE, budget)) return true;
+        }
+        if(range <= PatternDatabase::RANGE) {
+            for(int i = 0; i < MAX_SEARCHES; ++i) {
+                if(solveRandom(range, length, victim)) return true;
+            }
+        }
+        return false;
+    }
+
+    //--------------------------------------------------------------------------------
+
+    /**
+     * Gets a pack of different puzzles with the same length of the shortest solution,
+     * returning the number of puzzles added to the vector.
+     */
+    int Generator::GetLevels(int range, int length, int count,
+        std::vector<Puzzle> & victims) {
+        std::set<Puzzle::Key> keys;
+        Puzzle victim;
+        int added = 0;
+        for(int i = 0; added < count && i < count * 4; ++i) {
+            if(GetByLength(range, length, victim) && keys.insert(victim.GetKey()).second) {
+                victims.push_back(victim);
+                ++added;
+            }
+        }
+        return added;
+    }
+
+    //--------------------------------------------------------------------------------
+
+    /**
+     * Gets a random number between zero and a limit.
+     */
+    int Generator::getRandom(int limit) {
+        std::uniform_int_distribution<int> distribution(0, limit - 1);
+        return distribution(_engine);
+    }
+
+    //--------------------------------------------------------------------------------
+
+    /**
+     * Walks back from the goal, taking only the moves that increase the estimation.
+     * The estimation never exceeds the real distance, and the walk is a solution,
+     * so an estimation equal to the length of the walk is the shortest solution.
+     * The walk goes back when it gets stuck, until it spends its budget of nodes.
+     */
+    bool Generator::walkUphill(Puzzle & board, int step, int length, int previous,
+        int & budget) {
+        if(step == length) return true;
+        if(--budget < 0) return false;
+
+        int first = getRandom(MAX_MOVES);
+        for(int i = 0; i < MAX_MOVES; ++i) {
+            // The move that undoes the previous one never increases the estimation.
+            int move = (first + i) % MAX_MOVES;
+            if(previous != Solver::NO_MOVE && move == OPPOSITE_MOVES[previous]) continue;
+
+            Puzzle next(board);
+            if(Solver::MakeMove(next, move) &&
+                Solver::GetEstimation(next, _database) == step + 1 &&
+                walkUphill(next, step + 1, length, move, budget)) {
+                board = next;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    //--------------------------------------------------------------------------------
+
+    /**
+     * Gets a random puzzle and solves it, to check if the shortest solution has the
+     * wanted length. The estimation discards the puzzles that are too far.
+     */
+    bool Generator::solveRandom(int range, int length, Puzzle & victim) {
+        victim = GetRandom(range);
+        if(Solver::GetEstimation(victim, _database) > length) return false;
+        Solver solver(victim, _database);
+        return solver.Solve() && static_cast<int>(solver.GetMoves().size()) == length;
+    }
 }
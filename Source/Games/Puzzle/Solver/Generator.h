@@ -24,11 +24,59 @@
 #define __NPUZZLE_GENERATOR_H__
 
 #include <vector>
+#include <random>
+#include "Puzzle.h"
+#include "PatternDatabase.h"
 
 namespace NPuzzle {
+    /**
+     * This class represents a generator of puzzles. The puzzles are always solvable,
+     * and they can be generated with an exact length of the shortest solution, to
+     * make levels of a given difficulty.
+     */
+    class Generator {
+    public:
+        //----------------------------------------------------------------------------
+        // Constants
+        //----------------------------------------------------------------------------
 
-    std::vector<int> GenerateRandomCandidate();
+        static const int MAX_WALKS = 16;
+        static const int WALK_BUDGET = 16;
+        static const int MAX_SEARCHES = 16;
 
+        //----------------------------------------------------------------------------
+        // Constructors, destructor and operators
+        //----------------------------------------------------------------------------
+
+        Generator(const PatternDatabase * database = nullptr);
+        Generator(unsigned int seed, const PatternDatabase * database = nullptr);
+
+        //----------------------------------------------------------------------------
+        // Methods
+        //----------------------------------------------------------------------------
+
+        Puzzle GetRandom(int range);
+        bool GetByLength(int range, int length, Puzzle & victim);
+        int GetLevels(int range, int length, int count, std::vector<Puzzle> & victims);
+
+        void SetDatabase(const PatternDatabase * database) { _database = database; }
+
+    private:
+        //----------------------------------------------------------------------------
+        // Fields
+        //----------------------------------------------------------------------------
+
+        std::mt19937 _engine;
+        const PatternDatabase * _database;
+
+        //----------------------------------------------------------------------------
+        // Methods
+        //----------------------------------------------------------------------------
+
+        int getRandom(int limit);
+        bool walkUphill(Puzzle & board, int step, int length, int previous, int & budget);
+        bool solveRandom(int range, int length, Puzzle & victim);
+    };
 }
 
 #endif
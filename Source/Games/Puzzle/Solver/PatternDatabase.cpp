@@ -0,0 +1,251 @@
+/******************************************************************************
+ Copyright (c) 2014 Gorka Surez Garca
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ DEALINGS IN THE SOFTWARE.
+******************************************************************************/
+
+#include "PatternDatabase.h"
+#include <fstream>
+#include <cstring>
+#include <SFML/System/Lock.hpp>
+
+namespace NPuzzle {
+    //********************************************************************************
+    // Constants
+    //********************************************************************************
+
+    const int RANGE = PatternDatabase::RANGE;
+    const int MAX_CELLS = PatternDatabase::MAX_TILES;
+    const int MAX_PATTERN_TILES = 6;
+
+    const unsigned char UNKNOWN_VALUE = 0xFF;
+
+    const size_t HEADER_SIZE = 4;
+    const char HEADER_MAGIC[] = "NPD";
+
+    /**
+     * The tiles of each pattern. The goal cell of a tile is the cell with its same
+     * index, and the empty cell is the first one. The tiles of a pattern are close
+     * to each other in the goal, so their moves interact more.
+     */
+    struct Pattern {
+        const char * name;
+        int size;
+        int tiles[MAX_PATTERN_TILES];
+    };
+
+    const Pattern PATTERNS[PatternDatabase::MAX_PATTERNS] = {
+        { "Left",   6, {  1,  4,  5,  8,  9, 12 } },
+        { "Right",  6, {  2,  3,  6,  7, 10, 11 } },
+        { "Bottom", 3, { 13, 14, 15,  0,  0,  0 } }
+    };
+
+    //********************************************************************************
+    // Static
+    //********************************************************************************
+
+    int PatternDatabase::_tilePatterns[MAX_TILES] = {
+        -1, 0, 1, 1, 0, 0, 1, 1, 0, 0, 1, 1, 0, 2, 2, 2
+    };
+
+    int PatternDatabase::_tileShifts[MAX_TILES] = {
+        0, 0, 0, 4, 4, 8, 8, 12, 12, 16, 16, 20, 20, 0, 4, 8
+    };
+
+    //********************************************************************************
+    // Util functions
+    //********************************************************************************
+
+    /**
+     * Gets the size of the table of a pattern.
+     */
+    static size_t GetTableSize(int pattern) {
+        return static_cast<size_t>(1) << (PATTERNS[pattern].size * PatternDatabase::CELL_BITS);
+    }
+
+    /**
+     * Gets the cells connected to a cell through the free cells of the board. The
+     * cells are bits of a mask, so the neighbors of all the cells are found with a
+     * few shifts at the same time.
+     */
+    static int GetConnectedCells(int cell, int occupied) {
+        const int ALL_CELLS  = (1 << MAX_CELLS) - 1;
+        const int FIRST_COLS = 0x7777, LAST_COLS = 0xEEEE;
+        int free = ~occupied & ALL_CELLS, result = 1 << cell, previous = 0;
+        while(result != previous) {
+            previous = result;
+            result |= ((result << RANGE) | (result >> RANGE) |
+                ((result << 1) & LAST_COLS) | ((result >> 1) & FIRST_COLS)) & free;
+        }
+        return result;
+    }
+
+    //********************************************************************************
+    // Constructors, destructor and operators
+    //********************************************************************************
+
+    /**
+     * Constructs a new object.
+     */
+    PatternDatabase::PatternDatabase() {
+        for(int i = 0; i < MAX_PATTERNS; ++i) {
+            _tables[i].data = nullptr;
+            _tables[i].size = 0;
+        }
+    }
+
+    //--------------------------------------------------------------------------------
+
+    /**
+     * The destructor of the object.
+     */
+    PatternDatabase::~PatternDatabase() {}
+
+    //********************************************************************************
+    // Methods
+    //********************************************************************************
+
+    /**
+     * Checks if all the databases are loaded.
+     */
+    bool PatternDatabase::IsLoaded() const {
+        sf::Lock lock(_mutex);
+        return isLoaded();
+    }
+
+    //--------------------------------------------------------------------------------
+
+    /**
+     * Loads the databases from a directory, generating the missing ones. Only one
+     * thread can load the tables at the same time, and the others will wait for it.
+     */
+    bool PatternDatabase::Load(const std::string & directory) {
+        sf::Lock lock(_mutex);
+        for(int i = 0; i < MAX_PATTERNS; ++i) {
+            auto & table = _tables[i];
+            if(table.data != nullptr) continue;
+
+            // Map the file of the table when it was generated before.
+            auto path = directory + "Puzzle" + PATTERNS[i].name + ".bin";
+            char header[HEADER_SIZE] = { HEADER_MAGIC[0], HEADER_MAGIC[1], HEADER_MAGIC[2],
+                static_cast<char>('0' + i) };
+            table.size = GetTableSize(i);
+            if(table.file.Open(path) && table.file.Size() == HEADER_SIZE + table.size &&
+                std::memcmp(table.file.Data(), header, HEADER_SIZE) == 0) {
+                table.data = reinterpret_cast<const unsigned char *>(table.file.Data() + HEADER_SIZE);
+                continue;
+            }
+            table.file.Close();
+
+            // Otherwise generate the table and save it for the next time.
+            generate(i, table.memory);
+            std::ofstream output(path.c_str(), std::ios::out | std::ios::trunc | std::ios::binary);
+            if(output.is_open()) {
+                output.write(header, HEADER_SIZE);
+                output.write(reinterpret_cast<const char *>(&table.memory[0]), table.size);
+                output.close();
+            }
+            if(table.file.Open(path) && table.file.Size() == HEADER_SIZE + table.size) {
+                table.data = reinterpret_cast<const unsigned char *>(table.file.Data() + HEADER_SIZE);
+                Buffer().swap(table.memory);
+            } else {
+                table.file.Close();
+                table.data = &table.memory[0];
+            }
+        }
+        return isLoaded();
+    }
+
+    //--------------------------------------------------------------------------------
+
+    /**
+     * Checks if all the databases are loaded, without locking the object.
+     */
+    bool PatternDatabase::isLoaded() const {
+        for(int i = 0; i < MAX_PATTERNS; ++i) {
+            if(_tables[i].data == nullptr) return false;
+        }
+        return true;
+    }
+
+    //--------------------------------------------------------------------------------
+
+    /**
+     * Generates the table of a pattern with a breadth-first search from the goal.
+     * Only the moves of the tiles of the pattern are counted, so the empty cell
+     * moves for free through the connected free cells, and a state is a placement
+     * of the tiles with one of those groups of free cells.
+     */
+    void PatternDatabase::generate(int pattern, Buffer & victim) {
+        const auto & tiles = PATTERNS[pattern];
+        const unsigned int CELL_MASK = (1 << CELL_BITS) - 1;
+
+        // The visited groups of each placement are stored as masks of cells.
+        victim.assign(GetTableSize(pattern), UNKNOWN_VALUE);
+        std::vector<unsigned short> visited(victim.size(), 0);
+
+        auto getOccupied = [&] (unsigned int index) -> int {
+            int result = 0;
+            for(int i = 0; i < tiles.size; ++i) {
+                result |= 1 << ((index >> (i * CELL_BITS)) & CELL_MASK);
+            }
+            return result;
+        };
+
+        // The states are stored with the index of the placement and the empty cell.
+        unsigned int goal = 0;
+        for(int i = 0; i < tiles.size; ++i) {
+            goal |= tiles.tiles[i] << (i * CELL_BITS);
+        }
+        std::vector<unsigned int> current, next;
+        current.push_back(goal << CELL_BITS);
+        visited[goal] = static_cast<unsigned short>(GetConnectedCells(0, getOccupied(goal)));
+        victim[goal] = 0;
+
+        for(unsigned char depth = 1; !current.empty(); ++depth) {
+            next.clear();
+            for(size_t k = 0; k < current.size(); ++k) {
+                unsigned int index = current[k] >> CELL_BITS;
+                int occupied = getOccupied(index);
+                int free = GetConnectedCells(current[k] & CELL_MASK, occupied);
+
+                // Move each tile next to the free cells into one of them.
+                for(int i = 0; i < tiles.size; ++i) {
+                    int cell = (index >> (i * CELL_BITS)) & CELL_MASK;
+                    int row = cell / RANGE, col = cell % RANGE;
+                    int targets[4] = {
+                        row > 0 ? cell - RANGE : -1, row < RANGE - 1 ? cell + RANGE : -1,
+                        col > 0 ? cell - 1 : -1, col < RANGE - 1 ? cell + 1 : -1
+                    };
+                    for(int j = 0; j < 4; ++j) {
+                        if(targets[j] < 0 || !(free & (1 << targets[j]))) continue;
+                        unsigned int moved = (index & ~(CELL_MASK << (i * CELL_BITS))) |
+                            (targets[j] << (i * CELL_BITS));
+                        if(visited[moved] & (1 << cell)) continue;
+                        visited[moved] |= static_cast<unsigned short>(
+                            GetConnectedCells(cell, getOccupied(moved)));
+                        if(victim[moved] == UNKNOWN_VALUE) victim[moved] = depth;
+                        next.push_back((moved << CELL_BITS) | cell);
+                    }
+                }
+            }
+            current.swap(next);
+        }
+    }
+}
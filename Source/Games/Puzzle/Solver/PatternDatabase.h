@@ -0,0 +1,115 @@
+/******************************************************************************
+ Copyright (c) 2014 Gorka Surez Garca
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ DEALINGS IN THE SOFTWARE.
+******************************************************************************/
+
+#ifndef __NPUZZLE_PATTERN_DATABASE_H__
+#define __NPUZZLE_PATTERN_DATABASE_H__
+
+#include <string>
+#include <vector>
+#include <SFML/System/Mutex.hpp>
+#include <System/MappedFile.h>
+
+namespace NPuzzle {
+    /**
+     * This class represents the additive pattern databases of the puzzle. The tiles
+     * are split in three disjoint patterns of 6, 6 and 3 tiles, and each database
+     * stores the moves of its tiles needed to reach the goal from every placement,
+     * so the sum of the three values never overestimates the real distance. The
+     * databases are generated the first time, then they are saved and mapped.
+     */
+    class PatternDatabase {
+    public:
+        //----------------------------------------------------------------------------
+        // Constants
+        //----------------------------------------------------------------------------
+
+        static const int RANGE = 4;
+        static const int MAX_PATTERNS = 3;
+        static const int MAX_TILES = RANGE * RANGE;
+        static const int CELL_BITS = 4;
+
+        //----------------------------------------------------------------------------
+        // Constructors, destructor and operators
+        //----------------------------------------------------------------------------
+
+        PatternDatabase();
+        ~PatternDatabase();
+
+        //----------------------------------------------------------------------------
+        // Methods
+        //----------------------------------------------------------------------------
+
+        bool IsLoaded() const;
+        bool Load(const std::string & directory);
+
+        /**
+         * Gets the pattern of a tile, or -1 with the empty cell.
+         */
+        static int GetPattern(int tile) { return _tilePatterns[tile]; }
+
+        /**
+         * Gets the shift of the cell of a tile inside the index of its pattern.
+         */
+        static int GetShift(int tile) { return _tileShifts[tile]; }
+
+        /**
+         * Gets the moves of a pattern, where each cell of the index is the cell of
+         * a tile of the pattern.
+         */
+        int GetValue(int pattern, unsigned int index) const {
+            return _tables[pattern].data[index];
+        }
+
+    private:
+        //----------------------------------------------------------------------------
+        // Types
+        //----------------------------------------------------------------------------
+
+        typedef std::vector<unsigned char> Buffer;
+
+        struct Table {
+            MappedFile file;
+            Buffer memory;
+            const unsigned char * data;
+            size_t size;
+        };
+
+        //----------------------------------------------------------------------------
+        // Fields
+        //----------------------------------------------------------------------------
+
+        Table _tables[MAX_PATTERNS];
+        mutable sf::Mutex _mutex;
+
+        static int _tilePatterns[MAX_TILES];
+        static int _tileShifts[MAX_TILES];
+
+        //----------------------------------------------------------------------------
+        // Methods
+        //----------------------------------------------------------------------------
+
+        bool isLoaded() const;
+        static void generate(int pattern, Buffer & victim);
+    };
+}
+
+#endif
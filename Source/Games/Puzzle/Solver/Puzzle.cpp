@@ -21,8 +21,44 @@
 ******************************************************************************/
 
 #include "Puzzle.h"
+#include <algorithm>
 
 namespace NPuzzle {
+    //********************************************************************************
+    // Tables
+    //********************************************************************************
+
+    /**
+     * This structure contains the keys of the goals of the packed boards, and the
+     * zobrist keys of the tiles inside the cells of the bigger boards.
+     */
+    struct PuzzleKeys {
+        Puzzle::Key goals[Puzzle::PACKED_RANGE + 1];
+        Puzzle::Key tiles[Puzzle::MAX_CELLS][Puzzle::MAX_CELLS];
+
+        PuzzleKeys() {
+            for(int range = 0; range <= Puzzle::PACKED_RANGE; ++range) {
+                goals[range] = 0;
+                for(int tile = 0; tile < range * range; ++tile) {
+                    goals[range] |= static_cast<Puzzle::Key>(tile) << (tile << 2);
+                }
+            }
+            // The keys are always the same, using a fixed seed with a xorshift.
+            Puzzle::Key seed = 0x9E3779B97F4A7C15ULL;
+            for(int cell = 0; cell < Puzzle::MAX_CELLS; ++cell) {
+                tiles[cell][Puzzle::EMPTY] = 0;
+                for(int tile = 1; tile < Puzzle::MAX_CELLS; ++tile) {
+                    seed ^= seed << 13;
+                    seed ^= seed >> 7;
+                    seed ^= seed << 17;
+                    tiles[cell][tile] = seed;
+                }
+            }
+        }
+    };
+
+    const PuzzleKeys KEYS;
+
     //********************************************************************************
     // Constructors, destructor and operators
     //********************************************************************************
@@ -30,37 +66,30 @@ namespace NPuzzle {
     /**
      * Constructs a new object.
      */
-    Puzzle::Puzzle() {
-        defaultInit();
+    Puzzle::Puzzle(int range) {
+        defaultInit(IsValidRange(range) ? range : DEFAULT_RANGE);
     }
 
     //--------------------------------------------------------------------------------
 
     /**
-     * Constructs a new object.
+     * Constructs a new object, taking the side of the board from the size of the data.
      */
     Puzzle::Puzzle(const std::vector<int> & data) {
-        auto begin = data.begin();
-        auto end = data.end();
-        int k = 0;
-        for(int i = 0; i < RANGE; ++i) {
-            for(int j = 0; j < RANGE; ++j) {
-                if(begin != end) {
-                    _table[i][j] = *begin;
-                    ++begin;
-                    if(_table[i][j] == EMPTY) {
-                        _emptyI = i;
-                        _emptyJ = j;
-                    }
-                } else {
-                    _table[i][j] = EMPTY;
-                    _emptyI = i;
-                    _emptyJ = j;
-                    ++k;
-                }
-            }
+        int range = MIN_RANGE;
+        while(range < MAX_RANGE && range * range < static_cast<int>(data.size())) {
+            ++range;
         }
-        if(k > 1) defaultInit();
+        dataInit(range, data);
+    }
+
+    //--------------------------------------------------------------------------------
+
+    /**
+     * Constructs a new object.
+     */
+    Puzzle::Puzzle(int range, const std::vector<int> & data) {
+        dataInit(range, data);
     }
 
     //--------------------------------------------------------------------------------
@@ -78,13 +107,10 @@ namespace NPuzzle {
      * The assign operator of the object.
      */
     Puzzle & Puzzle::operator=(const Puzzle & rhs) {
-        for(int i = 0; i < RANGE; ++i) {
-            for(int j = 0; j < RANGE; ++j) {
-                _table[i][j] = rhs._table[i][j];
-            }
-        }
-        _emptyI = rhs._emptyI;
-        _emptyJ = rhs._emptyJ;
+        _range = rhs._range;
+        _key = rhs._key;
+        std::copy(rhs._cells, rhs._cells + MAX_CELLS, _cells);
+        std::copy(rhs._positions, rhs._positions + MAX_CELLS, _positions);
         return *this;
     }
 
@@ -94,13 +120,13 @@ namespace NPuzzle {
      * The equality operator of the object.
      */
     bool Puzzle::operator==(const Puzzle & rhs) const {
-        for(int i = 0; i < RANGE; ++i) {
-            for(int j = 0; j < RANGE; ++j) {
-                if(_table[i][j] != rhs._table[i][j])
-                    return false;
-            }
+        if(_range != rhs._range || _key != rhs._key) {
+            return false;
+        } else if(_range <= PACKED_RANGE) {
+            return true;
+        } else {
+            return std::equal(_cells, _cells + GetSize(), rhs._cells);
         }
-        return true;
     }
 
     //********************************************************************************
@@ -111,18 +137,15 @@ namespace NPuzzle {
      * Checks if the puzzle is solved or not.
      */
     bool Puzzle::Solved() const {
-        const auto MAX_VICTIM = RANGE * RANGE;
-        int victim = EMPTY;
-        for(int i = 0; i < RANGE; ++i) {
-            for(int j = 0; j < RANGE; ++j) {
-                if(_table[i][j] != victim) {
+        if(_range <= PACKED_RANGE) {
+            return _key == KEYS.goals[_range];
+        } else {
+            for(int i = 0, size = GetSize(); i < size; ++i) {
+                if(_positions[i] != i)
                     return false;
-                } else {
-                    victim = (victim + 1) % MAX_VICTIM;
-                }
             }
+            return true;
         }
-        return true;
     }
 
     //--------------------------------------------------------------------------------
@@ -131,13 +154,7 @@ namespace NPuzzle {
      * Moves up the empty cell.
      */
     bool Puzzle::MoveUp() {
-        if(_emptyI > 0) {
-            auto nextI = _emptyI - 1;
-            std::swap(_table[nextI][_emptyJ], _table[_emptyI][_emptyJ]);
-            _emptyI = nextI;
-            return true;
-        }
-        return false;
+        return GetEmptyI() > 0 && MoveTile(GetEmptyCell() - _range);
     }
 
     //--------------------------------------------------------------------------------
@@ -146,13 +163,7 @@ namespace NPuzzle {
      * Moves down the empty cell.
      */
     bool Puzzle::MoveDown() {
-        if(_emptyI < LAST_INDEX) {
-            auto nextI = _emptyI + 1;
-            std::swap(_table[nextI][_emptyJ], _table[_emptyI][_emptyJ]);
-            _emptyI = nextI;
-            return true;
-        }
-        return false;
+        return GetEmptyI() < _range - 1 && MoveTile(GetEmptyCell() + _range);
     }
 
     //--------------------------------------------------------------------------------
@@ -161,13 +172,7 @@ namespace NPuzzle {
      * Moves left the empty cell.
      */
     bool Puzzle::MoveLeft() {
-        if(_emptyJ > 0) {
-            auto nextJ = _emptyJ - 1;
-            std::swap(_table[_emptyI][nextJ], _table[_emptyI][_emptyJ]);
-            _emptyJ = nextJ;
-            return true;
-        }
-        return false;
+        return GetEmptyJ() > 0 && MoveTile(GetEmptyCell() - 1);
     }
 
     //--------------------------------------------------------------------------------
@@ -176,13 +181,22 @@ namespace NPuzzle {
      * Moves right the empty cell.
      */
     bool Puzzle::MoveRight() {
-        if(_emptyJ < LAST_INDEX) {
-            auto nextJ = _emptyJ + 1;
-            std::swap(_table[_emptyI][nextJ], _table[_emptyI][_emptyJ]);
-            _emptyJ = nextJ;
-            return true;
-        }
-        return false;
+        return GetEmptyJ() < _range - 1 && MoveTile(GetEmptyCell() + 1);
+    }
+
+    //--------------------------------------------------------------------------------
+
+    /**
+     * Moves the tile of a cell next to the empty cell into the empty cell.
+     */
+    bool Puzzle::MoveTile(int cell) {
+        int emptyCell = _positions[EMPTY];
+        if(cell < 0 || cell >= GetSize()) return false;
+        int rows = cell / _range - emptyCell / _range;
+        int cols = cell % _range - emptyCell % _range;
+        if((rows < 0 ? -rows : rows) + (cols < 0 ? -cols : cols) != 1) return false;
+        moveEmpty(cell);
+        return true;
     }
 
     //--------------------------------------------------------------------------------
@@ -192,10 +206,8 @@ namespace NPuzzle {
      */
     std::vector<int> Puzzle::GetData() const {
         std::vector<int> result;
-        for(int i = 0; i < RANGE; ++i) {
-            for(int j = 0; j < RANGE; ++j) {
-                result.push_back(_table[i][j]);
-            }
+        for(int i = 0, size = GetSize(); i < size; ++i) {
+            result.push_back(GetTile(i));
         }
         return result;
     }
@@ -206,7 +218,17 @@ namespace NPuzzle {
      * Gets a cell of the puzzle.
      */
     int Puzzle::GetData(unsigned int i, unsigned int j) const {
-        return (i < RANGE && j < RANGE) ? _table[i][j] : -1;
+        const unsigned int RANGE = static_cast<unsigned int>(_range);
+        return (i < RANGE && j < RANGE) ? GetTile(i * RANGE + j) : -1;
+    }
+
+    //--------------------------------------------------------------------------------
+
+    /**
+     * Checks if a side of the board is supported.
+     */
+    bool Puzzle::IsValidRange(int range) {
+        return MIN_RANGE <= range && range <= MAX_RANGE;
     }
 
     //--------------------------------------------------------------------------------
@@ -214,15 +236,71 @@ namespace NPuzzle {
     /**
      * Initializes the puzzle with the default data.
      */
-    void Puzzle::defaultInit() {
-        const auto MAX_VICTIM = RANGE * RANGE;
-        int victim = EMPTY;
-        for(int i = 0; i < RANGE; ++i) {
-            for(int j = 0; j < RANGE; ++j) {
-                _table[i][j] = victim;
-                victim = (victim + 1) % MAX_VICTIM;
-            }
+    void Puzzle::defaultInit(int range) {
+        _range = range;
+        _key = 0;
+        std::fill(_cells, _cells + MAX_CELLS, EMPTY);
+        for(int i = 0, size = GetSize(); i < size; ++i) {
+            setTile(i, i);
+        }
+    }
+
+    //--------------------------------------------------------------------------------
+
+    /**
+     * Initializes the puzzle with some data, or with the default data when the data
+     * isn't a permutation of the tiles.
+     */
+    void Puzzle::dataInit(int range, const std::vector<int> & data) {
+        if(!IsValidRange(range)) range = DEFAULT_RANGE;
+        defaultInit(range);
+
+        int size = GetSize();
+        bool found[MAX_CELLS] = { false };
+        if(static_cast<int>(data.size()) != size) return;
+        for(int i = 0; i < size; ++i) {
+            if(data[i] < 0 || data[i] >= size || found[data[i]]) return;
+            found[data[i]] = true;
+        }
+        for(int i = 0; i < size; ++i) {
+            setTile(i, data[i]);
+        }
+    }
+
+    //--------------------------------------------------------------------------------
+
+    /**
+     * Sets the tile of a cell.
+     */
+    void Puzzle::setTile(int cell, int tile) {
+        if(_range <= PACKED_RANGE) {
+            int shift = cell << 2;
+            _key = (_key & ~(static_cast<Key>(0xF) << shift)) | (static_cast<Key>(tile) << shift);
+        } else {
+            _key ^= KEYS.tiles[cell][_cells[cell]] ^ KEYS.tiles[cell][tile];
+            _cells[cell] = static_cast<unsigned char>(tile);
+        }
+        _positions[tile] = static_cast<unsigned char>(cell);
+    }
+
+    //--------------------------------------------------------------------------------
+
+    /**
+     * Moves the empty cell to a cell next to it, without any check.
+     */
+    void Puzzle::moveEmpty(int cell) {
+        int emptyCell = _positions[EMPTY];
+        int tile = GetTile(cell);
+        if(_range <= PACKED_RANGE) {
+            // The nibble of the empty cell is zero, so the tile is only added.
+            _key += static_cast<Key>(tile) << (emptyCell << 2);
+            _key -= static_cast<Key>(tile) << (cell << 2);
+        } else {
+            _key ^= KEYS.tiles[cell][tile] ^ KEYS.tiles[emptyCell][tile];
+            _cells[emptyCell] = static_cast<unsigned char>(tile);
+            _cells[cell] = EMPTY;
         }
-        _emptyI = _emptyJ = RANGE - 1;
+        _positions[tile] = static_cast<unsigned char>(emptyCell);
+        _positions[EMPTY] = static_cast<unsigned char>(cell);
     }
 }
@@ -27,24 +27,40 @@
 
 namespace NPuzzle {
     /**
-     * This class represents a puzzle.
+     * This class represents a puzzle. The side of the board is chosen at runtime,
+     * and the goal has the empty cell first and the tiles in order. The boards up
+     * to 4x4 are packed in the key with a nibble for each cell, the bigger ones are
+     * stored in an array of cells with a zobrist key. The cell of each tile is kept
+     * too, so the moves and the key are updated without any scan of the board.
      */
     class Puzzle {
     public:
+        friend class Solver;
+
+        //----------------------------------------------------------------------------
+        // Types
+        //----------------------------------------------------------------------------
+
+        typedef unsigned long long Key;
+
         //----------------------------------------------------------------------------
         // Constants
         //----------------------------------------------------------------------------
 
         static const int EMPTY = 0;
-        static const int RANGE = 4;
-        static const int LAST_INDEX = RANGE - 1;
+        static const int MIN_RANGE = 3;
+        static const int MAX_RANGE = 6;
+        static const int DEFAULT_RANGE = 4;
+        static const int PACKED_RANGE = 4;
+        static const int MAX_CELLS = MAX_RANGE * MAX_RANGE;
 
         //----------------------------------------------------------------------------
         // Constructors, destructor and operators
         //----------------------------------------------------------------------------
 
-        Puzzle();
+        explicit Puzzle(int range = DEFAULT_RANGE);
         Puzzle(const std::vector<int> & data);
+        Puzzle(int range, const std::vector<int> & data);
         Puzzle(const Puzzle & rhs);
 
         Puzzle & operator=(const Puzzle & rhs);
@@ -60,26 +76,55 @@ namespace NPuzzle {
         bool MoveDown();
         bool MoveLeft();
         bool MoveRight();
+        bool MoveTile(int cell);
 
         std::vector<int> GetData() const;
         int GetData(unsigned int i, unsigned int j) const;
 
-        int GetEmptyI() const { return _emptyI; }
-        int GetEmptyJ() const { return _emptyJ; }
+        int GetRange() const { return _range; }
+        int GetSize() const { return _range * _range; }
+        Key GetKey() const { return _key; }
+
+        int GetEmptyCell() const { return _positions[EMPTY]; }
+        int GetEmptyI() const { return _positions[EMPTY] / _range; }
+        int GetEmptyJ() const { return _positions[EMPTY] % _range; }
+
+        /**
+         * Gets the tile inside a cell.
+         */
+        int GetTile(int cell) const {
+            if(_range <= PACKED_RANGE) {
+                return static_cast<int>((_key >> (cell << 2)) & 0xF);
+            } else {
+                return _cells[cell];
+            }
+        }
+
+        /**
+         * Gets the cell of a tile.
+         */
+        int GetCell(int tile) const { return _positions[tile]; }
+
+        static bool IsValidRange(int range);
 
     private:
         //----------------------------------------------------------------------------
         // Fields
         //----------------------------------------------------------------------------
 
-        int _table[RANGE][RANGE];
-        int _emptyI, _emptyJ;
+        int _range;
+        Key _key;
+        unsigned char _cells[MAX_CELLS];
+        unsigned char _positions[MAX_CELLS];
 
         //----------------------------------------------------------------------------
         // Methods
         //----------------------------------------------------------------------------
 
-        void defaultInit();
+        void defaultInit(int range);
+        void dataInit(int range, const std::vector<int> & data);
+        void setTile(int cell, int tile);
+        void moveEmpty(int cell);
     };
 }
 
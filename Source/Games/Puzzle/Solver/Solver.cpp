@@ -21,660 +21,384 @@
 ******************************************************************************/
 
 #include "Solver.h"
+#include <algorithm>
 
 namespace NPuzzle {
     //********************************************************************************
-    // .
+    // Constants
     //********************************************************************************
 
-    /**
-     * Constructs a new object.
-     */
-    Solver::Solver(const Puzzle & data) : _start(data) {
-    }
+    const int OPPOSITE_MOVES[] = {
+        Solver::MOVE_DOWN, Solver::MOVE_UP, Solver::MOVE_RIGHT, Solver::MOVE_LEFT
+    };
 
-    //********************************************************************************
-    // .
-    //********************************************************************************
+    const int MAX_BOUND = 1 << 20;
 
-    /**
-     * Checks if the puzzle can be solved or not.
-     */
-    bool Solver::Solve() {
-        reset();
-        solveDownSide();
-        return solveUpSide();
-    }
+    // The weight of the estimation when the board is solved by parts, that finds
+    // longer solutions but needs far less nodes.
+    const int PARTIAL_WEIGHT = 4;
 
-    //--------------------------------------------------------------------------------
+    // The think task is checked after this number of nodes.
+    const long long CHECK_MASK = (1 << 14) - 1;
+
+    //********************************************************************************
+    // Constructors, destructor and operators
+    //********************************************************************************
 
     /**
-     * Resets the internal table.
+     * Constructs a new object.
      */
-    void Solver::reset() {
-        _table.Reset(_start);
+    Solver::Solver(const Puzzle & data, const PatternDatabase * database) : _start(data),
+        _board(data), _range(data.GetRange()), _database(database), _task(nullptr),
+        _patterns(false), _partial(false), _manhattan(0), _linearConflicts(0), _nodes(0) {
+        if(_database != nullptr && !_database->IsLoaded()) {
+            _database = nullptr;
+        }
+        _patterns = _database != nullptr && _range == PatternDatabase::RANGE;
     }
 
-    //--------------------------------------------------------------------------------
+    //********************************************************************************
+    // Methods
+    //********************************************************************************
 
     /**
-     * Solves the down side of the puzzle.
+     * Finds a sequence of moves to solve the puzzle, that is the shortest one with
+     * the boards up to 4x4.
      */
-    void Solver::solveDownSide() {
-        const int START = RANGE * RANGE - 1; // 15
-        const int END = RANGE * 2 - 1; // 7
-        for(int victim = START; victim > END; --victim) {
-            Point victimPos = _table.FindValuePos(victim);
-            Point victimDest = findVictimDest(victim);
-
-            if(victimPos == victimDest) {
-                _table.data[victimPos.i][victimPos.j].blocked = true;
-            } else if(victimDest.j == 0) {
-                solveDownSideLeft(victim, victimPos, victimDest);
-            } else {
-                solveDownSideRight(victim, victimPos, victimDest);
-            }
+    bool Solver::Solve(const ThinkTask * task) {
+        _task = task;
+        _moves.clear();
+        _nodes = 0;
+        if(!IsSolvable(_start)) return false;
+
+        bool result;
+        _board = _start;
+        if(_range > OPTIMAL_RANGE) {
+            result = solveByParts();
+        } else {
+            _partial = false;
+            std::fill(_goals, _goals + MAX_CELLS, true);
+            setRegion(_range);
+            result = searchMoves();
         }
+        if(!result) _moves.clear();
+        return result;
     }
 
     //--------------------------------------------------------------------------------
 
     /**
-     * Solves the up side of the puzzle.
+     * Checks if a puzzle can be solved. Each move changes the parity of the tiles
+     * permutation and the parity of the distance of the empty cell to its goal, so
+     * both parities must be the same.
      */
-    bool Solver::solveUpSide() {
-        const int START = RANGE * 2 - 1; // 7
-        const int EXCLUDE = 4;
-
-        std::vector<int> candidates;
-        for(int v = RANGE - 1; v >= 0; --v) {
-            candidates.push_back(v + RANGE);
-            candidates.push_back(v);
-        }
-
-        int i = 0, len = candidates.size() - EXCLUDE;
-        for(; i < len; ++i) {
-            auto victim = candidates[i];
-
-            Point victimPos = _table.FindValuePos(victim);
-            Point victimDest = findVictimDest(victim);
-
-            if(victimPos == victimDest) {
-                _table.data[victimPos.i][victimPos.j].blocked = true;
-            } else {
-                if(victim < RANGE) {
-                    solveUpSideRight(victim, victimPos, victimDest);
-                } else {
-                    solveDownSideRight(victim, victimPos, victimDest);
+    bool Solver::IsSolvable(const Puzzle & data) {
+        bool visited[MAX_CELLS] = { false };
+        int cycles = 0, size = data.GetSize();
+        for(int i = 0; i < size; ++i) {
+            if(!visited[i]) {
+                ++cycles;
+                for(int j = i; !visited[j]; j = data.GetTile(j)) {
+                    visited[j] = true;
                 }
             }
         }
-
-        solveUpSideLeft(candidates[i]);
-        return isTableSolved();
+        int distance = data.GetEmptyI() + data.GetEmptyJ();
+        return (size - cycles) % 2 == distance % 2;
     }
 
     //--------------------------------------------------------------------------------
 
     /**
-     * Finds the destination of a victim value.
+     * Makes a move of the empty cell inside a puzzle.
      */
-    Point Solver::findVictimDest(int value) {
-        const int LIMIT = RANGE * RANGE;
-        return (0 <= value && value < LIMIT) ?
-            Point(value / RANGE, value % RANGE) :
-        Point(INVALID_COORD, INVALID_COORD);
-    }
-
-    //--------------------------------------------------------------------------------
-
-    /**
-     * Checks if the table is solved or not.
-     */
-    bool Solver::isTableSolved() {
-        for(int i = 0, k = 0; i < RANGE; ++i) {
-            for(int j = 0; j < RANGE; ++j, ++k) {
-                if(_table.data[i][j].value != k) return false;
-            }
+    bool Solver::MakeMove(Puzzle & victim, int move) {
+        switch(move) {
+        case MOVE_UP:    return victim.MoveUp();
+        case MOVE_DOWN:  return victim.MoveDown();
+        case MOVE_LEFT:  return victim.MoveLeft();
+        case MOVE_RIGHT: return victim.MoveRight();
         }
-        return true;
+        return false;
     }
 
     //--------------------------------------------------------------------------------
 
     /**
-     * Solves the up-left side of the puzzle.
+     * Gets the estimated number of moves to solve a puzzle, that is never bigger
+     * than the real number of moves.
      */
-    void Solver::solveUpSideLeft(int victim) {
-        Point victimPos = _table.FindValuePos(victim);
-        Point victimDest = findVictimDest(victim);
-        Point emptyPos = _table.FindValuePos(EMPTY);
-
-        auto move = [&](const Point & next) {
-            _table.ForceSwap(emptyPos, next);
-            emptyPos = next;
-        };
-
-        auto move2 = [&](const Point & next) {
-            _table.Block(victimPos);
-            longMove(emptyPos, next);
-            _table.Unblock(victimPos);
-            emptyPos = next;
-        };
-
-        if(victimPos == victimDest) {
-            // ..
-            // .V
-            move2(Point(0, 0));
-
-        } else if(victimPos.i == victimDest.i) {
-            move2(victimDest);
-
-            // ..
-            // VE
-            move(emptyPos.GetLeftPoint());
-            move(emptyPos.GetUpPoint());
-
-        } else if(victimPos.j == victimDest.j) {
-            move2(victimDest);
-
-            // .V
-            // .E
-            move(emptyPos.GetUpPoint());
-            move(emptyPos.GetLeftPoint());
-
-        } else {
-            move2(Point(victimDest.i - 1, victimDest.j));
-
-            // VE
-            // ..
-            move(emptyPos.GetLeftPoint());
-            move(emptyPos.GetDownPoint());
-            move(emptyPos.GetRightPoint());
-            move(emptyPos.GetUpPoint());
-            move(emptyPos.GetLeftPoint());
-        }
+    int Solver::GetEstimation(const Puzzle & data, const PatternDatabase * database) {
+        Solver solver(data, database);
+        std::fill(solver._goals, solver._goals + MAX_CELLS, true);
+        solver.reset();
+        return solver.getHeuristic();
     }
 
     //--------------------------------------------------------------------------------
 
     /**
-     * Solves the up-right side of the puzzle.
+     * Resets the values of the heuristic with the current board.
      */
-    void Solver::solveUpSideRight(int victim, Point & victimPos, const Point & victimDest) {
-        Point emptyPos = _table.FindValuePos(EMPTY), emptyDest;
-        auto move = [&]() {
-            _table.Block(victimPos);
-            longMove(emptyPos, emptyDest);
-            _table.Unblock(victimPos);
-
-            _table.Swap(victimPos, emptyDest);
-            emptyPos = victimPos;
-            victimPos = emptyDest;
-        };
-
-        auto move2 = [&]() {
-            _table.Block(victimPos);
-            longMove(emptyPos, emptyDest);
-            _table.Unblock(victimPos);
-            emptyPos = emptyDest;
-        };
-
-        if(victimPos.i == victimDest.i && victimPos.j + 1 == victimDest.j) {
-            if(emptyPos == victimDest) {
-                // VE
-                // .P
-                _table.Swap(victimPos, emptyPos);
-
-            } else {
-                emptyDest.i = victimPos.i + 1;
-                emptyDest.j = victimPos.j;
-                if(emptyPos != emptyDest) move2();
-
-                // V.
-                // EP
-                loopFinalMoveOnTheTopRight(emptyPos);
+    void Solver::reset() {
+        if(_patterns) {
+            for(int i = 0; i < PatternDatabase::MAX_PATTERNS; ++i) {
+                _indexes[i] = 0;
             }
-        } else {
-            if(victimPos.i == 0) {
-                emptyDest.i = victimPos.i;
-                emptyDest.j = victimPos.j + 1;
-                move();
-
-            } else {
-                emptyDest.i = victimPos.i - 1;
-                emptyDest.j = victimPos.j;
-                move();
-
-                if(victimPos.j < victimDest.j - 1) {
-                    loopMoveOnTheTopLeft(victimPos, emptyPos);
-                }
+            for(int tile = 1; tile < PatternDatabase::MAX_TILES; ++tile) {
+                int pattern = PatternDatabase::GetPattern(tile);
+                _indexes[pattern] |= _board.GetCell(tile) << PatternDatabase::GetShift(tile);
             }
-
-            // EV. -> Right
-            // ...
-            while(victimPos.j < victimDest.j - 1) {
-                loopMoveToRight(victimPos, emptyPos);
+            for(int i = 0; i < PatternDatabase::MAX_PATTERNS; ++i) {
+                _values[i] = _database->GetValue(i, _indexes[i]);
             }
-
-            emptyDest.i = victimPos.i + 1;
-            emptyDest.j = victimPos.j;
-            if(emptyPos != victimPos) {
-                move2();
+        } else {
+            _manhattan = 0;
+            for(int tile = 1; tile < _board.GetSize(); ++tile) {
+                if(_goals[tile]) _manhattan += getDistance(tile, _board.GetCell(tile));
+            }
+            _linearConflicts = 0;
+            for(int axis = 0; !_partial && axis < MAX_AXES; ++axis) {
+                for(int line = 0; line < _range; ++line) {
+                    _conflicts[axis][line] = getLineConflicts(axis, line);
+                    _linearConflicts += _conflicts[axis][line];
+                }
             }
-
-            // V.
-            // EP
-            loopFinalMoveOnTheTopRight(emptyPos);
         }
-
-        _table.Block(victimDest);
     }
 
     //--------------------------------------------------------------------------------
 
     /**
-     * Solves the down-left side of the puzzle.
+     * Checks if the think task was cancelled.
      */
-    void Solver::solveDownSideLeft(int victim, Point & victimPos, const Point & victimDest) {
-        Point emptyPos = _table.FindValuePos(EMPTY), emptyDest;
-        auto move = [&]() {
-            _table.Block(victimPos);
-            longMove(emptyPos, emptyDest);
-            _table.Unblock(victimPos);
-
-            _table.Swap(victimPos, emptyDest);
-            emptyPos = victimPos;
-            victimPos = emptyDest;
-        };
-
-        auto move2 = [&]() {
-            _table.Block(victimPos);
-            longMove(emptyPos, emptyDest);
-            _table.Unblock(victimPos);
-            emptyPos = emptyDest;
-        };
-
-        if (emptyPos == victimDest && victimPos.j == victimDest.j && victimPos.i + 1 == victimDest.i) {
-            // V.
-            // EP
-            _table.Swap(emptyPos, victimPos);
-
-        } else {
-            if (victimPos.j == victimDest.j && victimPos.i + 1 == victimDest.i) {
-                // V.
-                // .P
-                emptyDest = victimPos.GetUpPoint();
-                move();
-            }
-
-            emptyDest = victimDest;
-            longMove(emptyPos, emptyDest);
-            emptyPos = emptyDest;
-
-            Point prevDest = emptyPos.GetRightPoint();
-            _table.ForceSwap(emptyPos, prevDest);
-            emptyPos = prevDest;
-
-            if(victimPos.j > victimDest.j) {
-                emptyDest.i = victimPos.i;
-                emptyDest.j = victimPos.j - 1;
-                move();
-
-                // ....
-                // .VE. <- Left
-                // ....
-                while(victimPos.j > victimDest.j) {
-                    loopMoveToLeft(victimPos, emptyPos);
-                }
-            }
-
-            if(victimPos.i < victimDest.i - 1) {
-                emptyDest.i = victimPos.i + 1;
-                emptyDest.j = victimPos.j;
-                move();
-
-                while(victimPos.i < victimDest.i - 1) {
-                    loopMoveToDown(victimPos, emptyPos);
-                }
-            }
-
-            emptyDest = prevDest;
-            move2();
-
-            loopFinalMoveOnTheLeft(emptyPos);
-        }
-
-        _table.Block(victimDest);
+    bool Solver::cancelled() const {
+        return _task != nullptr && _task->Cancelled();
     }
 
     //--------------------------------------------------------------------------------
 
     /**
-     * Solves the down-right side of the puzzle.
+     * Solves the board by parts. The tiles of the last row and column are placed one
+     * by one, searching the moves that put each new tile in its goal cell without
+     * losing the previous ones, and the side of the board to solve becomes smaller.
+     * The empty cell ends in the top-left corner, so the last 4x4 region is solved
+     * as a smaller puzzle with the same moves.
      */
-    void Solver::solveDownSideRight(int victim, Point & victimPos, const Point & victimDest) {
-        Point emptyPos = _table.FindValuePos(EMPTY), emptyDest;
-        auto move = [&]() {
-            _table.Block(victimPos);
-            longMove(emptyPos, emptyDest);
-            _table.Unblock(victimPos);
-
-            _table.Swap(victimPos, emptyDest);
-            emptyPos = victimPos;
-            victimPos = emptyDest;
-        };
-
-        if(victimPos.j < victimDest.j) {
-            emptyDest.i = victimPos.i;
-            emptyDest.j = victimPos.j + 1;
-            move();
-
-            // ....
-            // .EV. -> Right
-            // ....
-            while(victimPos.j < victimDest.j) {
-                loopMoveToRight(victimPos, emptyPos);
-            }
-        } else if(victimPos.j > victimDest.j) {
-            emptyDest.i = victimPos.i;
-            emptyDest.j = victimPos.j - 1;
-            move();
-
-            // ....
-            // .VE. <- Left
-            // ....
-            while(victimPos.j > victimDest.j) {
-                loopMoveToLeft(victimPos, emptyPos);
+    bool Solver::solveByParts() {
+        _partial = true;
+        std::fill(_goals, _goals + MAX_CELLS, false);
+        for(int side = _range; side > OPTIMAL_RANGE; --side) {
+            setRegion(side);
+            for(int k = 0; k < side * 2 - 1; ++k) {
+                int row = k < side ? side - 1 : side * 2 - 2 - k;
+                int col = k < side ? k : side - 1;
+                _goals[row * _range + col] = true;
+                if(!searchMoves()) return false;
             }
         }
 
-        if(victimPos.i < victimDest.i) {
-            emptyDest.i = victimPos.i + 1;
-            emptyDest.j = victimPos.j;
-            move();
-
-            while(victimPos.i < victimDest.i) {
-                loopMoveToDown(victimPos, emptyPos);
+        std::vector<int> data;
+        for(int row = 0; row < OPTIMAL_RANGE; ++row) {
+            for(int col = 0; col < OPTIMAL_RANGE; ++col) {
+                int tile = _board.GetTile(row * _range + col);
+                data.push_back((tile / _range) * OPTIMAL_RANGE + tile % _range);
             }
         }
-
-        _table.Block(victimDest);
+        Solver solver(Puzzle(OPTIMAL_RANGE, data), _database);
+        bool result = solver.Solve(_task);
+        _moves.insert(_moves.end(), solver._moves.begin(), solver._moves.end());
+        _nodes += solver._nodes;
+        return result;
     }
 
     //--------------------------------------------------------------------------------
 
     /**
-     * Executes a loop move on the top left side of the puzzle.
+     * Searches the moves from the current board to put the goal tiles in their cells,
+     * that are the shortest ones unless the board is solved by parts. The solver
+     * makes depth-first searches with an increasing bound of the estimated length,
+     * so it only needs the memory of the current path.
      */
-    void Solver::loopMoveOnTheTopLeft(Point & victimPos, Point & emptyPos) {
-        Point pos = emptyPos;
-        auto move = [&](const Point & next) {
-            _table.ForceSwap(pos, next);
-            pos = next;
-        };
-
-        // .V.  .VX  .VE
-        // .EX  ..E  ...
-        move(pos.GetRightPoint());
-        move(pos.GetUpPoint());
-        move(pos.GetLeftPoint());
-
-        emptyPos = victimPos;
-        ++(victimPos.j);
+    bool Solver::searchMoves() {
+        reset();
+        int previous = _moves.empty() ? NO_MOVE : _moves.back();
+        int bound = getHeuristic();
+        while(!cancelled()) {
+            int result = search(0, bound, previous);
+            if(result == FOUND) return true;
+            bound = result;
+        }
+        return false;
     }
 
     //--------------------------------------------------------------------------------
 
     /**
-     * Executes a loop final move on the top right side of the puzzle.
+     * Searches the moves inside a bound, returning the next bound to check or the
+     * found flag. The moves of the current path are kept inside the moves vector.
      */
-    void Solver::loopFinalMoveOnTheTopRight(Point & emptyPos) {
-        Point pos = emptyPos;
-        auto move = [&](const Point & next) {
-            _table.ForceSwap(pos, next);
-            pos = next;
-        };
-
-        // .V.  XV.  EV.  VEX  V.E  V.P  VXP
-        // XEP  E.P  ..P  ..P  ..P  .XE  .E.
-        move(pos.GetLeftPoint());
-        move(pos.GetUpPoint());
-        move(pos.GetRightPoint());
-        move(pos.GetRightPoint());
-        move(pos.GetDownPoint());
-        move(pos.GetLeftPoint());
-        move(pos.GetUpPoint());
-
-        // VEP  EVP  .VP  .VP  .VP  .VE
-        // ...  X..  EX.  .EX  ..E  ..P
-        move(pos.GetLeftPoint());
-        move(pos.GetDownPoint());
-        move(pos.GetRightPoint());
-        move(pos.GetRightPoint());
-        move(pos.GetUpPoint());
-        move(pos.GetLeftPoint());
+    int Solver::search(int cost, int bound, int previous) {
+        ++_nodes;
+        int heuristic = getHeuristic();
+        int estimation = cost + (_partial ? heuristic * PARTIAL_WEIGHT : heuristic);
+        if(estimation > bound) return estimation;
+        if(heuristic == 0) return FOUND;
+        if((_nodes & CHECK_MASK) == 0 && cancelled()) return MAX_BOUND;
+
+        int minimum = MAX_BOUND;
+        for(int move = 0; move < MAX_MOVES; ++move) {
+            // The move that undoes the previous one is never useful.
+            if(previous != NO_MOVE && move == OPPOSITE_MOVES[previous]) continue;
+            int cell = _targets[_board.GetEmptyCell()][move];
+            if(cell < 0) continue;
+
+            int emptyCell = _board.GetEmptyCell();
+            moveTile(cell);
+            _moves.push_back(move);
+            int result = search(cost + 1, bound, move);
+            if(result == FOUND) return FOUND;
+            _moves.pop_back();
+            moveTile(emptyCell);
+
+            if(result < minimum) minimum = result;
+        }
+        return minimum;
     }
 
     //--------------------------------------------------------------------------------
 
     /**
-     * Executes a loop final move on the left side of the puzzle.
+     * Sets the top-left region of the board where the empty cell can move.
      */
-    void Solver::loopFinalMoveOnTheLeft(Point & emptyPos) {
-        Point pos = emptyPos;
-        auto move = [&](const Point & next) {
-            _table.ForceSwap(pos, next);
-            pos = next;
-        };
-
-        // V.  V.
-        // PE  EP
-        move(pos.GetLeftPoint());
-        move(pos.GetUpPoint());
+    void Solver::setRegion(int side) {
+        for(int cell = 0; cell < _start.GetSize(); ++cell) {
+            for(int move = 0; move < MAX_MOVES; ++move) {
+                int target = getTargetCell(cell, move);
+                if(target / _range >= side || target % _range >= side) target = -1;
+                _targets[cell][move] = target;
+            }
+        }
     }
 
     //--------------------------------------------------------------------------------
 
     /**
-     * Executes a loop move to the right.
+     * Gets the cell where the empty cell goes with a move, or -1 outside the board.
      */
-    void Solver::loopMoveToRight(Point & victimPos, Point & emptyPos) {
-        Point pos = emptyPos;
-        auto move = [&](const Point & next) {
-            _table.Swap(pos, next);
-            pos = next;
-        };
-
-        // .EV. | .X..
-        // .X.. | .EV.
-        if(victimPos.i == 0) {
-            move(pos.GetDownPoint());
-        } else {
-            move(pos.GetUpPoint());
-        }
-
-        // ..V. | .EX.
-        // .EX. | ..V.
-        move(pos.GetRightPoint());
-
-        // ..V. | ..EX
-        // ..EX | ..V.
-        move(pos.GetRightPoint());
-
-        // ..VX | ...E
-        // ...E | ..VX
-        if(victimPos.i == 0) {
-            move(pos.GetUpPoint());
-        } else {
-            move(pos.GetDownPoint());
+    int Solver::getTargetCell(int cell, int move) const {
+        int row = cell / _range, col = cell % _range;
+        switch(move) {
+        case MOVE_UP:    return row > 0 ? cell - _range : -1;
+        case MOVE_DOWN:  return row < _range - 1 ? cell + _range : -1;
+        case MOVE_LEFT:  return col > 0 ? cell - 1 : -1;
+        case MOVE_RIGHT: return col < _range - 1 ? cell + 1 : -1;
         }
-
-        // ..VE | ....
-        // .... | ..VE
-        move(pos.GetLeftPoint());
-
-        ++(victimPos.j);
-        ++(emptyPos.j);
+        return -1;
     }
 
     //--------------------------------------------------------------------------------
 
     /**
-     * Executes a loop move to the left.
+     * Moves the tile of a cell into the empty cell, updating the heuristic. A tile
+     * moved inside a row only changes the conflicts of the columns it leaves and
+     * enters, and a tile moved inside a column only changes the ones of the rows.
      */
-    void Solver::loopMoveToLeft(Point & victimPos, Point & emptyPos) {
-        Point pos = emptyPos;
-        auto move = [&](const Point & next) {
-            _table.Swap(pos, next);
-            pos = next;
-        };
-
-        // .VE. | ..X.
-        // ..X. | .VE.
-        if(victimPos.i == 0) {
-            move(pos.GetDownPoint());
-        } else {
-            move(pos.GetUpPoint());
-        }
-
-        // .V.. | .XE.
-        // .XE. | .V..
-        move(pos.GetLeftPoint());
-
-        // .V.. | XE..
-        // XE.. | .V..
-        move(pos.GetLeftPoint());
-
-        // XV.. | E...
-        // E... | XV..
-        if(victimPos.i == 0) {
-            move(pos.GetUpPoint());
+    void Solver::moveTile(int cell) {
+        int emptyCell = _board.GetEmptyCell();
+        int tile = _board.GetTile(cell);
+        _board.moveEmpty(cell);
+
+        if(_patterns) {
+            int pattern = PatternDatabase::GetPattern(tile);
+            int shift = PatternDatabase::GetShift(tile);
+            _indexes[pattern] = (_indexes[pattern] & ~(0xFU << shift)) | (emptyCell << shift);
+            _values[pattern] = _database->GetValue(pattern, _indexes[pattern]);
         } else {
-            move(pos.GetDownPoint());
+            if(_goals[tile]) {
+                _manhattan += getDistance(tile, emptyCell) - getDistance(tile, cell);
+            }
+            if(_partial) return;
+            if(cell / _range == emptyCell / _range) {
+                updateLineConflicts(1, cell % _range);
+                updateLineConflicts(1, emptyCell % _range);
+            } else {
+                updateLineConflicts(0, cell / _range);
+                updateLineConflicts(0, emptyCell / _range);
+            }
         }
-
-        // EV.. | ....
-        // .... | EV..
-        move(pos.GetRightPoint());
-
-        --(victimPos.j);
-        --(emptyPos.j);
     }
 
     //--------------------------------------------------------------------------------
 
     /**
-     * Executes a loop move to the bottom.
+     * Gets the estimated number of moves to solve the puzzle, that is never bigger
+     * than the real number of moves.
      */
-    void Solver::loopMoveToDown(Point & victimPos, Point & emptyPos) {
-        Point pos = emptyPos;
-        auto move = [&](const Point & next) {
-            _table.Swap(pos, next);
-            pos = next;
-        };
-
-        // XE  E.  ..  ..  ..
-        // .V  XV  EV  .V  .V
-        // ..  ..  X.  EX  .E
-
-        if(victimPos.j > 0) {
-            move(pos.GetLeftPoint());
-        } else {
-            move(pos.GetRightPoint());
-        }
-
-        move(pos.GetDownPoint());
-        move(pos.GetDownPoint());
-
-        if(victimPos.j > 0) {
-            move(pos.GetRightPoint());
+    int Solver::getHeuristic() const {
+        if(_patterns) {
+            int result = 0;
+            for(int i = 0; i < PatternDatabase::MAX_PATTERNS; ++i) {
+                result += _values[i];
+            }
+            return result;
         } else {
-            move(pos.GetLeftPoint());
+            return _manhattan + _linearConflicts;
         }
-
-        move(pos.GetUpPoint());
-
-        ++(victimPos.i);
-        ++(emptyPos.i);
     }
 
     //--------------------------------------------------------------------------------
 
     /**
-     * Executes a long move.
+     * Gets the distance of a tile inside a cell to its goal cell.
      */
-    void Solver::longMove(const Point & orig, const Point & dest) {
-        if(orig == dest) return;
-        _table.ClearVisited();
-        longMoveStep(orig, dest);
+    int Solver::getDistance(int tile, int cell) const {
+        int rows = cell / _range - tile / _range, cols = cell % _range - tile % _range;
+        return (rows < 0 ? -rows : rows) + (cols < 0 ? -cols : cols);
     }
 
     //--------------------------------------------------------------------------------
 
     /**
-     * Executes a step inside a long move.
+     * Gets the moves added by the tiles inside their goal row or column, but in the
+     * wrong order. The tiles out of the longest ordered sequence of a line need two
+     * more moves each to leave the line and come back.
      */
-    bool Solver::longMoveStep(const Point & orig, const Point & dest) {
-        if(orig == dest) return true;
-
-        std::vector<Point> candidates;
-        if(orig.i < dest.i) {
-            if(orig.j < dest.j) { // UP-LEFT
-                candidates.push_back(orig.GetDownPoint());
-                candidates.push_back(orig.GetRightPoint());
-                candidates.push_back(orig.GetLeftPoint());
-                candidates.push_back(orig.GetUpPoint());
-            } else { // UP-RIGHT
-                candidates.push_back(orig.GetDownPoint());
-                candidates.push_back(orig.GetLeftPoint());
-                candidates.push_back(orig.GetRightPoint());
-                candidates.push_back(orig.GetUpPoint());
-            }
-        } else if(orig.i > dest.i) {
-            if(orig.j < dest.j) { // DOWN-LEFT
-                candidates.push_back(orig.GetUpPoint());
-                candidates.push_back(orig.GetRightPoint());
-                candidates.push_back(orig.GetLeftPoint());
-                candidates.push_back(orig.GetDownPoint());
-            } else { // DOWN-RIGHT
-                candidates.push_back(orig.GetUpPoint());
-                candidates.push_back(orig.GetLeftPoint());
-                candidates.push_back(orig.GetRightPoint());
-                candidates.push_back(orig.GetDownPoint());
-            }
-        } else {
-            if(orig.j < dest.j) { // DOWN-LEFT
-                candidates.push_back(orig.GetRightPoint());
-                candidates.push_back(orig.GetUpPoint());
-                candidates.push_back(orig.GetDownPoint());
-                candidates.push_back(orig.GetLeftPoint());
-            } else if(orig.j > dest.j) { // DOWN-RIGHT
-                candidates.push_back(orig.GetLeftPoint());
-                candidates.push_back(orig.GetUpPoint());
-                candidates.push_back(orig.GetDownPoint());
-                candidates.push_back(orig.GetRightPoint());
+    int Solver::getLineConflicts(int axis, int line) const {
+        // Get the goal positions of the tiles that belong to the line.
+        int goals[MAX_RANGE], size = 0;
+        for(int k = 0; k < _range; ++k) {
+            int cell = axis == 0 ? line * _range + k : k * _range + line;
+            int tile = _board.GetTile(cell);
+            if(tile == EMPTY) continue;
+            if(axis == 0 && tile / _range == line) {
+                goals[size++] = tile % _range;
+            } else if(axis == 1 && tile % _range == line) {
+                goals[size++] = tile / _range;
             }
         }
-
-        _table.Visit(orig);
-
-        auto i = candidates.begin();
-        auto end = candidates.end();
-        for(; i != end; ++i) {
-            if(_table.IsBlocked(*i) == false && _table.IsVisited(*i) == false) {
-                _table.Swap(orig.i, orig.j, i->i, i->j);
-                bool result = longMoveStep(*i, dest);
-                if(!result) {
-                    _table.Swap(orig, *i);
-                } else {
-                    return true;
+        // Find the longest increasing sequence of the goal positions.
+        int lengths[MAX_RANGE], longest = 0;
+        for(int i = 0; i < size; ++i) {
+            lengths[i] = 1;
+            for(int j = 0; j < i; ++j) {
+                if(goals[j] < goals[i] && lengths[j] + 1 > lengths[i]) {
+                    lengths[i] = lengths[j] + 1;
                 }
             }
+            if(lengths[i] > longest) longest = lengths[i];
         }
+        return 2 * (size - longest);
+    }
 
-        _table.UnVisit(orig);
+    //--------------------------------------------------------------------------------
 
-        return false;
+    /**
+     * Updates the conflicts of a line after a move.
+     */
+    void Solver::updateLineConflicts(int axis, int line) {
+        int conflicts = getLineConflicts(axis, line);
+        _linearConflicts += conflicts - _conflicts[axis][line];
+        _conflicts[axis][line] = conflicts;
     }
 }
@@ -23,115 +23,112 @@
 #ifndef __NPUZZLE_SOLVER_H__
 #define __NPUZZLE_SOLVER_H__
 
-#include "Point.h"
+#include <vector>
+#include <System/ThinkService.h>
 #include "Puzzle.h"
+#include "PatternDatabase.h"
 
 namespace NPuzzle {
     /**
-     * This class represents a puzzle solver.
+     * This class represents a puzzle solver. It finds an optimal solution with the
+     * IDA* algorithm, using the pattern databases as heuristic with the 4x4 boards,
+     * or the manhattan distance with the linear conflicts in any other case. The
+     * bigger boards are solved by parts, placing the last row and column until the
+     * rest is a 4x4 board, so their solutions aren't always the shortest ones.
      */
     class Solver {
     public:
         //----------------------------------------------------------------------------
-        // Constructor
+        // Constants
         //----------------------------------------------------------------------------
 
-        Solver(const Puzzle & data);
+        static const int NO_MOVE    = -1;
+        static const int MOVE_UP    =  0;
+        static const int MOVE_DOWN  =  1;
+        static const int MOVE_LEFT  =  2;
+        static const int MOVE_RIGHT =  3;
 
         //----------------------------------------------------------------------------
-        // Methods
+        // Types
         //----------------------------------------------------------------------------
 
-        bool Solve();
+        typedef std::vector<int> MoveVector;
 
-    private:
         //----------------------------------------------------------------------------
-        // Constants
+        // Constructor
         //----------------------------------------------------------------------------
 
-        static const int EMPTY = Puzzle::EMPTY;
-        static const int RANGE = Puzzle::RANGE;
-        static const int LAST_INDEX = Puzzle::LAST_INDEX;
-
-        static const unsigned int INVALID_COORD = 0XFF;
+        Solver(const Puzzle & data, const PatternDatabase * database = nullptr);
 
         //----------------------------------------------------------------------------
-        // Types
+        // Methods
         //----------------------------------------------------------------------------
 
-        struct Cell {
-            int value;
-            bool blocked;
-
-            Cell() : value(0), blocked(false) {}
-            Cell(int v) : value(v), blocked(false) {}
-            Cell(int v, bool b) : value(v), blocked(b) {}
-        };
-
-        struct Table {
-            Cell data[RANGE][RANGE];
-            bool visited[RANGE][RANGE];
-
-            void Reset(const Puzzle & start);
+        bool Solve(const ThinkTask * task = nullptr);
 
-            Point FindValuePos(int value) const;
+        const MoveVector & GetMoves() const { return _moves; }
+        long long GetNodes() const { return _nodes; }
 
-            void Swap(unsigned int i1, unsigned int j1, unsigned int i2, unsigned int j2);
-            void ForceSwap(unsigned int i1, unsigned int j1, unsigned int i2, unsigned int j2);
+        static bool IsSolvable(const Puzzle & data);
+        static bool MakeMove(Puzzle & victim, int move);
+        static int GetEstimation(const Puzzle & data,
+            const PatternDatabase * database = nullptr);
 
-            void Swap(const Point & c1, const Point & c2) {
-                Swap(c1.i, c1.j, c2.i, c2.j);
-            }
-            void ForceSwap(const Point & c1, const Point & c2) {
-                ForceSwap(c1.i, c1.j, c2.i, c2.j);
-            }
+    private:
+        //----------------------------------------------------------------------------
+        // Constants
+        //----------------------------------------------------------------------------
 
-            void Block(const Point & coords);
-            void Unblock(const Point & coords);
-            bool IsBlocked(const Point & coords) const;
+        static const int EMPTY = Puzzle::EMPTY;
+        static const int MAX_RANGE = Puzzle::MAX_RANGE;
+        static const int MAX_CELLS = Puzzle::MAX_CELLS;
+        static const int MAX_MOVES = 4;
+        static const int MAX_AXES = 2;
+        static const int OPTIMAL_RANGE = PatternDatabase::RANGE;
 
-            void Visit(const Point & coords);
-            void UnVisit(const Point & coords);
-            bool IsVisited(const Point & coords) const;
-            void ClearVisited();
-        };
+        static const int FOUND = -1;
 
         //----------------------------------------------------------------------------
         // Fields
         //----------------------------------------------------------------------------
 
         Puzzle _start;
-        Table _table;
+        Puzzle _board;
+        int _range;
+        const PatternDatabase * _database;
+        const ThinkTask * _task;
+        bool _patterns;
+        bool _partial;
+
+        int _targets[MAX_CELLS][MAX_MOVES];
+        bool _goals[MAX_CELLS];
+        unsigned int _indexes[PatternDatabase::MAX_PATTERNS];
+        int _values[PatternDatabase::MAX_PATTERNS];
+        int _manhattan;
+        int _conflicts[MAX_AXES][MAX_RANGE];
+        int _linearConflicts;
+
+        MoveVector _moves;
+        long long _nodes;
 
         //----------------------------------------------------------------------------
         // Methods
         //----------------------------------------------------------------------------
 
         void reset();
-
-        void solveDownSide();
-        bool solveUpSide();
-
-        Point findVictimDest(int value);
-
-        bool isTableSolved();
-
-        void solveUpSideLeft(int victim);
-        void solveUpSideRight(int victim, Point & victimPos, const Point & victimDest);
-        void solveDownSideLeft(int victim, Point & victimPos, const Point & victimDest);
-        void solveDownSideRight(int victim, Point & victimPos, const Point & victimDest);
-
-        void loopMoveOnTheTopLeft(Point & victimPos, Point & emptyPos);
-        void loopFinalMoveOnTheTopRight(Point & emptyPos);
-        void loopFinalMoveOnTheLeft(Point & emptyPos);
-
-        void loopMoveToRight(Point & victimPos, Point & emptyPos);
-        void loopMoveToLeft(Point & victimPos, Point & emptyPos);
-        void loopMoveToDown(Point & victimPos, Point & emptyPos);
-
-        void longMove(const Point & orig, const Point & dest);
-        bool longMoveStep(const Point & orig, const Point & dest);
-
+        bool cancelled() const;
+
+        bool solveByParts();
+        bool searchMoves();
+        int search(int cost, int bound, int previous);
+        void setRegion(int side);
+        int getTargetCell(int cell, int move) const;
+        void moveTile(int cell);
+
+        int getHeuristic() const;
+        int getDistance(int tile, int cell) const;
+        int getLineConflicts(int axis, int line) const;
+        void updateLineConflicts(int axis, int line);
     };
 }
 
@@ -0,0 +1,212 @@
+/******************************************************************************
+ Copyright (c) 2014 Gorka Surez Garca
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ DEALINGS IN THE SOFTWARE.
+******************************************************************************/
+
+#include "ReversiBenchmark.h"
+#include <cstdio>
+#include <cstdlib>
+#include <SFML/System/Clock.hpp>
+
+//********************************************************************************
+// Constants
+//********************************************************************************
+
+const std::string SEARCH_OPTION = "-reversi-search";
+const std::string GAME_OPTION   = "-reversi-game";
+
+/**
+ * The standard openings, with the moves written like "f5d6". The first move is
+ * made by the side that has the turn after the pieces of the center.
+ */
+const char * OPENINGS[][2] = {
+    { "perpendicular", "f5d6"       },
+    { "parallel",      "f5f4"       },
+    { "diagonal",      "f5f6"       },
+    { "cow",           "f5d6c5"     },
+    { "tiger",         "f5d6c3d3c4" },
+    { "buffalo",       "f5f6e6f4c3" }
+};
+
+const int OPENINGS_COUNT = sizeof(OPENINGS) / sizeof(OPENINGS[0]);
+
+// The pieces of the center, placed like in the standard game with the side that
+// moves first on the squares of the black pieces.
+const int CENTER_CELLS = 4;
+
+const int CENTER_ROWS[CENTER_CELLS] = { 4, 3, 3, 4 };
+const int CENTER_COLS[CENTER_CELLS] = { 3, 3, 4, 4 };
+
+//********************************************************************************
+// Methods (Public)
+//********************************************************************************
+
+bool ReversiBenchmark::Execute(int argc, char ** argv, int & result) {
+    // Find the benchmark option in the command line arguments.
+    std::vector<std::string> args(argv, argv + argc);
+    result = EXIT_SUCCESS;
+    if (args.size() > 1 && args[1] == SEARCH_OPTION) {
+        int failures = Search(getArgument(args, 2, DEFAULT_SEARCH_DEPTH));
+        result = failures > 0 ? EXIT_FAILURE : EXIT_SUCCESS;
+        return true;
+    } else if (args.size() > 1 && args[1] == GAME_OPTION) {
+        int failures = Game(getArgument(args, 2, DEFAULT_GAME_DEPTH),
+            getArgument(args, 3, DEFAULT_GAME_MOVES));
+        result = failures > 0 ? EXIT_FAILURE : EXIT_SUCCESS;
+        return true;
+    }
+    return false;
+}
+
+//--------------------------------------------------------------------------------
+
+int ReversiBenchmark::Search(int maxDepth) {
+    // Search each opening with and without the transposition table, to compare the
+    // number of nodes and the time needed to reach each depth.
+    int failures = 0;
+    for (int i = 0; i < OPENINGS_COUNT; ++i) {
+        ReversiGameData game;
+        if (!loadOpening(game, OPENINGS[i][1])) {
+            std::printf("benchmark=error opening=%s\n", OPENINGS[i][0]);
+            ++failures;
+            continue;
+        }
+        for (int depth = 1; depth <= maxDepth; ++depth) {
+            long long nodes[2];
+            double times[2];
+            for (int table = 0; table < 2; ++table) {
+                ReversiMiniMax solver;
+                solver.UseTable(table != 0);
+                sf::Clock clock;
+                auto move = solver.Execute(game, depth, 0);
+                auto time = clock.getElapsedTime().asMicroseconds();
+                auto & stats = solver.Stats();
+                nodes[table] = stats.nodes;
+                times[table] = time / 1000.0;
+                std::printf("benchmark=search opening=%s table=%s depth=%d nodes=%lld "
+                    "time=%.3f nps=%.0f hits=%lld cutoffs=%lld move=%s\n",
+                    OPENINGS[i][0], table != 0 ? "yes" : "no", depth, stats.nodes,
+                    times[table], time > 0 ? stats.nodes * 1000000.0 / time : 0.0,
+                    stats.tableHits, stats.cutoffs, getMoveName(move).c_str());
+                std::fflush(stdout);
+            }
+            std::printf("benchmark=speedup opening=%s depth=%d nodes=%.2f time=%.2f\n",
+                OPENINGS[i][0], depth, nodes[1] > 0 ? nodes[0] / double(nodes[1]) : 0.0,
+                times[1] > 0.0 ? times[0] / times[1] : 0.0);
+            std::fflush(stdout);
+        }
+    }
+    return failures;
+}
+
+//--------------------------------------------------------------------------------
+
+int ReversiBenchmark::Game(int depth, int maxMoves) {
+    // Play the same moves from each opening without the table, with a new table in
+    // each move, and with a table kept between the moves like the game does. The
+    // moves are taken from the search without the table, so all the searches get
+    // the same positions.
+    const int MAX_MODES = 3;
+    const char * MODE_NAMES[MAX_MODES] = { "none", "new", "kept" };
+    int failures = 0;
+    for (int i = 0; i < OPENINGS_COUNT; ++i) {
+        ReversiGameData game;
+        if (!loadOpening(game, OPENINGS[i][1])) {
+            std::printf("benchmark=error opening=%s\n", OPENINGS[i][0]);
+            ++failures;
+            continue;
+        }
+        auto table = std::make_shared<ReversiTranspositionTable>();
+        long long nodes[MAX_MODES] = { 0, 0, 0 };
+        double times[MAX_MODES] = { 0.0, 0.0, 0.0 };
+        int moves = 0;
+        for (; moves < maxMoves && !game.GameOver(); ++moves) {
+            // A side without moves passes the turn.
+            auto side = game.Turn();
+            if ((side == ReversiGameData::WHITE_SIDE && game.WhiteSideBlocked()) ||
+                (side == ReversiGameData::BLACK_SIDE && game.BlackSideBlocked())) {
+                game.NextTurn();
+                continue;
+            }
+            ReversiMove move;
+            for (int mode = 0; mode < MAX_MODES; ++mode) {
+                std::unique_ptr<ReversiMiniMax> solver(mode == 2 ?
+                    new ReversiMiniMax(table) : new ReversiMiniMax());
+                solver->UseTable(mode != 0);
+                sf::Clock clock;
+                auto result = solver->Execute(game, depth, 0);
+                times[mode] += clock.getElapsedTime().asMicroseconds() / 1000.0;
+                nodes[mode] += solver->Stats().nodes;
+                if (mode == 0) move = result;
+            }
+            move.MakeMove(game);
+        }
+        for (int mode = 0; mode < MAX_MODES; ++mode) {
+            std::printf("benchmark=game opening=%s table=%s depth=%d moves=%d nodes=%lld "
+                "time=%.3f\n", OPENINGS[i][0], MODE_NAMES[mode], depth, moves, nodes[mode],
+                times[mode]);
+        }
+        std::printf("benchmark=speedup opening=%s depth=%d new=%.2f kept=%.2f\n",
+            OPENINGS[i][0], depth, nodes[1] > 0 ? nodes[0] / double(nodes[1]) : 0.0,
+            nodes[2] > 0 ? nodes[0] / double(nodes[2]) : 0.0);
+        std::fflush(stdout);
+    }
+    return failures;
+}
+
+//********************************************************************************
+// Methods (Private)
+//********************************************************************************
+
+bool ReversiBenchmark::loadOpening(ReversiGameData & game, const std::string & moves) {
+    // The machine always plays with the side that has the turn after the opening.
+    game.Start(false, ReversiGameData::HARD_LEVEL, ReversiGameData::WHITE_SIDE);
+    for (int i = 0; i < CENTER_CELLS; ++i) {
+        game.MakeMove(CENTER_ROWS[i], CENTER_COLS[i]);
+        game.NextTurn();
+    }
+    for (size_t i = 0; i + 1 < moves.size(); i += 2) {
+        int col = moves[i] - 'a', row = moves[i + 1] - '1';
+        if (!game.ValidateMove(row, col)) return false;
+        game.MakeMove(row, col);
+        game.NextTurn();
+    }
+    return true;
+}
+
+//--------------------------------------------------------------------------------
+
+std::string ReversiBenchmark::getMoveName(const ReversiMove & move) {
+    // Write the move with the coordinates of the cell, like "f5".
+    std::string name;
+    name += static_cast<char>('a' + move.step.x);
+    name += static_cast<char>('1' + move.step.y);
+    return name;
+}
+
+//--------------------------------------------------------------------------------
+
+int ReversiBenchmark::getArgument(const std::vector<std::string> & args, int index, int defval) {
+    if (index < static_cast<int>(args.size())) {
+        int value = std::atoi(args[index].c_str());
+        if (value > 0) return value;
+    }
+    return defval;
+}
@@ -0,0 +1,69 @@
+/******************************************************************************
+ Copyright (c) 2014 Gorka Surez Garca
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ DEALINGS IN THE SOFTWARE.
+******************************************************************************/
+
+#ifndef __REVERSI_BENCHMARK_HEADER__
+#define __REVERSI_BENCHMARK_HEADER__
+
+#include <string>
+#include <vector>
+#include <Games/Reversi/ReversiMiniMax.h>
+
+/**
+ * This static class contains the benchmarks of the reversi logic, that are executed
+ * from the command line without the user interface. Each result is written as a
+ * line of "name=value" fields in the standard output.
+ */
+class ReversiBenchmark {
+private:
+    ReversiBenchmark() {}
+    ~ReversiBenchmark() {}
+
+public:
+    //--------------------------------------------------------------------------------
+    // Constants
+    //--------------------------------------------------------------------------------
+
+    static const int DEFAULT_SEARCH_DEPTH = 10;
+    static const int DEFAULT_GAME_DEPTH   =  9;
+    static const int DEFAULT_GAME_MOVES   = 20;
+
+    //--------------------------------------------------------------------------------
+    // Methods
+    //--------------------------------------------------------------------------------
+
+    static bool Execute(int argc, char ** argv, int & result);
+
+    static int Search(int maxDepth);
+    static int Game(int depth, int maxMoves);
+
+private:
+    //--------------------------------------------------------------------------------
+    // Methods
+    //--------------------------------------------------------------------------------
+
+    static bool loadOpening(ReversiGameData & game, const std::string & moves);
+    static std::string getMoveName(const ReversiMove & move);
+
+    static int getArgument(const std::vector<std::string> & args, int index, int defval);
+};
+
+#endif
@@ -0,0 +1,211 @@
+/******************************************************************************
+ Copyright (c) 2014 Gorka Surez Garca
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ DEALINGS IN THE SOFTWARE.
+******************************************************************************/
+
+#include "ReversiBitboard.h"
+
+//********************************************************************************
+// Constants
+//********************************************************************************
+
+const ReversiBitboard::Bitboard DE_BRUIJN_MAGIC = 0x03F79D71B4CB0A89ULL;
+
+const int DE_BRUIJN_INDEX[64] = {
+     0, 47,  1, 56, 48, 27,  2, 60, 57, 49, 41, 37, 28, 16,  3, 61,
+    54, 58, 35, 52, 50, 42, 21, 44, 38, 32, 29, 23, 17, 11,  4, 62,
+    46, 55, 26, 59, 40, 36, 15, 53, 34, 51, 20, 43, 31, 22, 10, 45,
+    25, 39, 14, 33, 19, 30,  9, 24, 13, 18,  8, 12,  7,  6,  5, 63
+};
+
+const int MAX_AXES = 4;
+
+const ReversiBitboard::Bitboard AXIS_BORDERS[MAX_AXES] = {
+    ReversiBitboard::FILE_A | ReversiBitboard::FILE_H,
+    ReversiBitboard::BORDER,
+    ReversiBitboard::ROW_1 | ReversiBitboard::ROW_8,
+    ReversiBitboard::BORDER
+};
+
+//********************************************************************************
+// Static
+//********************************************************************************
+
+// The directions are east, north-east, north, north-west, west, south-west, south
+// and south-east, so the opposite of a direction is the direction plus four.
+const int ReversiBitboard::SHIFTS[MAX_DIRECTIONS] = { 1, 9, 8, 7, -1, -9, -8, -7 };
+
+const ReversiBitboard::Bitboard ReversiBitboard::MASKS[MAX_DIRECTIONS] = {
+    ~FILE_A, ~FILE_A, FULL, ~FILE_H, ~FILE_H, ~FILE_H, FULL, ~FILE_A
+};
+
+//********************************************************************************
+// Methods
+//********************************************************************************
+
+int ReversiBitboard::Count(Bitboard victim) {
+    // Parallel bit count without any intrinsic, so it works in any platform.
+    victim = victim - ((victim >> 1) & 0x5555555555555555ULL);
+    victim = (victim & 0x3333333333333333ULL) + ((victim >> 2) & 0x3333333333333333ULL);
+    victim = (victim + (victim >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+    return static_cast<int>((victim * 0x0101010101010101ULL) >> 56);
+}
+
+//--------------------------------------------------------------------------------
+
+int ReversiBitboard::First(Bitboard victim) {
+    // De Bruijn multiplication over the bits until the first set one.
+    if (victim == EMPTY) return NO_SQUARE;
+    return DE_BRUIJN_INDEX[((victim ^ (victim - 1)) * DE_BRUIJN_MAGIC) >> 58];
+}
+
+//--------------------------------------------------------------------------------
+
+ReversiBitboard::Bitboard ReversiBitboard::Fill(Bitboard generator, Bitboard propagator,
+    int direction) {
+    // Kogge-Stone occluded fill: the generator squares flood in the direction over
+    // the propagator squares, doubling the distance of the shift in each step. The
+    // mask of the direction removes the squares that would wrap around the board.
+    int shift = SHIFTS[direction];
+    propagator &= MASKS[direction];
+    if (shift > 0) {
+        generator |= propagator & (generator << shift);
+        propagator &= propagator << shift;
+        generator |= propagator & (generator << (shift * 2));
+        propagator &= propagator << (shift * 2);
+        generator |= propagator & (generator << (shift * 4));
+    } else {
+        shift = -shift;
+        generator |= propagator & (generator >> shift);
+        propagator &= propagator >> shift;
+        generator |= propagator & (generator >> (shift * 2));
+        propagator &= propagator >> (shift * 2);
+        generator |= propagator & (generator >> (shift * 4));
+    }
+    return generator;
+}
+
+//--------------------------------------------------------------------------------
+
+ReversiBitboard::Bitboard ReversiBitboard::GetNeighbors(Bitboard victim) {
+    Bitboard result = EMPTY;
+    for (int i = 0; i < MAX_DIRECTIONS; ++i) {
+        result |= Shift(victim, i);
+    }
+    return result & ~victim;
+}
+
+//--------------------------------------------------------------------------------
+
+ReversiBitboard::Bitboard ReversiBitboard::GetMoves(Bitboard own, Bitboard enemies) {
+    // A move is an empty square after a line of enemies that starts in an own piece.
+    Bitboard empty = ~(own | enemies), result = EMPTY;
+    for (int i = 0; i < MAX_DIRECTIONS; ++i) {
+        result |= Shift(Fill(own, enemies, i) & enemies, i);
+    }
+    return result & empty;
+}
+
+//--------------------------------------------------------------------------------
+
+ReversiBitboard::Bitboard ReversiBitboard::GetFlips(int square, Bitboard own,
+    Bitboard enemies) {
+    // The line of enemies from the square is taken when it ends in an own piece.
+    Bitboard piece = GetMask(square), result = EMPTY;
+    for (int i = 0; i < MAX_DIRECTIONS; ++i) {
+        Bitboard line = Fill(piece, enemies, i);
+        if ((Shift(line, i) & own) != EMPTY) {
+            result |= line;
+        }
+    }
+    return result & ~piece;
+}
+
+//--------------------------------------------------------------------------------
+
+ReversiBitboard::Bitboard ReversiBitboard::GetStables(Bitboard own, Bitboard enemies) {
+    // A piece can't be flipped in an axis when the line of the axis is full, or when
+    // one of its neighbors in the axis is the border or another stable own piece.
+    Bitboard empty = ~(own | enemies), full[MAX_AXES];
+    for (int i = 0; i < MAX_AXES; ++i) {
+        full[i] = ~(Fill(empty, FULL, i) | Fill(empty, FULL, i + MAX_AXES)) | AXIS_BORDERS[i];
+    }
+    // The stable pieces grow from the corners until nothing changes.
+    Bitboard result = EMPTY, previous;
+    do {
+        previous = result;
+        result = own;
+        for (int i = 0; i < MAX_AXES; ++i) {
+            result &= full[i] | Shift(previous, i) | Shift(previous, i + MAX_AXES);
+        }
+    } while (result != previous);
+    return result;
+}
+
+//--------------------------------------------------------------------------------
+
+ReversiBitboard::Bitboard ReversiBitboard::FlipVertical(Bitboard victim) {
+    // Swap the rows of the board: the bytes, then the pairs and then the halves.
+    victim = ((victim >>  8) & 0x00FF00FF00FF00FFULL) | ((victim & 0x00FF00FF00FF00FFULL) <<  8);
+    victim = ((victim >> 16) & 0x0000FFFF0000FFFFULL) | ((victim & 0x0000FFFF0000FFFFULL) << 16);
+    return (victim >> 32) | (victim << 32);
+}
+
+//--------------------------------------------------------------------------------
+
+ReversiBitboard::Bitboard ReversiBitboard::FlipHorizontal(Bitboard victim) {
+    // Swap the columns of each row: the bits, then the pairs and then the halves.
+    victim = ((victim >> 1) & 0x5555555555555555ULL) | ((victim & 0x5555555555555555ULL) << 1);
+    victim = ((victim >> 2) & 0x3333333333333333ULL) | ((victim & 0x3333333333333333ULL) << 2);
+    return ((victim >> 4) & 0x0F0F0F0F0F0F0F0FULL) | ((victim & 0x0F0F0F0F0F0F0F0FULL) << 4);
+}
+
+//--------------------------------------------------------------------------------
+
+ReversiBitboard::Bitboard ReversiBitboard::FlipDiagonal(Bitboard victim) {
+    // Swap the rows with the columns, exchanging the blocks over the diagonal of
+    // the first corner from the biggest ones to the smallest ones.
+    Bitboard aux = 0x0F0F0F0F00000000ULL & (victim ^ (victim << 28));
+    victim ^= aux ^ (aux >> 28);
+    aux = 0x3333000033330000ULL & (victim ^ (victim << 14));
+    victim ^= aux ^ (aux >> 14);
+    aux = 0x5500550055005500ULL & (victim ^ (victim << 7));
+    return victim ^ aux ^ (aux >> 7);
+}
+
+//--------------------------------------------------------------------------------
+
+ReversiBitboard::Bitboard ReversiBitboard::Transform(Bitboard victim, int symmetry) {
+    // The bits of the symmetry select the horizontal, vertical and diagonal flips.
+    if (symmetry & 1) victim = FlipHorizontal(victim);
+    if (symmetry & 2) victim = FlipVertical(victim);
+    if (symmetry & 4) victim = FlipDiagonal(victim);
+    return victim;
+}
+
+//--------------------------------------------------------------------------------
+
+ReversiBitboard::Bitboard ReversiBitboard::Untransform(Bitboard victim, int symmetry) {
+    // Each flip is its own inverse, so they are undone in the opposite order.
+    if (symmetry & 4) victim = FlipDiagonal(victim);
+    if (symmetry & 2) victim = FlipVertical(victim);
+    if (symmetry & 1) victim = FlipHorizontal(victim);
+    return victim;
+}
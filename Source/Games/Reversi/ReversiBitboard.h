@@ -0,0 +1,149 @@
+/******************************************************************************
+ Copyright (c) 2014 Gorka Surez Garca
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ DEALINGS IN THE SOFTWARE.
+******************************************************************************/
+
+#ifndef __REVERSI_BITBOARD_HEADER__
+#define __REVERSI_BITBOARD_HEADER__
+
+#include <SFML/System/Vector2.hpp>
+
+/**
+ * This static class is a collection of 64-bit board utility functions. The moves
+ * and the flips are generated with Kogge-Stone fills in the eight directions, and
+ * the eight symmetries of the board are made with flips of the rows and columns.
+ */
+class ReversiBitboard {
+private:
+    ReversiBitboard() {}
+    ~ReversiBitboard() {}
+
+public:
+    //--------------------------------------------------------------------------------
+    // Types
+    //--------------------------------------------------------------------------------
+
+    typedef unsigned long long Bitboard;
+
+    //--------------------------------------------------------------------------------
+    // Constants
+    //--------------------------------------------------------------------------------
+
+    static const int BOARD_SIZE     =  8;
+    static const int MAX_SQUARES    = 64;
+    static const int NO_SQUARE      = -1;
+    static const int MAX_DIRECTIONS =  8;
+    static const int MAX_SYMMETRIES =  8;
+
+    static const Bitboard EMPTY = 0ULL;
+    static const Bitboard FULL  = ~0ULL;
+
+    static const Bitboard FILE_A  = 0x0101010101010101ULL;
+    static const Bitboard FILE_H  = 0x8080808080808080ULL;
+    static const Bitboard ROW_1   = 0x00000000000000FFULL;
+    static const Bitboard ROW_8   = 0xFF00000000000000ULL;
+    static const Bitboard BORDER  = FILE_A | FILE_H | ROW_1 | ROW_8;
+    static const Bitboard CORNERS = 0x8100000000000081ULL;
+    static const Bitboard CENTER  = 0x0000001818000000ULL;
+
+    //--------------------------------------------------------------------------------
+    // Methods
+    //--------------------------------------------------------------------------------
+
+    /**
+     * Gets the square index of a cell.
+     */
+    static int GetSquare(int row, int col) {
+        if (row < 0 || BOARD_SIZE <= row || col < 0 || BOARD_SIZE <= col) {
+            return NO_SQUARE;
+        }
+        return row * BOARD_SIZE + col;
+    }
+
+    /**
+     * Gets the square index of a cell.
+     */
+    static int GetSquare(const sf::Vector2i & coords) {
+        return GetSquare(coords.y, coords.x);
+    }
+
+    /**
+     * Gets the cell coordinates of a square index.
+     */
+    static sf::Vector2i GetCoords(int square) {
+        return sf::Vector2i(square % BOARD_SIZE, square / BOARD_SIZE);
+    }
+
+    /**
+     * Gets the board with only one square set.
+     */
+    static Bitboard GetMask(int square) {
+        return 1ULL << square;
+    }
+
+    /**
+     * Checks if a square is set inside a board.
+     */
+    static bool IsSet(Bitboard victim, int square) {
+        return (victim & (1ULL << square)) != EMPTY;
+    }
+
+    static int Count(Bitboard victim);
+    static int First(Bitboard victim);
+
+    /**
+     * Gets the first square of a board and removes it.
+     */
+    static int PopFirst(Bitboard & victim) {
+        int square = First(victim);
+        victim &= victim - 1;
+        return square;
+    }
+
+    /**
+     * Moves all the squares of a board one cell in a direction.
+     */
+    static Bitboard Shift(Bitboard victim, int direction) {
+        int shift = SHIFTS[direction];
+        return (shift > 0 ? victim << shift : victim >> -shift) & MASKS[direction];
+    }
+
+    static Bitboard Fill(Bitboard generator, Bitboard propagator, int direction);
+    static Bitboard GetNeighbors(Bitboard victim);
+    static Bitboard GetMoves(Bitboard own, Bitboard enemies);
+    static Bitboard GetFlips(int square, Bitboard own, Bitboard enemies);
+    static Bitboard GetStables(Bitboard own, Bitboard enemies);
+
+    static Bitboard FlipVertical(Bitboard victim);
+    static Bitboard FlipHorizontal(Bitboard victim);
+    static Bitboard FlipDiagonal(Bitboard victim);
+    static Bitboard Transform(Bitboard victim, int symmetry);
+    static Bitboard Untransform(Bitboard victim, int symmetry);
+
+private:
+    //--------------------------------------------------------------------------------
+    // Constants
+    //--------------------------------------------------------------------------------
+
+    static const int SHIFTS[MAX_DIRECTIONS];
+    static const Bitboard MASKS[MAX_DIRECTIONS];
+};
+
+#endif
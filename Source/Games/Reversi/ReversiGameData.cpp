@@ -27,12 +27,6 @@
 // Constants
 //********************************************************************************
 
-const int MAX_DIRS = 8;
-const sf::Vector2i DIRS[MAX_DIRS] = {
-    sf::Vector2i(-1,  1), sf::Vector2i(0,  1), sf::Vector2i( 1,  1), sf::Vector2i( 1, 0),
-    sf::Vector2i( 1, -1), sf::Vector2i(0, -1), sf::Vector2i(-1, -1), sf::Vector2i(-1, 0)
-};
-
 const int START_CENTER = 3;
 const int END_CENTER   = 4;
 
@@ -53,11 +47,7 @@ void ReversiGameData::Start(bool singlePlayer, int difficulty, int playerSide) {
 
 void ReversiGameData::Reset() {
     // Initialize the game board.
-    for (int i = 0, k = 1; i < BOARD_SIZE; ++i) {
-        for (int j = 0; j < BOARD_SIZE; ++j, ++k) {
-            board_[i][j] = EMPTY_CELL;
-        }
-    }
+    whiteBoard_ = blackBoard_ = ReversiBitboard::EMPTY;
     // Set some control information.
     winner_ = NO_WINNER;
     turn_ = WHITE_SIDE;
@@ -73,7 +63,7 @@ void ReversiGameData::Reset() {
 void ReversiGameData::ForEachInBoard(std::function<void (int, int, int)> operation) {
     for (int i = 0; i < BOARD_SIZE; ++i) {
         for (int j = 0; j < BOARD_SIZE; ++j) {
-            operation(board_[i][j], i, j);
+            operation(getCell(i, j), i, j);
         }
     }
 }
@@ -120,16 +110,8 @@ void ReversiGameData::NextTurn() {
 //--------------------------------------------------------------------------------
 
 void ReversiGameData::CheckBeginningEnded() {
-    bool anyEmpty = false;
-    for (int i = START_CENTER; i <= END_CENTER; ++i) {
-        for (int j = START_CENTER; j <= END_CENTER; ++j)  {
-            if (board_[i][j] == EMPTY_CELL) {
-                anyEmpty = true;
-                break;
-            }
-        }
-    }
-    if (!anyEmpty) {
+    auto pieces = whiteBoard_ | blackBoard_;
+    if ((pieces & ReversiBitboard::CENTER) == ReversiBitboard::CENTER) {
         beginningState_ = false;
     }
 }
@@ -138,19 +120,9 @@ void ReversiGameData::CheckBeginningEnded() {
 
 void ReversiGameData::CheckGameOver() {
     // Count all the types of entities inside the board.
-    int emptyCount = 0, whiteCount = 0, blackCount = 0;
-    for (int i = 0; i < BOARD_SIZE; ++i) {
-        for (int j = 0; j < BOARD_SIZE; ++j) {
-            auto victim = board_[i][j];
-            if (victim == BLACK_SIDE) {
-                ++blackCount;
-            } else if (victim == WHITE_SIDE) {
-                ++whiteCount;
-            } else {
-                ++emptyCount;
-            }
-        }
-    }
+    int whiteCount = ReversiBitboard::Count(whiteBoard_);
+    int blackCount = ReversiBitboard::Count(blackBoard_);
+    int emptyCount = ReversiBitboard::MAX_SQUARES - whiteCount - blackCount;
     // Check if the game over is reached and then set the winner.
     if (emptyCount <= 0 || (blackSideBlocked_ && whiteSideBlocked_)) {
         if (whiteCount < blackCount) {
@@ -169,36 +141,20 @@ void ReversiGameData::CheckGameOver() {
 
 void ReversiGameData::CalculateCandidates() {
     candidates_.clear();
-    if (beginningState_) {
-        // Select the middle empty cells.
-        for (int i = START_CENTER; i <= END_CENTER; ++i) {
-            for (int j = START_CENTER; j <= END_CENTER; ++j)  {
-                if (board_[i][j] == EMPTY_CELL) {
-                    candidates_.push_back(sf::Vector2i(j, i));
-                }
-            }
-        }
-    } else {
-        // Select the empty validated cells.
-        for (int i = 0; i < BOARD_SIZE; ++i) {
-            for (int j = 0; j < BOARD_SIZE; ++j) {
-                if (ValidateMove(i, j)) {
-                    candidates_.push_back(sf::Vector2i(j, i));
-                }
-            }
-        }
+    // Select the middle empty cells at the beginning, and the empty validated cells
+    // after it. The squares of the bitboard are sorted by rows, like the cells.
+    Bitboard moves = beginningState_ ? ReversiBitboard::CENTER & ~(whiteBoard_ | blackBoard_)
+                                     : getMoves();
+    while (moves != ReversiBitboard::EMPTY) {
+        candidates_.push_back(ReversiBitboard::GetCoords(ReversiBitboard::PopFirst(moves)));
     }
 }
 
 //--------------------------------------------------------------------------------
 
 bool ReversiGameData::ValidateMove(int r, int c) const {
-    if (IsInside(r, c) && board_[r][c] == EMPTY_CELL) {
-        for (int i = 0; i < MAX_DIRS; ++i) {
-            if (canTakePieces(r, c, DIRS[i])) {
-                return true;
-            }
-        }
+    if (IsInside(r, c)) {
+        return ReversiBitboard::IsSet(getMoves(), ReversiBitboard::GetSquare(r, c));
     }
     return false;
 }
@@ -210,15 +166,21 @@ bool ReversiGameData::ValidateMove(const sf::Vector2i & coords) const {
 //--------------------------------------------------------------------------------
 
 void ReversiGameData::MakeMove(int r, int c) {
-    if (IsInside(r, c) && board_[r][c] == EMPTY_CELL) {
+    if (IsInside(r, c) && getCell(r, c) == EMPTY_CELL) {
         if (beginningState_) {
-            if (3 <= r && r <= 4 && 3 <= c && c <= 4) {
-                board_[r][c] = turn_;
+            if (START_CENTER <= r && r <= END_CENTER && START_CENTER <= c && c <= END_CENTER) {
+                setCell(r, c, turn_);
             }
             CheckBeginningEnded();
         } else {
-            for (int i = 0; i < MAX_DIRS; ++i) {
-                takePieces(r, c, DIRS[i]);
+            // The piece is only placed when it takes some enemy pieces.
+            int square = ReversiBitboard::GetSquare(r, c);
+            auto & own = turn_ == WHITE_SIDE ? whiteBoard_ : blackBoard_;
+            auto & enemies = turn_ == WHITE_SIDE ? blackBoard_ : whiteBoard_;
+            auto flips = ReversiBitboard::GetFlips(square, own, enemies);
+            if (flips != ReversiBitboard::EMPTY) {
+                own |= flips | ReversiBitboard::GetMask(square);
+                enemies &= ~flips;
             }
         }
     }
@@ -230,44 +192,49 @@ void ReversiGameData::MakeMove(const sf::Vector2i & coords) {
 
 //--------------------------------------------------------------------------------
 
-bool ReversiGameData::canTakePieces(int r, int c, const sf::Vector2i & inc) const {
-    int enemySide = GetOppositeSide(turn_);
-    sf::Vector2i dest(c + inc.x, r + inc.y);
-    if (IsInside(dest) && board_[dest.y][dest.x] == enemySide) {
-        do {
-            if (board_[dest.y][dest.x] == turn_) {
-                return true;
-            } else if (board_[dest.y][dest.x] == EMPTY_CELL) {
-                return false;
-            }
-            dest += inc;
-        } while (IsInside(dest));
+int ReversiGameData::getCell(int r, int c) const {
+    int square = ReversiBitboard::GetSquare(r, c);
+    if (square != ReversiBitboard::NO_SQUARE) {
+        if (ReversiBitboard::IsSet(whiteBoard_, square)) {
+            return WHITE_SIDE;
+        } else if (ReversiBitboard::IsSet(blackBoard_, square)) {
+            return BLACK_SIDE;
+        }
     }
-    return false;
+    return EMPTY_CELL;
 }
 
 //--------------------------------------------------------------------------------
 
-void ReversiGameData::takePieces(int r, int c, const sf::Vector2i & inc) {
-    int enemySide = GetOppositeSide(turn_);
-    sf::Vector2i dest(c + inc.x, r + inc.y);
-    if (IsInside(dest) && board_[dest.y][dest.x] == enemySide) {
-        do {
-            if (board_[dest.y][dest.x] == turn_) {
-                sf::Vector2i orig(c, r);
-                do {
-                    dest -= inc;
-                    board_[dest.y][dest.x] = turn_;
-                } while (orig != dest);
-                return;
-            } else if (board_[dest.y][dest.x] == EMPTY_CELL) {
-                return;
-            }
-            dest += inc;
-        } while (IsInside(dest));
+void ReversiGameData::setCell(int r, int c, int side) {
+    int square = ReversiBitboard::GetSquare(r, c);
+    if (square != ReversiBitboard::NO_SQUARE) {
+        auto mask = ReversiBitboard::GetMask(square);
+        whiteBoard_ &= ~mask;
+        blackBoard_ &= ~mask;
+        if (side == WHITE_SIDE) whiteBoard_ |= mask;
+        if (side == BLACK_SIDE) blackBoard_ |= mask;
+    }
+}
+
+//--------------------------------------------------------------------------------
+
+ReversiGameData::Bitboard ReversiGameData::getSideBoard(int side) const {
+    if (side == WHITE_SIDE) {
+        return whiteBoard_;
+    } else if (side == BLACK_SIDE) {
+        return blackBoard_;
+    } else {
+        return ReversiBitboard::EMPTY;
     }
 }
 
+//--------------------------------------------------------------------------------
+
+ReversiGameData::Bitboard ReversiGameData::getMoves() const {
+    return ReversiBitboard::GetMoves(getSideBoard(turn_), getSideBoard(GetOppositeSide(turn_)));
+}
+
 //********************************************************************************
 // Query Methods
 //********************************************************************************
@@ -314,7 +281,8 @@ bool ReversiGameData::IsCandidate(const sf::Vector2i & coords) const {
 
 ReversiGameData::ReversiGameData() : singlePlayer_(false), difficulty_(NORMAL_LEVEL),
     playerSide_(WHITE_SIDE), winner_(NO_WINNER), turn_(WHITE_SIDE), beginningState_(true),
-    whiteSideBlocked_(false), blackSideBlocked_(false), candidates_() {}
+    whiteSideBlocked_(false), blackSideBlocked_(false), whiteBoard_(ReversiBitboard::EMPTY),
+    blackBoard_(ReversiBitboard::EMPTY), candidates_() {}
 
 //--------------------------------------------------------------------------------
 
@@ -337,9 +305,8 @@ ReversiGameData & ReversiGameData::operator =(const ReversiGameData & source) {
     beginningState_ = source.beginningState_;
     whiteSideBlocked_ = source.whiteSideBlocked_;
     blackSideBlocked_ = source.blackSideBlocked_;
-    ForEachInBoard([&] (int, int i, int j) {
-        board_[i][j] = source.board_[i][j];
-    });
+    whiteBoard_ = source.whiteBoard_;
+    blackBoard_ = source.blackBoard_;
     candidates_ = source.candidates_;
     return *this;
 }
@@ -26,13 +26,16 @@
 #include <vector>
 #include <functional>
 #include <SFML/Graphics/Rect.hpp>
+#include <Games/Reversi/ReversiBitboard.h>
 
 /**
- * This class represents the reversi board game data.
+ * This class represents the reversi board game data. The pieces are stored in
+ * bitboards, but the methods still work with the board cells.
  */
 class ReversiGameData {
 public:
     friend class SaveManager;
+    friend class ReversiMiniMax;
 
     //--------------------------------------------------------------------------------
     // Constants
@@ -64,7 +67,7 @@ public:
     // Types
     //--------------------------------------------------------------------------------
 
-    typedef int BoardTable[BOARD_SIZE][BOARD_SIZE];
+    typedef ReversiBitboard::Bitboard Bitboard;
     typedef std::vector<sf::Vector2i> CoordsVector;
 
     //--------------------------------------------------------------------------------
@@ -145,15 +148,18 @@ private:
     bool whiteSideBlocked_;
     bool blackSideBlocked_;
 
-    BoardTable board_;
+    Bitboard whiteBoard_;
+    Bitboard blackBoard_;
     CoordsVector candidates_;
 
     //--------------------------------------------------------------------------------
     // Methods
     //--------------------------------------------------------------------------------
 
-    bool canTakePieces(int r, int c, const sf::Vector2i & inc) const;
-    void takePieces(int r, int c, const sf::Vector2i & inc);
+    int getCell(int r, int c) const;
+    void setCell(int r, int c, int side);
+    Bitboard getSideBoard(int side) const;
+    Bitboard getMoves() const;
 };
 
 #endif
@@ -33,6 +33,7 @@
 #include <System/Mouse.h>
 #include <System/MathUtil.h>
 #include <System/ForEach.h>
+#include <System/ThinkService.h>
 #include <Menu/DesktopState.h>
 #include <Games/SaveManager.h>
 #include <Games/Reversi/ReversiGameData.h>
@@ -77,6 +78,8 @@ struct ReversiManager::InnerData {
     bool aiExecutePass;
     int aiCurrentTime;
     ReversiMove aiCurrentMove;
+    std::shared_ptr<ThinkJob<ReversiMove>> aiTask;
+    std::shared_ptr<ReversiTranspositionTable> aiTable;
 
     std::unique_ptr<TextLabel> messageText;
     int errorMessage;
@@ -89,6 +92,7 @@ struct ReversiManager::InnerData {
     void PassMove();
 
     void ResetHudAndGoToGameState();
+    void CancelMachineMove();
     void ClearErrorMessage();
     void SetErrorMessage(int error);
     void UpdateHud();
@@ -141,11 +145,27 @@ void ReversiManager::InnerData::ResetHudAndGoToGameState() {
     aiExecutePass = false;
     aiCurrentTime = 0;
     aiCurrentMove = ReversiMove();
+    CancelMachineMove();
+    aiTable->Clear();
     core->SetNextState(MakeSharedState<ReversiGameState>());
 }
 
 //--------------------------------------------------------------------------------
 
+/**
+ * Cancels the move that the machine is thinking, and waits until the search
+ * stops using the transposition table.
+ */
+void ReversiManager::InnerData::CancelMachineMove() {
+    if (aiTask) {
+        aiTask->Cancel();
+        aiTask->Wait();
+        aiTask = nullptr;
+    }
+}
+
+//--------------------------------------------------------------------------------
+
 /**
  * Clears the error message.
  */
@@ -275,6 +295,9 @@ void ReversiManager::Initialize() {
         data_.reset(new InnerData());
         data_->core = CoreManager::Instance();
 
+        // The transposition table of the machine is kept between the moves.
+        data_->aiTable = std::make_shared<ReversiTranspositionTable>();
+
         // Load the textures of the game.
         data_->tileset = data_->core->LoadTexture("Content/Textures/Reversi.png");
         data_->textures[MOUSE_CURSOR].Load(data_->tileset, sf::IntRect(256, 408, 32, 32));
@@ -320,6 +343,9 @@ void ReversiManager::Release() {
         // Unload the textures of the game.
         data_->tileset = nullptr;
 
+        // Stop the machine if it is still thinking.
+        data_->CancelMachineMove();
+
         // Remove the inner data of the game.
         data_.reset(nullptr);
     }
@@ -463,6 +489,14 @@ void ReversiManager::UpdateMachine(const sf::Time & timeDelta) {
                 }
                 data_->aiExecuteMove = false;
             }
+        } else if (data_->aiTask) {
+            // The machine thinks in the background, so only check if the move is ready.
+            if (data_->aiTask->Finished()) {
+                data_->aiCurrentMove = data_->aiTask->Result();
+                data_->aiTask = nullptr;
+                data_->aiCurrentTime = 0;
+                data_->aiExecuteMove = true;
+            }
         } else {
             if (data_->game.PlayerSide() == ReversiGameData::WHITE_SIDE) {
                 data_->aiExecutePass = data_->game.BlackSideBlocked();
@@ -475,12 +509,22 @@ void ReversiManager::UpdateMachine(const sf::Time & timeDelta) {
                     data_->aiCurrentMove = ReversiMove();
                     data_->aiCurrentMove.step = data_->game.Candidates()[index];
                 } else {
-                    ReversiMiniMax solver;
-                    data_->aiCurrentMove = solver.Execute(data_->game);
+                    // Submit a copy of the board to think the next move of the machine.
+                    // The table is shared with the previous searches of the game.
+                    auto board = data_->game;
+                    auto table = data_->aiTable;
+                    data_->aiTask = ThinkService::Instance()->Submit<ReversiMove>(
+                        [board, table] (const ThinkTask & task) -> ReversiMove {
+                            ReversiMiniMax solver(table);
+                            return solver.Execute(board, &task);
+                        }
+                    );
                 }
             }
-            data_->aiCurrentTime = 0;
-            data_->aiExecuteMove = true;
+            if (!data_->aiTask) {
+                data_->aiCurrentTime = 0;
+                data_->aiExecuteMove = true;
+            }
         }
     }
     data_->UpdateHud();
@@ -21,193 +21,426 @@
 ******************************************************************************/
 
 #include "ReversiMiniMax.h"
-#include <limits>
-#include <System/ForEach.h>
 
 //********************************************************************************
 // Constants
 //********************************************************************************
 
-const int INITIAL_ALPHA = std::numeric_limits<int>::min();
-const int INITIAL_BETA = std::numeric_limits<int>::max();
-
-const int REVERSI_HEURISTIC[ReversiGameData::BOARD_SIZE][ReversiGameData::BOARD_SIZE] = {
-    { 10, 5, 5, 5, 5, 5, 5, 10 },
-    {  5, 1, 1, 1, 1, 1, 1,  5 },
-    {  5, 1, 1, 1, 1, 1, 1,  5 },
-    {  5, 1, 1, 1, 1, 1, 1,  5 },
-    {  5, 1, 1, 1, 1, 1, 1,  5 },
-    {  5, 1, 1, 1, 1, 1, 1,  5 },
-    {  5, 1, 1, 1, 1, 1, 1,  5 },
-    { 10, 5, 5, 5, 5, 5, 5, 10 }
+const int INFINITE_SCORE = 1000000;
+const int WIN_SCORE      =  100000;
+
+const int MOBILITY_VALUE =  10;
+const int CORNER_VALUE   =  80;
+const int STABLE_VALUE   =  15;
+const int FRONTIER_VALUE =  -5;
+const int X_SQUARE_VALUE = -40;
+const int C_SQUARE_VALUE = -15;
+
+const int EASY_DEPTH   = 1;
+const int NORMAL_DEPTH = 4;
+const int HARD_DEPTH   = 9;
+
+const int EASY_EMPTIES   =  0;
+const int NORMAL_EMPTIES = 10;
+const int HARD_EMPTIES   = 14;
+
+const int SORT_BY_MOBILITY_DEPTH   = 3;
+const int SORT_BY_MOBILITY_EMPTIES = 7;
+
+// The positions near the leaves are too many and too cheap to be stored.
+const int MIN_TABLE_DEPTH   = 2;
+const int MIN_TABLE_EMPTIES = 7;
+
+// The exact scores are stored with other keys, to not mix them with the heuristic.
+const ReversiTranspositionTable::HashKey SOLVE_KEY = 0x9E3779B97F4A7C15ULL;
+
+// The squares near an empty corner give the corner to the enemy, so each corner has
+// its diagonal neighbor (X-square) and its two neighbors in the borders (C-squares).
+const int MAX_CORNERS = 4;
+
+const ReversiBitboard::Bitboard CORNER_SQUARES[MAX_CORNERS] = {
+    0x0000000000000001ULL, 0x0000000000000080ULL,
+    0x0100000000000000ULL, 0x8000000000000000ULL
+};
+
+const ReversiBitboard::Bitboard X_SQUARES[MAX_CORNERS] = {
+    0x0000000000000200ULL, 0x0000000000004000ULL,
+    0x0002000000000000ULL, 0x0040000000000000ULL
+};
+
+const ReversiBitboard::Bitboard C_SQUARES[MAX_CORNERS] = {
+    0x0000000000000102ULL, 0x0000000000008040ULL,
+    0x0201000000000000ULL, 0x4080000000000000ULL
 };
 
+// The order to check the moves when there is no better information.
+const int SQUARE_PRIORITY[ReversiBitboard::MAX_SQUARES] = {
+    8, 1, 6, 5, 5, 6, 1, 8,
+    1, 0, 2, 3, 3, 2, 0, 1,
+    6, 2, 4, 4, 4, 4, 2, 6,
+    5, 3, 4, 4, 4, 4, 3, 5,
+    5, 3, 4, 4, 4, 4, 3, 5,
+    6, 2, 4, 4, 4, 4, 2, 6,
+    1, 0, 2, 3, 3, 2, 0, 1,
+    8, 1, 6, 5, 5, 6, 1, 8
+};
+
+const int MOBILITY_PRIORITY = 16;
+
 //********************************************************************************
 // Methods
 //********************************************************************************
 
-ReversiMove ReversiMiniMax::Execute(ReversiGameData & data) {
+ReversiMove ReversiMiniMax::Execute(const ReversiGameData & data, const ThinkTask * task) {
     initialize(data.Difficulty());
-    return minimax(data, 0, INITIAL_ALPHA, INITIAL_BETA);
+    return Execute(data, maxDepth, maxEmpties, task);
+}
+
+//--------------------------------------------------------------------------------
+
+ReversiMove ReversiMiniMax::Execute(const ReversiGameData & data, int depth, int empties,
+    const ThinkTask * task) {
+    ReversiMove result;
+    thinkTask = task;
+    maxDepth = depth;
+    maxEmpties = empties;
+    stats.nodes = stats.tableHits = stats.cutoffs = 0;
+    if (useTable) table->NewSearch();
+
+    // The search is done from the point of view of the side to move.
+    Bitboard own = data.getSideBoard(data.Turn());
+    Bitboard enemies = data.getSideBoard(data.GetOppositeSide(data.Turn()));
+    Bitboard moves = ReversiBitboard::GetMoves(own, enemies);
+    if (moves != ReversiBitboard::EMPTY) {
+        int squares[ReversiBitboard::MAX_SQUARES];
+        int size = sortMoves(own, enemies, moves, squares, true);
+
+        // With only a few empty squares the game is solved until the end. Otherwise
+        // each iteration of the search checks first the best move of the previous one.
+        int left = ReversiBitboard::Count(~(own | enemies));
+        if (left <= maxEmpties) {
+            search(own, enemies, squares, size, left, true);
+        } else if (useTable) {
+            for (int i = 1; i <= maxDepth && !cancelled(); ++i) {
+                search(own, enemies, squares, size, i, false);
+            }
+        } else {
+            search(own, enemies, squares, size, maxDepth, false);
+        }
+        result.step = ReversiBitboard::GetCoords(squares[0]);
+    }
+    return result;
 }
 
 //--------------------------------------------------------------------------------
 
 void ReversiMiniMax::initialize(int difficulty) {
     if (difficulty == ReversiGameData::HARD_LEVEL) {
-        maxDepth = 5;
+        maxDepth = HARD_DEPTH;
+        maxEmpties = HARD_EMPTIES;
     } else if (difficulty == ReversiGameData::NORMAL_LEVEL) {
-        maxDepth = 3;
+        maxDepth = NORMAL_DEPTH;
+        maxEmpties = NORMAL_EMPTIES;
     } else {
-        maxDepth = 3;
+        maxDepth = EASY_DEPTH;
+        maxEmpties = EASY_EMPTIES;
     }
 }
 
 //--------------------------------------------------------------------------------
 
-void ReversiMiniMax::getAllMoves(ReversiGameData & data, ReversiMoveVector & moves) {
-    // First, get all the candidates on the current board.
-    auto & candidates = data.Candidates();
-    // For each candidate lets get all the moves of it.
-    ForEach(candidates, [&] (const sf::Vector2i & item) {
-        moves.push_back(ReversiMove(item));
-    });
+bool ReversiMiniMax::cancelled() const {
+    // When the task is cancelled the search ends with the current result.
+    return thinkTask != nullptr && thinkTask->Cancelled();
 }
 
 //--------------------------------------------------------------------------------
 
-ReversiMove ReversiMiniMax::minimax(ReversiGameData & data, int depth, int alpha, int beta) {
-    ReversiMove result;
-    if (!data.GameOver()) {
-        // If the game is not over, get all the moves inside the board.
-        ReversiMoveVector moves;
-        getAllMoves(data, moves);
-
-        // If we have some moves to check, we'll initialize some variables.
-        if (!moves.empty()) {
-            int actval, maxval = INITIAL_ALPHA;
-            auto it = moves.begin(), end = moves.end();
-            result = ReversiMove(*it);
-
-            // And then for each move we'll try to get the maximum result.
-            for (; it != end; ++it) {
-                ReversiGameData future(data);
-                it->MakeMove(future);
-                actval = minimizer(future, depth + 1, alpha, beta);
-                if (maxval < actval) {
-                    maxval = actval;
-                    alpha = actval;
-                    result = ReversiMove(*it);
-                }
-            }
+int ReversiMiniMax::sortMoves(Bitboard own, Bitboard enemies, Bitboard moves, int * squares,
+    bool sortByMobility) {
+    // Give a score to each move: the moves that leave fewer moves to the enemy are
+    // checked first when it's worth it, and then the best squares of the board.
+    int scores[ReversiBitboard::MAX_SQUARES], size = 0;
+    while (moves != ReversiBitboard::EMPTY) {
+        int square = ReversiBitboard::PopFirst(moves);
+        int score = SQUARE_PRIORITY[square];
+        if (sortByMobility) {
+            auto flips = ReversiBitboard::GetFlips(square, own, enemies);
+            auto enemyMoves = ReversiBitboard::GetMoves(enemies & ~flips,
+                own | flips | ReversiBitboard::GetMask(square));
+            score -= ReversiBitboard::Count(enemyMoves) * MOBILITY_PRIORITY;
+        }
+        // Insert the move sorted by score, keeping the order of the same scores.
+        int i = size++;
+        for (; i > 0 && scores[i - 1] < score; --i) {
+            scores[i] = scores[i - 1];
+            squares[i] = squares[i - 1];
         }
+        scores[i] = score;
+        squares[i] = square;
     }
-    return result;
+    return size;
 }
 
 //--------------------------------------------------------------------------------
 
-int ReversiMiniMax::minimizer(ReversiGameData & data, int depth, int alpha, int beta) {
-    // If we reach the maximum depth o the game is over, we'll evaluate the current
-    // state of the game. If the current side does not have any moves the game ends,
-    // so is not necesary to check if we have or not moves when there is no game over.
-    if (maxDepth < depth || data.GameOver()) {
-        return evaluate(data);
-    } else {
-        // If the game is not over, get all the moves inside the board.
-        ReversiMoveVector moves;
-        getAllMoves(data, moves);
-
-        // We'll initialize some variables.
-        int actval, minval = INITIAL_BETA;
-        auto it = moves.begin(), end = moves.end();
-        // And then for each move we'll try to get the minimum result.
-        for (; it != end; ++it) {
-            ReversiGameData future(data);
-            it->MakeMove(future);
-            actval = maximizer(future, depth + 1, alpha, beta);
-
-            if(minval > actval) {
-                minval = actval;
-                beta = actval;
-            }
+int ReversiMiniMax::getFirstMove(Bitboard own, Bitboard enemies, Bitboard & moves,
+    int * squares, bool sortByMobility, int firstSquare) {
+    // When the table gives a valid move, it's the only one and the other ones are
+    // left in the board to be sorted later. Otherwise all the moves are sorted.
+    if (firstSquare != ReversiBitboard::NO_SQUARE &&
+        ReversiBitboard::IsSet(moves, firstSquare)) {
+        moves &= ~ReversiBitboard::GetMask(firstSquare);
+        squares[0] = firstSquare;
+        return 1;
+    }
+    int size = sortMoves(own, enemies, moves, squares, sortByMobility);
+    moves = ReversiBitboard::EMPTY;
+    return size;
+}
 
-            if(alpha > beta) {
-                return minval;
-            }
+//--------------------------------------------------------------------------------
+
+void ReversiMiniMax::search(Bitboard own, Bitboard enemies, int * squares, int size,
+    int depth, bool exact) {
+    // Search all the moves of the root and put the best one at the beginning.
+    int alpha = -INFINITE_SCORE, beta = INFINITE_SCORE, best = 0;
+    for (int i = 0; i < size; ++i) {
+        auto flips = ReversiBitboard::GetFlips(squares[i], own, enemies);
+        auto nextOwn = own | flips | ReversiBitboard::GetMask(squares[i]);
+        auto nextEnemies = enemies & ~flips;
+        int actval = exact ?
+            -solve(nextEnemies, nextOwn, depth - 1, -beta, -alpha, false) :
+            -minimax(nextEnemies, nextOwn, depth - 1, -beta, -alpha, false);
+        if (alpha < actval) {
+            alpha = actval;
+            best = i;
         }
-        return minval;
     }
+    int square = squares[best];
+    for (int i = best; i > 0; --i) {
+        squares[i] = squares[i - 1];
+    }
+    squares[0] = square;
 }
 
 //--------------------------------------------------------------------------------
 
-int ReversiMiniMax::maximizer(ReversiGameData & data, int depth, int alpha, int beta) {
-    // If we reach the maximum depth o the game is over, we'll evaluate the current
-    // state of the game. If the current side does not have any moves the game ends,
-    // so is not necesary to check if we have or not moves when there is no game over.
-    if (maxDepth < depth || data.GameOver()) {
-        return evaluate(data);
-    } else {
-        // If the game is not over, get all the moves inside the board.
-        ReversiMoveVector moves;
-        getAllMoves(data, moves);
-
-        // We'll initialize some variables.
-        int actval, maxval = INITIAL_ALPHA;
-        auto it = moves.begin(), end = moves.end();
-        // And then for each move we'll try to get the maximum result.
-        for (; it != end; ++it) {
-            ReversiGameData future(data);
-            it->MakeMove(future);
-            actval = minimizer(future, depth + 1, alpha, beta);
-
-            if(maxval < actval) {
-                maxval = actval;
-                alpha = actval;
+bool ReversiMiniMax::probeTable(Bitboard own, Bitboard enemies, int depth, bool exact,
+    int alpha, int beta, ReversiTranspositionTable::HashKey & key, int & symmetry,
+    int & square, int & score) {
+    // Get the best move of the position, and its score when it's good enough.
+    key = table->GetKey(own, enemies, symmetry);
+    if (exact) key ^= SOLVE_KEY;
+    ReversiTranspositionTable::Entry entry;
+    if (table->Probe(key, symmetry, entry)) {
+        square = entry.square;
+        if (entry.depth >= depth) {
+            if (entry.bound == ReversiTranspositionTable::BOUND_EXACT ||
+                (entry.bound == ReversiTranspositionTable::BOUND_LOWER && entry.score >= beta) ||
+                (entry.bound == ReversiTranspositionTable::BOUND_UPPER && entry.score <= alpha)) {
+                score = entry.score;
+                ++stats.tableHits;
+                return true;
             }
+        }
+    }
+    return false;
+}
+
+//--------------------------------------------------------------------------------
+
+void ReversiMiniMax::storeTable(ReversiTranspositionTable::HashKey key, int symmetry,
+    int square, int score, int depth, int alpha, int beta) {
+    // A cancelled search gives wrong scores, so they aren't stored.
+    if (cancelled()) return;
+    int bound = ReversiTranspositionTable::BOUND_EXACT;
+    if (score <= alpha) {
+        bound = ReversiTranspositionTable::BOUND_UPPER;
+        square = ReversiBitboard::NO_SQUARE;
+    } else if (score >= beta) {
+        bound = ReversiTranspositionTable::BOUND_LOWER;
+    }
+    table->Store(key, symmetry, square, score, depth, bound);
+}
+
+//--------------------------------------------------------------------------------
+
+int ReversiMiniMax::minimax(Bitboard own, Bitboard enemies, int depth, int alpha, int beta,
+    bool passed) {
+    // If we reach the maximum depth, we'll evaluate the current state of the game.
+    ++stats.nodes;
+    if (depth <= 0 || cancelled()) {
+        return evaluate(own, enemies);
+    }
+
+    // A side without moves passes the turn, and when both sides pass the game is over.
+    Bitboard moves = ReversiBitboard::GetMoves(own, enemies);
+    if (moves == ReversiBitboard::EMPTY) {
+        if (passed) {
+            return evaluateEnd(own, enemies);
+        } else {
+            return -minimax(enemies, own, depth, -beta, -alpha, true);
+        }
+    }
 
-            if(alpha > beta) {
-                return maxval;
+    // Check if the position was searched before with the same or a bigger depth.
+    ReversiTranspositionTable::HashKey key = 0;
+    int symmetry = 0, square = ReversiBitboard::NO_SQUARE, score = 0;
+    bool tableNode = useTable && depth >= MIN_TABLE_DEPTH;
+    if (tableNode && probeTable(own, enemies, depth, false, alpha, beta,
+        key, symmetry, square, score)) {
+        return score;
+    }
+
+    // For each move we'll try to get the maximum result, the result of the enemy
+    // is the same one with the opposite sign (negamax). The best move of the table
+    // is checked before sorting the other ones, because it usually gets a cutoff.
+    int squares[ReversiBitboard::MAX_SQUARES];
+    bool sortByMobility = depth >= SORT_BY_MOBILITY_DEPTH;
+    int size = getFirstMove(own, enemies, moves, squares, sortByMobility, square);
+    int maxval = -INFINITE_SCORE, oldAlpha = alpha;
+    square = ReversiBitboard::NO_SQUARE;
+    for (int i = 0; i < size; ++i) {
+        auto flips = ReversiBitboard::GetFlips(squares[i], own, enemies);
+        auto nextOwn = own | flips | ReversiBitboard::GetMask(squares[i]);
+        auto nextEnemies = enemies & ~flips;
+        int actval;
+        if (i == 0) {
+            actval = -minimax(nextEnemies, nextOwn, depth - 1, -beta, -alpha, false);
+        } else {
+            actval = -minimax(nextEnemies, nextOwn, depth - 1, -alpha - 1, -alpha, false);
+            if (alpha < actval && actval < beta) {
+                actval = -minimax(nextEnemies, nextOwn, depth - 1, -beta, -alpha, false);
             }
         }
-        return maxval;
+        if (maxval < actval) {
+            maxval = actval;
+            square = squares[i];
+            if (alpha < actval) {
+                alpha = actval;
+                if (alpha >= beta) {
+                    ++stats.cutoffs;
+                    break;
+                }
+            }
+        }
+        if (moves != ReversiBitboard::EMPTY) {
+            size += sortMoves(own, enemies, moves, squares + size, sortByMobility);
+            moves = ReversiBitboard::EMPTY;
+        }
+    }
+    if (tableNode) {
+        storeTable(key, symmetry, square, maxval, depth, oldAlpha, beta);
     }
+    return maxval;
 }
 
 //--------------------------------------------------------------------------------
 
-int ReversiMiniMax::evaluate(ReversiGameData & data) {
-    if (data.GameOver()) {
-        if (data.Winner() == ReversiGameData::AI_WINNER) {
-            return INITIAL_BETA;
-        } else if (data.Winner() == ReversiGameData::BOTH_SIDES) {
-            return 0;
+int ReversiMiniMax::solve(Bitboard own, Bitboard enemies, int empties, int alpha, int beta,
+    bool passed) {
+    // The exact search returns the final difference of pieces with a perfect game.
+    ++stats.nodes;
+    if (cancelled()) return 0;
+
+    Bitboard moves = ReversiBitboard::GetMoves(own, enemies);
+    if (moves == ReversiBitboard::EMPTY) {
+        if (passed) {
+            return ReversiBitboard::Count(own) - ReversiBitboard::Count(enemies);
         } else {
-            return INITIAL_ALPHA;
+            return -solve(enemies, own, empties, -beta, -alpha, true);
         }
-    } else {
-        int result = 0;
-        int machineSide = data.GetOppositeSide(data.PlayerSide());
-        if (data.Difficulty() == ReversiGameData::EASY_LEVEL) {
-            const int NORMAL_VALUE = 1;
-            data.ForEachInBoard([&] (int victim, int i, int j) {
-                if (victim == machineSide) {
-                    result += NORMAL_VALUE;
-                } else {
-                    result -= NORMAL_VALUE;
+    }
+
+    // The number of empty squares is the depth of the exact scores in the table.
+    ReversiTranspositionTable::HashKey key = 0;
+    int symmetry = 0, square = ReversiBitboard::NO_SQUARE, score = 0;
+    bool tableNode = useTable && empties >= MIN_TABLE_EMPTIES;
+    if (tableNode && probeTable(own, enemies, empties, true, alpha, beta,
+        key, symmetry, square, score)) {
+        return score;
+    }
+
+    // The moves that leave fewer moves to the enemy are checked first (fastest first),
+    // because they usually get a cutoff before, but near the end it costs too much.
+    int squares[ReversiBitboard::MAX_SQUARES];
+    bool sortByMobility = empties > SORT_BY_MOBILITY_EMPTIES;
+    int size = getFirstMove(own, enemies, moves, squares, sortByMobility, square);
+    int maxval = -INFINITE_SCORE, oldAlpha = alpha;
+    square = ReversiBitboard::NO_SQUARE;
+    for (int i = 0; i < size; ++i) {
+        auto flips = ReversiBitboard::GetFlips(squares[i], own, enemies);
+        int actval = -solve(enemies & ~flips, own | flips | ReversiBitboard::GetMask(squares[i]),
+            empties - 1, -beta, -alpha, false);
+        if (maxval < actval) {
+            maxval = actval;
+            square = squares[i];
+            if (alpha < actval) {
+                alpha = actval;
+                if (alpha >= beta) {
+                    ++stats.cutoffs;
+                    break;
                 }
-            });
+            }
+        }
+        if (moves != ReversiBitboard::EMPTY) {
+            size += sortMoves(own, enemies, moves, squares + size, sortByMobility);
+            moves = ReversiBitboard::EMPTY;
+        }
+    }
+    if (tableNode) {
+        storeTable(key, symmetry, square, maxval, empties, oldAlpha, beta);
+    }
+    return maxval;
+}
+
+//--------------------------------------------------------------------------------
+
+int ReversiMiniMax::evaluate(Bitboard own, Bitboard enemies) {
+    Bitboard empty = ~(own | enemies);
+
+    // The mobility is the difference between the moves of each side.
+    int result = MOBILITY_VALUE * (ReversiBitboard::Count(ReversiBitboard::GetMoves(own, enemies)) -
+        ReversiBitboard::Count(ReversiBitboard::GetMoves(enemies, own)));
+
+    // The stable pieces can't be taken until the end of the game.
+    result += STABLE_VALUE * (ReversiBitboard::Count(ReversiBitboard::GetStables(own, enemies)) -
+        ReversiBitboard::Count(ReversiBitboard::GetStables(enemies, own)));
+
+    // The pieces next to the empty squares give moves to the enemy.
+    Bitboard frontier = ReversiBitboard::GetNeighbors(empty);
+    result += FRONTIER_VALUE * (ReversiBitboard::Count(own & frontier) -
+        ReversiBitboard::Count(enemies & frontier));
+
+    // The corners are the best squares, and the squares next to an empty corner
+    // are the worst ones.
+    for (int i = 0; i < MAX_CORNERS; ++i) {
+        if (own & CORNER_SQUARES[i]) {
+            result += CORNER_VALUE;
+        } else if (enemies & CORNER_SQUARES[i]) {
+            result -= CORNER_VALUE;
         } else {
-            data.ForEachInBoard([&] (int victim, int i, int j) {
-                if (victim == machineSide) {
-                    result += REVERSI_HEURISTIC[i][j];
-                } else {
-                    result -= REVERSI_HEURISTIC[i][j];
-                }
-            });
+            result += X_SQUARE_VALUE * (ReversiBitboard::Count(own & X_SQUARES[i]) -
+                ReversiBitboard::Count(enemies & X_SQUARES[i]));
+            result += C_SQUARE_VALUE * (ReversiBitboard::Count(own & C_SQUARES[i]) -
+                ReversiBitboard::Count(enemies & C_SQUARES[i]));
         }
-        return result;
+    }
+    return result;
+}
+
+//--------------------------------------------------------------------------------
+
+int ReversiMiniMax::evaluateEnd(Bitboard own, Bitboard enemies) {
+    // At the end of the game any victory is better than any other position.
+    int result = ReversiBitboard::Count(own) - ReversiBitboard::Count(enemies);
+    if (result > 0) {
+        return WIN_SCORE + result;
+    } else if (result < 0) {
+        return result - WIN_SCORE;
+    } else {
+        return 0;
     }
 }
 
@@ -215,7 +448,17 @@ int ReversiMiniMax::evaluate(ReversiGameData & data) {
 // Constructors, destructor and operators
 //********************************************************************************
 
-ReversiMiniMax::ReversiMiniMax() {}
+ReversiMiniMax::ReversiMiniMax() : maxDepth(0), maxEmpties(0), useTable(true),
+    thinkTask(nullptr), table(std::make_shared<ReversiTranspositionTable>()) {
+    stats.nodes = stats.tableHits = stats.cutoffs = 0;
+}
+
+//--------------------------------------------------------------------------------
+
+ReversiMiniMax::ReversiMiniMax(const std::shared_ptr<ReversiTranspositionTable> & sharedTable) :
+    maxDepth(0), maxEmpties(0), useTable(true), thinkTask(nullptr), table(sharedTable) {
+    stats.nodes = stats.tableHits = stats.cutoffs = 0;
+}
 
 //--------------------------------------------------------------------------------
 
@@ -23,9 +23,12 @@
 #ifndef __REVERSI_MINIMAX_HEADER__
 #define __REVERSI_MINIMAX_HEADER__
 
+#include <memory>
 #include <vector>
 #include <SFML/Graphics/Rect.hpp>
+#include <System/ThinkService.h>
 #include <Games/Reversi/ReversiGameData.h>
+#include <Games/Reversi/ReversiTranspositionTable.h>
 
 /**
  * This structure represents a move in the game.
@@ -48,21 +51,51 @@ struct ReversiMove {
 typedef std::vector<ReversiMove> ReversiMoveVector;
 
 /**
- * This class represents the mini-max algorithm.
+ * This class represents the mini-max algorithm. The search works with the bitboards
+ * of the side to move and its enemy, and the evaluation uses the mobility, the
+ * stable pieces and the corners. The last empty squares of the game are solved
+ * exactly, to get the best final difference of pieces. The search uses iterative
+ * deepening, and the transposition table keeps the scores and the best moves of
+ * the positions to check the best move of the previous iteration first. The table
+ * can be shared between the solvers of the moves of the same game.
  */
 class ReversiMiniMax {
 public:
+    //--------------------------------------------------------------------------------
+    // Types
+    //--------------------------------------------------------------------------------
+
+    typedef ReversiBitboard::Bitboard Bitboard;
+
+    struct Statistics {
+        long long nodes;     // The number of visited positions.
+        long long tableHits; // The positions solved with the transposition table.
+        long long cutoffs;   // The positions pruned by the alpha-beta algorithm.
+    };
+
+    //--------------------------------------------------------------------------------
+    // Properties
+    //--------------------------------------------------------------------------------
+
+    const Statistics & Stats() const { return stats; }
+
+    bool UseTable() const { return useTable; }
+    void UseTable(bool value) { useTable = value; }
+
     //--------------------------------------------------------------------------------
     // Methods
     //--------------------------------------------------------------------------------
 
-    ReversiMove Execute(ReversiGameData & data);
+    ReversiMove Execute(const ReversiGameData & data, const ThinkTask * task = nullptr);
+    ReversiMove Execute(const ReversiGameData & data, int depth, int empties,
+        const ThinkTask * task = nullptr);
 
     //--------------------------------------------------------------------------------
     // Constructors, destructor and operators
     //--------------------------------------------------------------------------------
 
     ReversiMiniMax();
+    ReversiMiniMax(const std::shared_ptr<ReversiTranspositionTable> & sharedTable);
     virtual ~ReversiMiniMax();
 
 private:
@@ -71,17 +104,31 @@ private:
     //--------------------------------------------------------------------------------
 
     int maxDepth;
+    int maxEmpties;
+    bool useTable;
+    const ThinkTask * thinkTask;
+    Statistics stats;
+    std::shared_ptr<ReversiTranspositionTable> table;
 
     //--------------------------------------------------------------------------------
     // Methods
     //--------------------------------------------------------------------------------
 
     void initialize(int difficulty);
-    void getAllMoves(ReversiGameData & data, ReversiMoveVector & moves);
-    ReversiMove minimax(ReversiGameData & data, int depth, int alpha, int beta);
-    int minimizer(ReversiGameData & data, int depth, int alpha, int beta);
-    int maximizer(ReversiGameData & data, int depth, int alpha, int beta);
-    int evaluate(ReversiGameData & data);
+    bool cancelled() const;
+    int sortMoves(Bitboard own, Bitboard enemies, Bitboard moves, int * squares,
+        bool sortByMobility);
+    int getFirstMove(Bitboard own, Bitboard enemies, Bitboard & moves, int * squares,
+        bool sortByMobility, int firstSquare);
+    void search(Bitboard own, Bitboard enemies, int * squares, int size, int depth, bool exact);
+    bool probeTable(Bitboard own, Bitboard enemies, int depth, bool exact, int alpha, int beta,
+        ReversiTranspositionTable::HashKey & key, int & symmetry, int & square, int & score);
+    void storeTable(ReversiTranspositionTable::HashKey key, int symmetry, int square,
+        int score, int depth, int alpha, int beta);
+    int minimax(Bitboard own, Bitboard enemies, int depth, int alpha, int beta, bool passed);
+    int solve(Bitboard own, Bitboard enemies, int empties, int alpha, int beta, bool passed);
+    int evaluate(Bitboard own, Bitboard enemies);
+    int evaluateEnd(Bitboard own, Bitboard enemies);
 };
 
 #endif
@@ -0,0 +1,207 @@
+/******************************************************************************
+ Copyright (c) 2014 Gorka Surez Garca
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ DEALINGS IN THE SOFTWARE.
+******************************************************************************/
+
+#include "ReversiTranspositionTable.h"
+#include <cstring>
+
+//********************************************************************************
+// Constants
+//********************************************************************************
+
+const int MEGABYTE = 1024 * 1024;
+
+//********************************************************************************
+// Methods (Public)
+//********************************************************************************
+
+void ReversiTranspositionTable::Resize(int megabytes) {
+    // Get the largest power of two number of buckets inside the size.
+    if (megabytes < 1) megabytes = 1;
+    HashKey count = 1;
+    while (count * 2 * sizeof(Bucket) <= static_cast<HashKey>(megabytes) * MEGABYTE) {
+        count *= 2;
+    }
+
+    // Align the buckets with the cache lines of the memory.
+    memory_.reset(new char[static_cast<size_t>(count * sizeof(Bucket)) + CACHE_LINE]);
+    auto address = reinterpret_cast<size_t>(memory_.get());
+    buckets_ = reinterpret_cast<Bucket *>((address + CACHE_LINE - 1) & ~(CACHE_LINE - 1));
+    mask_ = count - 1;
+    size_ = megabytes;
+    Clear();
+}
+
+//--------------------------------------------------------------------------------
+
+void ReversiTranspositionTable::Clear() {
+    std::memset(buckets_, 0, static_cast<size_t>((mask_ + 1) * sizeof(Bucket)));
+    age_ = 0;
+}
+
+//--------------------------------------------------------------------------------
+
+void ReversiTranspositionTable::NewSearch() {
+    age_ = (age_ + 1) & MAX_AGE;
+}
+
+//--------------------------------------------------------------------------------
+
+ReversiTranspositionTable::HashKey ReversiTranspositionTable::GetKey(Bitboard own,
+    Bitboard enemies, int & symmetry) const {
+    // Find the symmetry with the smallest boards, that is the same one for all the
+    // transformations of the position.
+    Bitboard minOwn = own, minEnemies = enemies;
+    symmetry = 0;
+    for (int i = 1; i < ReversiBitboard::MAX_SYMMETRIES; ++i) {
+        Bitboard auxOwn = ReversiBitboard::Transform(own, i);
+        if (auxOwn < minOwn || (auxOwn == minOwn &&
+            ReversiBitboard::Transform(enemies, i) < minEnemies)) {
+            minOwn = auxOwn;
+            minEnemies = ReversiBitboard::Transform(enemies, i);
+            symmetry = i;
+        }
+    }
+
+    // The Zobrist key of the boards is made with a byte of squares at a time.
+    HashKey key = 0ULL;
+    for (int i = 0; i < MAX_BYTES; ++i) {
+        key ^= keys_[0][i][static_cast<int>(minOwn >> (i * 8)) & 0xFF];
+        key ^= keys_[1][i][static_cast<int>(minEnemies >> (i * 8)) & 0xFF];
+    }
+    return key;
+}
+
+//--------------------------------------------------------------------------------
+
+bool ReversiTranspositionTable::Probe(HashKey key, int symmetry, Entry & victim) const {
+    auto & bucket = getBucket(key);
+    for (int i = 0; i < BUCKET_SLOTS; ++i) {
+        auto & slot = bucket.slots[i];
+        if (slot.key == key && slot.bound != BOUND_NONE) {
+            // The square is stored in the smallest board, so it's transformed back.
+            victim.square = untransformSquare(slot.square, symmetry);
+            victim.score = slot.score;
+            victim.depth = slot.depth;
+            victim.bound = slot.bound;
+            return true;
+        }
+    }
+    return false;
+}
+
+//--------------------------------------------------------------------------------
+
+void ReversiTranspositionTable::Store(HashKey key, int symmetry, int square, int score,
+    int depth, int bound) {
+    // Find the slot of the same position or the less valuable one, where the
+    // entries of the old searches are worse than any entry of the current one.
+    auto & bucket = getBucket(key);
+    Slot * victim = nullptr;
+    int worst = 0;
+    square = transformSquare(square, symmetry);
+    for (int i = 0; i < BUCKET_SLOTS; ++i) {
+        auto & slot = bucket.slots[i];
+        if (slot.key == key && slot.bound != BOUND_NONE) {
+            // Keep the previous best move when the new search doesn't find one, and
+            // the deeper result of an old search is still valid for the current one.
+            if (square == ReversiBitboard::NO_SQUARE) square = slot.square;
+            if (bound != BOUND_EXACT && slot.depth > depth) {
+                slot.age = static_cast<unsigned char>(age_);
+                return;
+            }
+            victim = &slot;
+            break;
+        }
+        int value = slot.depth - ((age_ - slot.age) & MAX_AGE) * 256;
+        if (victim == nullptr || value < worst) {
+            victim = &slot;
+            worst = value;
+        }
+    }
+
+    victim->key = key;
+    victim->score = score;
+    victim->square = static_cast<signed char>(square);
+    victim->depth = static_cast<unsigned char>(depth);
+    victim->bound = static_cast<unsigned char>(bound);
+    victim->age = static_cast<unsigned char>(age_);
+}
+
+//********************************************************************************
+// Methods (Private)
+//********************************************************************************
+
+int ReversiTranspositionTable::transformSquare(int square, int symmetry) {
+    if (square == ReversiBitboard::NO_SQUARE) return square;
+    return ReversiBitboard::First(ReversiBitboard::Transform(
+        ReversiBitboard::GetMask(square), symmetry));
+}
+
+//--------------------------------------------------------------------------------
+
+int ReversiTranspositionTable::untransformSquare(int square, int symmetry) {
+    if (square == ReversiBitboard::NO_SQUARE) return square;
+    return ReversiBitboard::First(ReversiBitboard::Untransform(
+        ReversiBitboard::GetMask(square), symmetry));
+}
+
+//--------------------------------------------------------------------------------
+
+void ReversiTranspositionTable::initializeKeys() {
+    // A fixed seed xorshift generator, so the keys are the same in every run.
+    HashKey seed = 0x2545F4914F6CDD1DULL;
+    auto random = [&] () -> HashKey {
+        seed ^= seed >> 12; seed ^= seed << 25; seed ^= seed >> 27;
+        return seed * 2685821657736338717ULL;
+    };
+
+    // Each square has a random key for each side, and the key of a byte of squares
+    // is the xor of the keys of its pieces.
+    for (int i = 0; i < MAX_SIDES; ++i) {
+        for (int j = 0; j < MAX_BYTES; ++j) {
+            HashKey squares[8];
+            for (int k = 0; k < 8; ++k) {
+                squares[k] = random();
+            }
+            for (int value = 0; value < MAX_VALUES; ++value) {
+                keys_[i][j][value] = 0ULL;
+                for (int k = 0; k < 8; ++k) {
+                    if (value & (1 << k)) keys_[i][j][value] ^= squares[k];
+                }
+            }
+        }
+    }
+}
+
+//********************************************************************************
+// Constructors, destructor and operators
+//********************************************************************************
+
+ReversiTranspositionTable::ReversiTranspositionTable() : size_(0), buckets_(nullptr),
+    mask_(0), age_(0) {
+    initializeKeys();
+    Resize(DEFAULT_SIZE);
+}
+
+//--------------------------------------------------------------------------------
+
+ReversiTranspositionTable::~ReversiTranspositionTable() {}
@@ -0,0 +1,137 @@
+/******************************************************************************
+ Copyright (c) 2014 Gorka Surez Garca
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ DEALINGS IN THE SOFTWARE.
+******************************************************************************/
+
+#ifndef __REVERSI_TRANSPOSITION_TABLE_HEADER__
+#define __REVERSI_TRANSPOSITION_TABLE_HEADER__
+
+#include <memory>
+#include <Games/Reversi/ReversiBitboard.h>
+
+/**
+ * This class represents a cache of searched positions, indexed by their Zobrist
+ * keys. The eight symmetries of a position share the same entry, because the key
+ * is taken from the smallest transformed board and the moves are stored with it.
+ * Each bucket of entries fills a cache line. The table can be kept between the
+ * moves of a game, and the entries of the old searches are replaced first.
+ */
+class ReversiTranspositionTable {
+public:
+    //--------------------------------------------------------------------------------
+    // Types
+    //--------------------------------------------------------------------------------
+
+    typedef ReversiBitboard::Bitboard Bitboard;
+    typedef unsigned long long HashKey;
+
+    struct Entry {
+        int square, score, depth, bound;
+    };
+
+    //--------------------------------------------------------------------------------
+    // Constants
+    //--------------------------------------------------------------------------------
+
+    static const int DEFAULT_SIZE = 4;
+
+    static const int BOUND_NONE  = 0;
+    static const int BOUND_UPPER = 1;
+    static const int BOUND_LOWER = 2;
+    static const int BOUND_EXACT = 3;
+
+    //--------------------------------------------------------------------------------
+    // Properties
+    //--------------------------------------------------------------------------------
+
+    int Size() const { return size_; }
+
+    //--------------------------------------------------------------------------------
+    // Methods
+    //--------------------------------------------------------------------------------
+
+    void Resize(int megabytes);
+    void Clear();
+    void NewSearch();
+
+    HashKey GetKey(Bitboard own, Bitboard enemies, int & symmetry) const;
+
+    bool Probe(HashKey key, int symmetry, Entry & victim) const;
+    void Store(HashKey key, int symmetry, int square, int score, int depth, int bound);
+
+    //--------------------------------------------------------------------------------
+    // Constructors, destructor and operators
+    //--------------------------------------------------------------------------------
+
+    ReversiTranspositionTable();
+    ~ReversiTranspositionTable();
+
+private:
+    //--------------------------------------------------------------------------------
+    // Constants
+    //--------------------------------------------------------------------------------
+
+    static const int MAX_SIDES    =   2;
+    static const int MAX_BYTES    =   8;
+    static const int MAX_VALUES   = 256;
+    static const int BUCKET_SLOTS =   4;
+    static const int CACHE_LINE   =  64;
+    static const int MAX_AGE      = 255;
+
+    //--------------------------------------------------------------------------------
+    // Types
+    //--------------------------------------------------------------------------------
+
+    struct Slot {
+        HashKey key;
+        int score;
+        signed char square;
+        unsigned char depth;
+        unsigned char bound;
+        unsigned char age;
+    };
+
+    struct Bucket {
+        Slot slots[BUCKET_SLOTS];
+    };
+
+    //--------------------------------------------------------------------------------
+    // Fields
+    //--------------------------------------------------------------------------------
+
+    int size_;
+    std::unique_ptr<char[]> memory_;
+    Bucket * buckets_;
+    HashKey mask_;
+    int age_;
+    HashKey keys_[MAX_SIDES][MAX_BYTES][MAX_VALUES];
+
+    //--------------------------------------------------------------------------------
+    // Methods
+    //--------------------------------------------------------------------------------
+
+    Bucket & getBucket(HashKey key) const { return buckets_[key & mask_]; }
+
+    static int transformSquare(int square, int symmetry);
+    static int untransformSquare(int square, int symmetry);
+    void initializeKeys();
+};
+
+#endif
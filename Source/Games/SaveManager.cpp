@@ -152,7 +152,9 @@ void SaveManager::InnerData::Load() {
                 file.Read(checkers.saves.data_[i].data.nextPieceToMove_.x);
                 file.Read(checkers.saves.data_[i].data.nextPieceToMove_.y);
                 checkers.saves.data_[i].data.ForEachInBoard([&] (int, int r, int c) {
-                    file.Read(checkers.saves.data_[i].data.board_[r][c]);
+                    int item = CheckersGameData::EMPTY_CELL;
+                    file.Read(item);
+                    checkers.saves.data_[i].data.setCell(r, c, item);
                 });
                 int candidatesSize = 0;
                 file.Read(candidatesSize);
@@ -178,7 +180,9 @@ void SaveManager::InnerData::Load() {
                 file.Read(reversi.saves.data_[i].data.whiteSideBlocked_);
                 file.Read(reversi.saves.data_[i].data.blackSideBlocked_);
                 reversi.saves.data_[i].data.ForEachInBoard([&] (int, int r, int c) {
-                    file.Read(reversi.saves.data_[i].data.board_[r][c]);
+                    int item = ReversiGameData::EMPTY_CELL;
+                    file.Read(item);
+                    reversi.saves.data_[i].data.setCell(r, c, item);
                 });
                 int candidatesSize = 0;
                 file.Read(candidatesSize);
@@ -207,6 +211,7 @@ void SaveManager::InnerData::Load() {
                         file.Read(chess.saves.data_[i].data.pieces_[idx]);
                     }
                 );
+                chess.saves.data_[i].data.updateBoard();
             }
 
             //PuckmanSaveData
@@ -22,14 +22,8 @@
 
 #include "BitmapFont.h"
 #include <SFML/Graphics.hpp>
-#include <System/CoreManager.h>
 #include <System/ForEach.h>
-
-//********************************************************************************
-// Static
-//********************************************************************************
-
-SharedRenderWindow BitmapFont::renderWindow_ = nullptr;
+#include <System/SpriteBatch.h>
 
 //********************************************************************************
 // Methods
@@ -39,8 +33,6 @@ SharedRenderWindow BitmapFont::renderWindow_ = nullptr;
  * Loads a font from a file.
  */
 bool BitmapFont::Load(const std::string & path, int texRows, int texCols) {
-    renderWindow_ = CoreManager::Instance()->window_;
-
     // Load the texture from the file.
     texture_ = std::make_shared<sf::Texture>();
     if (!texture_->loadFromFile(path)) {
@@ -49,9 +41,6 @@ bool BitmapFont::Load(const std::string & path, int texRows, int texCols) {
     }
     texture_->setSmooth(false);
 
-    // Create the sprite of the font.
-    sprite_ = std::make_shared<sf::Sprite>(*texture_);
-
     // Get the sizes of the texture.
     auto size = texture_->getSize();
     width_ = size.x / texCols;
@@ -75,10 +64,10 @@ bool BitmapFont::Load(const std::string & path, int texRows, int texCols) {
  * Unloads the current font.
  */
 void BitmapFont::Unload() {
+    SpriteBatch::Release(texture_.get());
     width_ = 0;
     height_ = 0;
     sources_.clear();
-    sprite_ = nullptr;
     texture_ = nullptr;
 }
 
@@ -176,16 +165,28 @@ void BitmapFont::Draw(const std::string & text, int x, int y, const sf::Color &
 
 //--------------------------------------------------------------------------------
 
+/**
+ * Adds the quad of a character to a vertex array.
+ */
+bool BitmapFont::Append(sf::VertexArray & victim, char item, int x, int y, const sf::Color & color) {
+    unsigned int index = static_cast<unsigned int>(item) & 0xFF;
+    if (0 <= index && index < sources_.size()) {
+        SpriteBatch::AppendQuad(victim, sources_[index], x, y, color);
+        return true;
+    } else {
+        return false;
+    }
+}
+
+//--------------------------------------------------------------------------------
+
 /**
  * Draws a character on the screen.
  */
 void BitmapFont::draw(char item, int x, int y, const sf::Color & color) {
     unsigned int index = static_cast<unsigned int>(item) & 0xFF;
     if (0 <= index && index < sources_.size()) {
-        sprite_->setColor(color);
-        sprite_->setPosition((float)x, (float)y);
-        sprite_->setTextureRect(sources_[index]);
-        renderWindow_->draw(*sprite_);
+        SpriteBatch::Draw(texture_.get(), sources_[index], x, y, color);
     }
 }
 
@@ -196,8 +197,8 @@ void BitmapFont::draw(char item, int x, int y, const sf::Color & color) {
 /**
  * Constructs a new object.
  */
-BitmapFont::BitmapFont() : texture_(nullptr), sprite_(nullptr), width_(0),
-    height_(0), sources_() {}
+BitmapFont::BitmapFont() : texture_(nullptr), width_(0), height_(0),
+    sources_() {}
 
 //--------------------------------------------------------------------------------
 
@@ -224,7 +225,6 @@ BitmapFont::~BitmapFont() {
  */
 BitmapFont & BitmapFont::operator =(const BitmapFont & source) {
     texture_ = source.texture_;
-    sprite_ = source.sprite_;
     width_ = source.width_;
     height_ = source.height_;
     sources_ = source.sources_;
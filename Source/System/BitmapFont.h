@@ -27,10 +27,12 @@
 #include <string>
 #include <SFML/Graphics/Rect.hpp>
 #include <SFML/Graphics/Color.hpp>
+#include <SFML/Graphics/VertexArray.hpp>
 #include <System/SharedTypes.h>
 
 /**
- * This class represents a bitmap font.
+ * This class represents a bitmap font. The characters are drawn through the
+ * sprite batch, so a run of text is drawn with a single call.
  */
 class BitmapFont {
 public:
@@ -48,6 +50,7 @@ public:
 
     int Width() const { return width_; }
     int Height() const { return height_; }
+    const sf::Texture * Texture() const { return texture_.get(); }
 
     //--------------------------------------------------------------------------------
     // Methods
@@ -61,6 +64,7 @@ public:
     int GetTextHeight(std::string text);
     void Draw(char item, int x, int y, const sf::Color & color = sf::Color::White);
     void Draw(const std::string & text, int x, int y, const sf::Color & color = sf::Color::White);
+    bool Append(sf::VertexArray & victim, char item, int x, int y, const sf::Color & color = sf::Color::White);
 
     //--------------------------------------------------------------------------------
     // Constructors, destructor and operators
@@ -83,7 +87,6 @@ private:
     //--------------------------------------------------------------------------------
 
     SharedTexture texture_; // The texture.
-    SharedSprite sprite_;   // The sprite.
     int width_;             // The width.
     int height_;            // The height.
     IntRectVector sources_; // The source rectangles.
@@ -93,12 +96,6 @@ private:
     //--------------------------------------------------------------------------------
 
     void draw(char item, int x, int y, const sf::Color & color);
-
-    //--------------------------------------------------------------------------------
-    // Static
-    //--------------------------------------------------------------------------------
-
-    static SharedRenderWindow renderWindow_;
 };
 
 #endif
@@ -29,7 +29,9 @@
 #include <System/BitmapFont.h>
 #include <System/Keyboard.h>
 #include <System/Sound.h>
+#include <System/SpriteBatch.h>
 #include <System/MusicManager.h>
+#include <System/ThinkService.h>
 #include <Menu/RetroStartState.h>
 
 //********************************************************************************
@@ -40,6 +42,8 @@ const std::string CoreManager::TITLE  = "Gorkinovich Amateur Games Collection";
 
 const bool CoreManager::CURSOR_VISIBLE = true;
 const unsigned int CoreManager::MAX_FPS = 30;
+const unsigned int CoreManager::UPDATE_RATE = 60;
+const unsigned int CoreManager::MAX_UPDATES = 5;
 
 const int CoreManager::LOW_WIDTH = 640;
 const int CoreManager::LOW_HEIGHT = 360;
@@ -84,6 +88,11 @@ bool CoreManager::Initialize() {
     window_->setFramerateLimit(MAX_FPS);
     DisableKeyboardTextInput();
 
+    // Configure the fixed step of the logic.
+    UpdateRate(UPDATE_RATE);
+    MaxUpdates(MAX_UPDATES);
+    interpolation_ = 0.0f;
+
     // Configure the fonts of the game.
     retro70Font_.reset(new BitmapFont());
     retro80Font_.reset(new BitmapFont());
@@ -95,6 +104,9 @@ bool CoreManager::Initialize() {
     MusicManager::Instance()->Initialize();
     musicPaused_ = false;
 
+    // Configure the threads to think the moves of the machine.
+    ThinkService::Instance()->Initialize(ProcessorCount());
+
     // Set the current state of the game.
     nextState_ = nullptr;
     changeState(MakeSharedState<RetroStartState>());
@@ -109,6 +121,7 @@ bool CoreManager::Initialize() {
  * Releases the data of the object.
  */
 void CoreManager::Release() {
+    ThinkService::Instance()->Release();
     DisableKeyboardTextInput();
     window_ = nullptr;
 }
@@ -121,53 +134,72 @@ void CoreManager::Release() {
 void CoreManager::Run() {
     // Set the time and sound controller variables.
     sf::Clock clock;
-    sf::Time timeDelta;
+    sf::Time timeDelta, accumulator;
+    unsigned int stepIndex = 0;
     bool soundMute = false;
     auto * music = MusicManager::Instance();
+    // The states use the steps in milliseconds, so each step has a whole number of
+    // milliseconds and the steps inside a second add up to exactly one second.
+    auto getStep = [&] () -> sf::Time {
+        stepIndex %= updateRate_;
+        return sf::milliseconds((stepIndex + 1) * 1000 / updateRate_ -
+            stepIndex * 1000 / updateRate_);
+    };
     // Execute the main loop of the game.
     while (window_->isOpen()) {
-        // Update the time delta.
-        timeDelta = clock.getElapsedTime();
-        clock.restart();
-        // Update events.
-        pollEvents();
-        UpdateMousePosition();
-        Keyboard::Update();
-        // Control the sound volume.
-        if (Keyboard::IsKeyUp(Keyboard::F12)) {
-            if (soundMute) {
-                Sound::GlobalVolumeFull();
-                soundMute = false;
-            } else {
-                Sound::GlobalVolumeMute();
-                soundMute = true;
-            }
-        } else if (Keyboard::IsKeyUp(Keyboard::F11)) {
-            if (music->IsPaused()) {
-                music->Play();
-                musicPaused_ = false;
-            } else {
-                music->Pause();
-                musicPaused_ = true;
+        // Update the time delta and the time left to simulate, but after a slow
+        // frame only the maximum number of steps will be simulated.
+        auto step = getStep();
+        auto maxTime = sf::milliseconds(maxUpdates_ * 1000 / updateRate_);
+        timeDelta = clock.restart();
+        accumulator += timeDelta;
+        if (accumulator > maxTime) accumulator = maxTime;
+        // Update the logic with a fixed step, reading the input once per step.
+        while (window_->isOpen() && accumulator >= step) {
+            accumulator -= step;
+            // Update events.
+            pollEvents();
+            UpdateMousePosition();
+            Keyboard::Update();
+            // Control the sound volume.
+            if (Keyboard::IsKeyUp(Keyboard::F12)) {
+                if (soundMute) {
+                    Sound::GlobalVolumeFull();
+                    soundMute = false;
+                } else {
+                    Sound::GlobalVolumeMute();
+                    soundMute = true;
+                }
+            } else if (Keyboard::IsKeyUp(Keyboard::F11)) {
+                if (music->IsPaused()) {
+                    music->Play();
+                    musicPaused_ = false;
+                } else {
+                    music->Pause();
+                    musicPaused_ = true;
+                }
+            } else if (Keyboard::IsKeyUp(Keyboard::F10)) {
+                music->NextSong();
             }
-        } else if (Keyboard::IsKeyUp(Keyboard::F10)) {
-            music->NextSong();
-        }
-        // If the window is opened, we'll draw and update the logic.
-        if (window_->isOpen() && currentState_) {
-            // Draw the current state.
-            window_->clear(clearColor_);
-            currentState_->Draw(timeDelta);
-            window_->display();
             // If the window has the focus, we'll update the logic.
-            if (focus_) {
-                currentState_->Update(timeDelta);
-                music->Update(timeDelta);
+            if (window_->isOpen() && currentState_ && focus_) {
+                currentState_->Update(step);
+                music->Update(step);
                 if (nextState_) {
                     changeState(nextState_);
                     nextState_ = nullptr;
                 }
             }
+            ++stepIndex;
+            step = getStep();
+        }
+        // If the window is opened, we'll draw the current state.
+        if (window_->isOpen() && currentState_) {
+            interpolation_ = accumulator.asSeconds() / step.asSeconds();
+            window_->clear(clearColor_);
+            currentState_->Draw(timeDelta);
+            SpriteBatch::Flush();
+            window_->display();
         }
     }
 }
@@ -255,11 +287,22 @@ void CoreManager::changeState(SharedState & state) {
  * Draws something on the screen.
  */
 void CoreManager::Draw(const sf::Drawable & victim) {
+    SpriteBatch::Flush();
     window_->draw(victim);
 }
 
 //--------------------------------------------------------------------------------
 
+/**
+ * Draws something on the screen with some render states.
+ */
+void CoreManager::Draw(const sf::Drawable & victim, const sf::RenderStates & states) {
+    SpriteBatch::Flush();
+    window_->draw(victim, states);
+}
+
+//--------------------------------------------------------------------------------
+
 /**
  * Sets the clear color of the screen.
  */
@@ -438,7 +481,8 @@ CoreManager::CoreManager() : window_(nullptr), clearColor_(sf::Color::Black),
     mousePosition_(0, 0), focus_(true), keyboardTextInputEnable_(false),
     keyboardText_(""), nextState_(nullptr), currentState_(nullptr),
     language_(TEXT_LANGUAGE_ENGLISH), retro70Font_(nullptr),
-    retro80Font_(nullptr), musicPaused_(false) {}
+    retro80Font_(nullptr), musicPaused_(false), updateRate_(UPDATE_RATE),
+    maxUpdates_(MAX_UPDATES), interpolation_(0.0f) {}
 
 //--------------------------------------------------------------------------------
 
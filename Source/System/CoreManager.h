@@ -32,6 +32,7 @@
 
 namespace sf {
     class Drawable;
+    class RenderStates;
 }
 
 class BitmapFont;
@@ -46,8 +47,7 @@ enum TextLanguage {
  */
 class CoreManager {
 public:
-    friend class Texture2D;
-    friend class BitmapFont;
+    friend class SpriteBatch;
 
     //--------------------------------------------------------------------------------
     // Constants
@@ -57,6 +57,8 @@ public:
 
     static const bool CURSOR_VISIBLE;
     static const unsigned int MAX_FPS;
+    static const unsigned int UPDATE_RATE;
+    static const unsigned int MAX_UPDATES;
 
     static const int LOW_WIDTH;
     static const int LOW_HEIGHT;
@@ -81,6 +83,16 @@ public:
     BitmapFont * Retro70Font() { return retro70Font_.get(); }
     BitmapFont * Retro80Font() { return retro80Font_.get(); }
 
+    unsigned int UpdateRate() const { return updateRate_; }
+    void UpdateRate(unsigned int value) {
+        updateRate_ = value < 1 ? 1 : (value > 1000 ? 1000 : value);
+    }
+
+    unsigned int MaxUpdates() const { return maxUpdates_; }
+    void MaxUpdates(unsigned int value) { maxUpdates_ = value > 0 ? value : 1; }
+
+    float Interpolation() const { return interpolation_; }
+
     //--------------------------------------------------------------------------------
     // Methods
     //--------------------------------------------------------------------------------
@@ -96,6 +108,7 @@ public:
 
     // Draw
     void Draw(const sf::Drawable & victim);
+    void Draw(const sf::Drawable & victim, const sf::RenderStates & states);
     void SetClearColor(const sf::Color & value = sf::Color::Black);
     SharedTexture LoadTexture(const std::string & path, bool smooth = false);
     SharedImage LoadImage(const std::string & path);
@@ -123,6 +136,7 @@ public:
 
     // Util
     void OpenURL(const std::string & url);
+    int ProcessorCount();
 
     //--------------------------------------------------------------------------------
     // Singleton pattern
@@ -152,6 +166,10 @@ private:
 
     bool musicPaused_;
 
+    unsigned int updateRate_;   // The number of logic updates per second.
+    unsigned int maxUpdates_;   // The maximum number of logic updates per frame.
+    float interpolation_;       // The fraction of an update step left to draw.
+
     //--------------------------------------------------------------------------------
     // Methods
     //--------------------------------------------------------------------------------
@@ -77,3 +77,19 @@ void CoreManager::OpenURL(const std::string & url) {
     } catch(...) {
     }
 }
+
+//--------------------------------------------------------------------------------
+
+/**
+ * Gets the number of processors of the machine.
+ */
+int CoreManager::ProcessorCount() {
+#if defined(WIN32)
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    int count = static_cast<int>(info.dwNumberOfProcessors);
+#else
+    int count = static_cast<int>(sysconf(_SC_NPROCESSORS_ONLN));
+#endif
+    return count > 0 ? count : 1;
+}
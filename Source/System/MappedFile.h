@@ -0,0 +1,67 @@
+/******************************************************************************
+ Copyright (c) 2014 Gorka Surez Garca
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ DEALINGS IN THE SOFTWARE.
+******************************************************************************/
+
+#ifndef __MAPPED_FILE_HEADER__
+#define __MAPPED_FILE_HEADER__
+
+#include <string>
+
+/**
+ * This class represents a read only file mapped in the memory, so the operating
+ * system loads only the pages that are used and shares them between processes.
+ */
+class MappedFile {
+public:
+    //--------------------------------------------------------------------------------
+    // Properties
+    //--------------------------------------------------------------------------------
+
+    bool IsOpen() const { return data_ != nullptr; }
+    const char * Data() const { return data_; }
+    size_t Size() const { return size_; }
+
+    //--------------------------------------------------------------------------------
+    // Methods
+    //--------------------------------------------------------------------------------
+
+    bool Open(const std::string & path);
+    void Close();
+
+    //--------------------------------------------------------------------------------
+    // Constructors, destructor and operators
+    //--------------------------------------------------------------------------------
+
+    MappedFile();
+    ~MappedFile();
+
+private:
+    //--------------------------------------------------------------------------------
+    // Fields
+    //--------------------------------------------------------------------------------
+
+    const char * data_;
+    size_t size_;
+    void * file_;
+    void * mapping_;
+};
+
+#endif
@@ -0,0 +1,91 @@
+/******************************************************************************
+ Copyright (c) 2014 Gorka Surez Garca
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ DEALINGS IN THE SOFTWARE.
+******************************************************************************/
+
+#include "SpriteBatch.h"
+#include <SFML/Graphics/RenderWindow.hpp>
+#include <System/CoreManager.h>
+
+//********************************************************************************
+// Static
+//********************************************************************************
+
+const sf::Texture * SpriteBatch::texture_ = nullptr;
+sf::VertexArray SpriteBatch::vertices_(sf::Quads);
+
+//********************************************************************************
+// Methods
+//********************************************************************************
+
+/**
+ * Adds a quad to the batch.
+ */
+void SpriteBatch::Draw(const sf::Texture * texture, const sf::IntRect & source,
+    int x, int y, const sf::Color & color) {
+    // The quads of another texture must be drawn before this one.
+    if (texture_ != texture) {
+        Flush();
+        texture_ = texture;
+    }
+    AppendQuad(vertices_, source, x, y, color);
+}
+
+//--------------------------------------------------------------------------------
+
+/**
+ * Draws the quads of the batch on the screen. This must be called before anything
+ * else is drawn, to keep the order of the drawing.
+ */
+void SpriteBatch::Flush() {
+    if (vertices_.getVertexCount() > 0) {
+        CoreManager::Instance()->window_->draw(vertices_, sf::RenderStates(texture_));
+        vertices_.clear();
+    }
+    texture_ = nullptr;
+}
+
+//--------------------------------------------------------------------------------
+
+/**
+ * Draws the quads of the batch when they use a texture that is going to be released.
+ */
+void SpriteBatch::Release(const sf::Texture * texture) {
+    if (texture != nullptr && texture_ == texture) {
+        Flush();
+    }
+}
+
+//--------------------------------------------------------------------------------
+
+/**
+ * Adds a textured quad to a vertex array.
+ */
+void SpriteBatch::AppendQuad(sf::VertexArray & victim, const sf::IntRect & source,
+    int x, int y, const sf::Color & color) {
+    float left = (float)x, top = (float)y;
+    float right = (float)(x + source.width), bottom = (float)(y + source.height);
+    float u1 = (float)source.left, v1 = (float)source.top;
+    float u2 = (float)(source.left + source.width), v2 = (float)(source.top + source.height);
+    victim.append(sf::Vertex(sf::Vector2f(left, top), color, sf::Vector2f(u1, v1)));
+    victim.append(sf::Vertex(sf::Vector2f(right, top), color, sf::Vector2f(u2, v1)));
+    victim.append(sf::Vertex(sf::Vector2f(right, bottom), color, sf::Vector2f(u2, v2)));
+    victim.append(sf::Vertex(sf::Vector2f(left, bottom), color, sf::Vector2f(u1, v2)));
+}
@@ -0,0 +1,65 @@
+/******************************************************************************
+ Copyright (c) 2014 Gorka Surez Garca
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ DEALINGS IN THE SOFTWARE.
+******************************************************************************/
+
+#ifndef __SPRITE_BATCH_HEADER__
+#define __SPRITE_BATCH_HEADER__
+
+#include <SFML/Graphics/Rect.hpp>
+#include <SFML/Graphics/Color.hpp>
+#include <SFML/Graphics/VertexArray.hpp>
+
+namespace sf {
+    class Texture;
+}
+
+/**
+ * This static class represents a batch of textured quads. The quads that use the
+ * same texture are stored in one vertex array, and when another texture comes
+ * the batch is drawn, so the order of the drawing is kept. The sheets shared by
+ * many surfaces work as atlases, drawing all their tiles with a single call.
+ */
+class SpriteBatch {
+public:
+    //--------------------------------------------------------------------------------
+    // Methods
+    //--------------------------------------------------------------------------------
+
+    static void Draw(const sf::Texture * texture, const sf::IntRect & source,
+        int x, int y, const sf::Color & color = sf::Color::White);
+    static void Flush();
+    static void Release(const sf::Texture * texture);
+    static void AppendQuad(sf::VertexArray & victim, const sf::IntRect & source,
+        int x, int y, const sf::Color & color = sf::Color::White);
+
+private:
+    SpriteBatch() {}
+    ~SpriteBatch() {}
+
+    //--------------------------------------------------------------------------------
+    // Static
+    //--------------------------------------------------------------------------------
+
+    static const sf::Texture * texture_; // The texture of the quads in the batch.
+    static sf::VertexArray vertices_;    // The vertices of the quads in the batch.
+};
+
+#endif
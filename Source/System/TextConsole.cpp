@@ -44,8 +44,9 @@ void TextConsole::CursorPosition(const sf::Vector2i & value) {
  * Sets the font of the text console.
  */
 void TextConsole::SetCurrentFont(BitmapFont * value) {
-    if (value != nullptr) {
+    if (value != nullptr && value != currentFont_) {
         currentFont_ = value;
+        invalidate();
     }
 }
 
@@ -65,6 +66,7 @@ void TextConsole::createTextBuffer(int columns, int rows) {
         width_ = 0;
         height_ = 0;
     }
+    invalidate();
 }
 
 //--------------------------------------------------------------------------------
@@ -113,6 +115,7 @@ void TextConsole::ClearScreen(const sf::Color & clearColor) {
         cell.CharData = '\0';
         cell.BackgroundColor = clearColor;
     }
+    invalidate();
 }
 
 //--------------------------------------------------------------------------------
@@ -136,6 +139,7 @@ void TextConsole::ClearLine(int row, const sf::Color & clearColor) {
             cell.CharData = '\0';
             cell.BackgroundColor = clearColor;
         }
+        invalidate(row, 0, columns_, 1);
     }
 }
 
@@ -149,6 +153,7 @@ void TextConsole::writeCell(int i, int j, char item) {
     cell.CharData = item;
     cell.ForegroundColor = foregroundColor_;
     cell.BackgroundColor = backgroundColor_;
+    invalidate(i, j, 1, 1);
 }
 
 //--------------------------------------------------------------------------------
@@ -204,6 +209,7 @@ void TextConsole::NewLine() {
             cell.CharData = '\0';
             cell.BackgroundColor = clearColor_;
         }
+        invalidate();
     } else {
         cursorPosition_.y = nextY;
     }
@@ -244,29 +250,126 @@ void TextConsole::WriteLine(const std::string & text) {
 
 //--------------------------------------------------------------------------------
 
+/**
+ * Marks the whole text buffer to rasterize it again.
+ */
+void TextConsole::invalidate() {
+    dirtyAreas_.clear();
+    dirtyAreas_.push_back(sf::IntRect(0, 0, columns_, rows_));
+}
+
+//--------------------------------------------------------------------------------
+
+/**
+ * Marks an area of the text buffer to rasterize it again.
+ */
+void TextConsole::invalidate(int row, int col, int width, int height) {
+    sf::IntRect area(col, row, width, height);
+    // When the last area ends where the new one starts, we'll extend the last one.
+    if (!dirtyAreas_.empty()) {
+        sf::IntRect & last = dirtyAreas_.back();
+        if (last.top == area.top && last.height == area.height &&
+            last.left + last.width == area.left) {
+            last.width += area.width;
+            return;
+        }
+    }
+    // When another area already contains the new one, we don't have to add it.
+    for (int k = 0, len = dirtyAreas_.size(); k < len; ++k) {
+        const sf::IntRect & victim = dirtyAreas_[k];
+        if (victim.left <= area.left && area.left + area.width <= victim.left + victim.width &&
+            victim.top <= area.top && area.top + area.height <= victim.top + victim.height) {
+            return;
+        }
+    }
+    // And when there are too many areas, we'll rasterize the whole text buffer.
+    if (static_cast<int>(dirtyAreas_.size()) >= rows_) {
+        invalidate();
+    } else {
+        dirtyAreas_.push_back(area);
+    }
+}
+
+//--------------------------------------------------------------------------------
+
+/**
+ * Updates the render texture to the size of the text buffer.
+ */
+bool TextConsole::updateTarget() {
+    if (!useTarget_) return false;
+    unsigned int width = columns_ * currentFont_->Width();
+    unsigned int height = rows_ * currentFont_->Height();
+    if (width <= 0 || height <= 0) return false;
+    if (!target_ || target_->getSize() != sf::Vector2u(width, height)) {
+        target_.reset(new sf::RenderTexture());
+        if (!target_->create(width, height)) {
+            // Without a render texture, the cells will be drawn on the screen.
+            target_.reset(nullptr);
+            targetSprite_.reset(nullptr);
+            useTarget_ = false;
+            return false;
+        }
+        target_->clear(sf::Color::Transparent);
+        targetSprite_.reset(new sf::Sprite(target_->getTexture()));
+        invalidate();
+    }
+    return true;
+}
+
+//--------------------------------------------------------------------------------
+
+/**
+ * Adds the quads of an area of cells to the vertex arrays.
+ */
+void TextConsole::appendCells(const sf::IntRect & area, const sf::Vector2i & origin,
+    sf::VertexArray & backgrounds, sf::VertexArray & characters) {
+    int width = currentFont_->Width();
+    int height = currentFont_->Height();
+    for (int i = area.top, rowsEnd = area.top + area.height; i < rowsEnd; ++i) {
+        for (int j = area.left, colsEnd = area.left + area.width; j < colsEnd; ++j) {
+            BufferCell & cell = textBuffer_[fromCoordsToIndex(i, j)];
+            int x = origin.x + j * width, y = origin.y + i * height;
+            float left = (float)x, top = (float)y;
+            float right = (float)(x + width), bottom = (float)(y + height);
+            sf::Color color = opaque_ ? cell.BackgroundColor : sf::Color::Transparent;
+            backgrounds.append(sf::Vertex(sf::Vector2f(left, top), color));
+            backgrounds.append(sf::Vertex(sf::Vector2f(right, top), color));
+            backgrounds.append(sf::Vertex(sf::Vector2f(right, bottom), color));
+            backgrounds.append(sf::Vertex(sf::Vector2f(left, bottom), color));
+            currentFont_->Append(characters, cell.CharData, x, y, cell.ForegroundColor);
+        }
+    }
+}
+
+//--------------------------------------------------------------------------------
+
 /**
  * Draws the current text buffer in the screen.
  */
 void TextConsole::Draw() {
     if (currentFont_ != nullptr) {
-        int width = currentFont_->Width();
-        int height = currentFont_->Height();
         CoreManager & core = CoreManager::Reference();
-        emptySprite_->setScale((float)width, (float)height);
-        sf::Vector2i dest(position_.x, position_.y);
-        for (int i = 0; i < rows_; ++i) {
-            dest.x = position_.x;
-            for (int j = 0; j < columns_; ++j) {
-                BufferCell & cell = textBuffer_[fromCoordsToIndex(i, j)];
-                if (opaque_) {
-                    emptySprite_->setColor(cell.BackgroundColor);
-                    emptySprite_->setPosition((float)dest.x, (float)dest.y);
-                    core.Draw(*emptySprite_);
+        sf::VertexArray backgrounds(sf::Quads), characters(sf::Quads);
+        sf::RenderStates fontStates(currentFont_->Texture());
+        if (updateTarget()) {
+            // We'll only rasterize again the areas changed since the last frame,
+            // replacing the old pixels of the cells with the new backgrounds.
+            if (!dirtyAreas_.empty()) {
+                for (int k = 0, len = dirtyAreas_.size(); k < len; ++k) {
+                    appendCells(dirtyAreas_[k], sf::Vector2i(0, 0), backgrounds, characters);
                 }
-                currentFont_->Draw(cell.CharData, dest.x, dest.y, cell.ForegroundColor);
-                dest.x += width;
+                target_->draw(backgrounds, sf::RenderStates(sf::BlendNone));
+                target_->draw(characters, fontStates);
+                target_->display();
+                dirtyAreas_.clear();
             }
-            dest.y += height;
+            // And then we'll draw the whole render texture on the screen.
+            targetSprite_->setPosition((float)position_.x, (float)position_.y);
+            core.Draw(*targetSprite_);
+        } else {
+            appendCells(sf::IntRect(0, 0, columns_, rows_), position_, backgrounds, characters);
+            core.Draw(backgrounds);
+            core.Draw(characters, fontStates);
         }
     }
 }
@@ -287,19 +390,9 @@ TextConsole * TextConsole::instance_ = nullptr;
  */
 TextConsole::TextConsole() : position_(0, 0), columns_(0), rows_(0),
     width_(0), height_(0), opaque_(true), clearColor_(sf::Color::Black),
-    currentFont_(nullptr), textBuffer_(), cursorPosition_(0, 0),
-    foregroundColor_(sf::Color::White), backgroundColor_(sf::Color::Black) {
-    // Create the empty texture from the memory.
-    sf::Image image;
-    image.create(1, 1, sf::Color::White);
-    emptyTexture_.reset(new sf::Texture());
-    if (emptyTexture_->loadFromImage(image)) {
-        // Create the sprite to draw the empty texture.
-        emptySprite_.reset(new sf::Sprite(*emptyTexture_));
-    } else {
-        emptyTexture_.reset(nullptr);
-    }
-}
+    currentFont_(nullptr), textBuffer_(), target_(nullptr), targetSprite_(nullptr),
+    dirtyAreas_(), useTarget_(true), cursorPosition_(0, 0),
+    foregroundColor_(sf::Color::White), backgroundColor_(sf::Color::Black) {}
 
 //--------------------------------------------------------------------------------
 
@@ -308,8 +401,9 @@ TextConsole::TextConsole() : position_(0, 0), columns_(0), rows_(0),
  */
 TextConsole::~TextConsole() {
     textBuffer_.clear();
-    emptySprite_.reset(nullptr);
-    emptyTexture_.reset(nullptr);
+    dirtyAreas_.clear();
+    targetSprite_.reset(nullptr);
+    target_.reset(nullptr);
 }
 
 //--------------------------------------------------------------------------------
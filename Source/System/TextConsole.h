@@ -27,18 +27,21 @@
 #include <vector>
 #include <string>
 #include <SFML/Graphics/Color.hpp>
+#include <SFML/Graphics/Rect.hpp>
 #include <SFML/System/Vector2.hpp>
 
 namespace sf {
-    class Texture;
+    class RenderTexture;
     class Sprite;
+    class VertexArray;
 }
 
 class BitmapFont;
 
 /**
  * This singleton class represents a text console, used to simulate stuff like
- * the old text mode DOS games.
+ * the old text mode DOS games. The cells are rasterized inside a render texture
+ * and only the areas changed since the last frame are rasterized again.
  */
 class TextConsole {
 public:
@@ -56,7 +59,7 @@ public:
     int Height() const { return height_; }
 
     bool Opaque() const { return opaque_; }
-    void Opaque(bool value) { opaque_ = value; }
+    void Opaque(bool value) { if (opaque_ != value) { opaque_ = value; invalidate(); } }
 
     const sf::Color & ClearColor() const { return clearColor_; }
     void ClearColor(const sf::Color & value) { clearColor_ = value; }
@@ -117,7 +120,8 @@ private:
     };
 
     typedef std::vector<BufferCell> BufferCellVector;
-    typedef std::unique_ptr<sf::Texture> UniqueTexture;
+    typedef std::vector<sf::IntRect> IntRectVector;
+    typedef std::unique_ptr<sf::RenderTexture> UniqueRenderTexture;
     typedef std::unique_ptr<sf::Sprite> UniqueSprite;
 
     //--------------------------------------------------------------------------------
@@ -133,8 +137,10 @@ private:
     sf::Color clearColor_;          // The clear color.
     BitmapFont * currentFont_;      // The font.
     BufferCellVector textBuffer_;   // The text buffer.
-    UniqueTexture emptyTexture_;    // The empty texture used to clear the background.
-    UniqueSprite emptySprite_;      // The sprite of the empty texture.
+    UniqueRenderTexture target_;    // The render texture with the rasterized cells.
+    UniqueSprite targetSprite_;     // The sprite of the render texture.
+    IntRectVector dirtyAreas_;      // The areas of cells to rasterize again.
+    bool useTarget_;                // The render texture available flag.
     sf::Vector2i cursorPosition_;   // The position of the cursor.
     sf::Color foregroundColor_;     // The foreground color of the text.
     sf::Color backgroundColor_;     // The background color of the text.
@@ -146,6 +152,12 @@ private:
     void createTextBuffer(int columns, int rows);
     void writeCell(int i, int j, char item);
 
+    void invalidate();
+    void invalidate(int row, int col, int width, int height);
+    bool updateTarget();
+    void appendCells(const sf::IntRect & area, const sf::Vector2i & origin,
+        sf::VertexArray & backgrounds, sf::VertexArray & characters);
+
     int fromCoordsToIndex(int i, int j) { return i * columns_ + j; }
 
     //--------------------------------------------------------------------------------
@@ -25,12 +25,7 @@
 #include <SFML/Graphics/Texture.hpp>
 #include <SFML/Graphics/Sprite.hpp>
 #include <System/CoreManager.h>
-
-//********************************************************************************
-// Static
-//********************************************************************************
-
-SharedRenderWindow Texture2D::renderWindow_ = nullptr;
+#include <System/SpriteBatch.h>
 
 //********************************************************************************
 // Properties
@@ -60,8 +55,6 @@ int Texture2D::Height() const {
  * Creates a surface from a color.
  */
 bool Texture2D::Load(int width, int height, const sf::Color & color) {
-    auto * core = CoreManager::Instance();
-    renderWindow_ = core->window_;
     Unload();
 
     sf::Image image;
@@ -79,7 +72,6 @@ bool Texture2D::Load(int width, int height, const sf::Color & color) {
  */
 bool Texture2D::Load(const std::string & path, bool smooth) {
     auto * core = CoreManager::Instance();
-    renderWindow_ = core->window_;
     Unload();
 
     texture_ = core->LoadTexture(path, smooth);
@@ -94,7 +86,6 @@ bool Texture2D::Load(const std::string & path, bool smooth) {
  * Loads a surface from the memory.
  */
 bool Texture2D::Load(SharedTexture & texture) {
-    renderWindow_ = CoreManager::Instance()->window_;
     Unload();
 
     texture_ = texture;
@@ -108,7 +99,6 @@ bool Texture2D::Load(SharedTexture & texture) {
  * Loads a surface from the memory.
  */
 bool Texture2D::Load(SharedTexture & texture, const sf::IntRect & sourceArea) {
-    renderWindow_ = CoreManager::Instance()->window_;
     Unload();
 
     texture_ = texture;
@@ -122,6 +112,7 @@ bool Texture2D::Load(SharedTexture & texture, const sf::IntRect & sourceArea) {
  * Unloads the current surface.
  */
 void Texture2D::Unload() {
+    SpriteBatch::Release(texture_.get());
     sprite_ = nullptr;
     texture_ = nullptr;
 }
@@ -150,9 +141,7 @@ void Texture2D::Draw(const sf::Vector2i & position) {
  * Draws a surface on the screen.
  */
 void Texture2D::Draw(int x, int y, const sf::Color & color) {
-    sprite_->setColor(color);
-    sprite_->setPosition((float)x, (float)y);
-    renderWindow_->draw(*sprite_);
+    SpriteBatch::Draw(texture_.get(), sprite_->getTextureRect(), x, y, color);
 }
 
 //--------------------------------------------------------------------------------
@@ -164,6 +153,15 @@ void Texture2D::Draw(const sf::Vector2i & position, const sf::Color & color) {
     Draw(position.x, position.y, color);
 }
 
+//--------------------------------------------------------------------------------
+
+/**
+ * Adds the quad of the surface to a vertex array.
+ */
+void Texture2D::Append(sf::VertexArray & victim, int x, int y, const sf::Color & color) {
+    SpriteBatch::AppendQuad(victim, sprite_->getTextureRect(), x, y, color);
+}
+
 //********************************************************************************
 // Constructors, destructor and operators
 //********************************************************************************
@@ -28,8 +28,12 @@
 #include <SFML/Graphics/Color.hpp>
 #include <System/SharedTypes.h>
 
+namespace sf {
+    class VertexArray;
+}
+
 /**
- * This class represents a 2D texture surface.
+ * This class represents a 2D texture surface, drawn through the sprite batch.
  */
 class Texture2D {
 public:
@@ -53,6 +57,7 @@ public:
     void Draw(const sf::Vector2i & position);
     void Draw(int x, int y, const sf::Color & color);
     void Draw(const sf::Vector2i & position, const sf::Color & color);
+    void Append(sf::VertexArray & victim, int x, int y, const sf::Color & color = sf::Color::White);
 
     //--------------------------------------------------------------------------------
     // Constructors, destructor and operators
@@ -70,12 +75,6 @@ private:
 
     SharedTexture texture_; // The texture of the surface.
     SharedSprite sprite_;   // The sprite of the surface.
-
-    //--------------------------------------------------------------------------------
-    // Static
-    //--------------------------------------------------------------------------------
-
-    static SharedRenderWindow renderWindow_;
 };
 
 #endif
@@ -0,0 +1,242 @@
+/******************************************************************************
+ Copyright (c) 2014 Gorka Surez Garca
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ DEALINGS IN THE SOFTWARE.
+******************************************************************************/
+
+#include "ThinkService.h"
+#include <SFML/System/Lock.hpp>
+#include <SFML/System/Sleep.hpp>
+#include <System/CoreManager.h>
+#include <System/SafeDelete.h>
+
+//********************************************************************************
+// Constants
+//********************************************************************************
+
+const sf::Time WAIT_TIME = sf::milliseconds(1);
+const sf::Time IDLE_TIME = sf::milliseconds(2);
+
+//********************************************************************************
+// ThinkTask
+//********************************************************************************
+
+/**
+ * Cancels the task, a waiting task will not be executed.
+ */
+void ThinkTask::Cancel() {
+    cancelled_ = true;
+}
+
+//--------------------------------------------------------------------------------
+
+/**
+ * Waits until the end of the task.
+ */
+void ThinkTask::Wait() const {
+    while (!finished_) {
+        sf::sleep(WAIT_TIME);
+    }
+}
+
+//--------------------------------------------------------------------------------
+
+/**
+ * Executes the job of the task.
+ */
+void ThinkTask::run() {
+    if (job_) job_(*this);
+}
+
+//--------------------------------------------------------------------------------
+
+/**
+ * Constructs a new object.
+ */
+ThinkTask::ThinkTask() : job_(), cancelled_(false), finished_(false) {}
+
+//--------------------------------------------------------------------------------
+
+/**
+ * Constructs a new object.
+ */
+ThinkTask::ThinkTask(const Function & job) : job_(job), cancelled_(false), finished_(false) {}
+
+//--------------------------------------------------------------------------------
+
+/**
+ * The destructor of the object.
+ */
+ThinkTask::~ThinkTask() {}
+
+//********************************************************************************
+// Methods
+//********************************************************************************
+
+/**
+ * Initializes the pool with a thread for each processor of the machine.
+ */
+void ThinkService::Initialize() {
+    Initialize(CoreManager::Instance()->ProcessorCount());
+}
+
+//--------------------------------------------------------------------------------
+
+/**
+ * Initializes the pool of threads.
+ */
+void ThinkService::Initialize(int workers) {
+    Release();
+    running_ = true;
+    if (workers < 1) workers = 1;
+    current_.resize(workers);
+    for (int i = 0; i < workers; ++i) {
+        workers_.push_back(new sf::Thread([this, i] () { work(i); }));
+        workers_.back()->launch();
+    }
+}
+
+//--------------------------------------------------------------------------------
+
+/**
+ * Releases the pool of threads, cancelling all the tasks.
+ */
+void ThinkService::Release() {
+    {
+        // Cancel the waiting tasks and the ones inside the threads.
+        sf::Lock lock(mutex_);
+        running_ = false;
+        for (auto it = tasks_.begin(), end = tasks_.end(); it != end; ++it) {
+            (*it)->Cancel();
+            (*it)->finished_ = true;
+        }
+        tasks_.clear();
+        for (auto it = current_.begin(), end = current_.end(); it != end; ++it) {
+            if (*it) (*it)->Cancel();
+        }
+    }
+    // And then wait the end of the threads.
+    for (auto it = workers_.begin(), end = workers_.end(); it != end; ++it) {
+        (*it)->wait();
+        SafeDelete(*it);
+    }
+    workers_.clear();
+    current_.clear();
+}
+
+//--------------------------------------------------------------------------------
+
+/**
+ * Adds a new job to the queue of the pool.
+ */
+SharedThinkTask ThinkService::Submit(const ThinkTask::Function & job) {
+    SharedThinkTask task(new ThinkTask(job));
+    enqueue(task);
+    return task;
+}
+
+//--------------------------------------------------------------------------------
+
+/**
+ * Adds a new task to the queue of the pool.
+ */
+void ThinkService::enqueue(const SharedThinkTask & task) {
+    if (workers_.empty()) {
+        Initialize();
+    }
+    sf::Lock lock(mutex_);
+    tasks_.push_back(task);
+}
+
+//--------------------------------------------------------------------------------
+
+/**
+ * The main loop of a thread of the pool.
+ */
+void ThinkService::work(int index) {
+    while (running_) {
+        // Take the next task of the queue.
+        SharedThinkTask task;
+        {
+            sf::Lock lock(mutex_);
+            if (!tasks_.empty() && running_) {
+                task = tasks_.front();
+                tasks_.pop_front();
+                current_[index] = task;
+            }
+        }
+        if (task) {
+            // The tasks cancelled in the queue are finished without any execution.
+            if (!task->Cancelled()) {
+                task->run();
+            }
+            task->finished_ = true;
+            sf::Lock lock(mutex_);
+            current_[index] = nullptr;
+        } else {
+            sf::sleep(IDLE_TIME);
+        }
+    }
+}
+
+//********************************************************************************
+// Singleton pattern ( http://en.wikipedia.org/wiki/Singleton_pattern )
+//********************************************************************************
+
+/**
+ * The main instance of the class.
+ */
+ThinkService * ThinkService::instance_ = nullptr;
+
+//--------------------------------------------------------------------------------
+
+/**
+ * Constructs a new object.
+ */
+ThinkService::ThinkService() : workers_(), current_(), tasks_(), mutex_(), running_(false) {}
+
+//--------------------------------------------------------------------------------
+
+/**
+ * The destructor of the object.
+ */
+ThinkService::~ThinkService() {
+    Release();
+}
+
+//--------------------------------------------------------------------------------
+
+/**
+ * Gets the main instance of the class.
+ */
+ThinkService * ThinkService::Instance() {
+    if (!instance_) {
+        instance_ = new ThinkService();
+    }
+    return instance_;
+}
+
+//--------------------------------------------------------------------------------
+
+/**
+ * Gets the main instance of the class.
+ */
+ThinkService & ThinkService::Reference() {
+    return *(Instance());
+}
@@ -0,0 +1,176 @@
+/******************************************************************************
+ Copyright (c) 2014 Gorka Surez Garca
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ DEALINGS IN THE SOFTWARE.
+******************************************************************************/
+
+#ifndef __THINK_SERVICE_HEADER__
+#define __THINK_SERVICE_HEADER__
+
+#include <deque>
+#include <vector>
+#include <memory>
+#include <functional>
+#include <SFML/System/Mutex.hpp>
+#include <SFML/System/Thread.hpp>
+
+/**
+ * This class represents a job submitted to the think service. The owner keeps the
+ * task to poll it every frame, and it can cancel the task when it isn't needed.
+ * The jobs must check the cancel flag to end as soon as possible.
+ */
+class ThinkTask {
+public:
+    friend class ThinkService;
+
+    //--------------------------------------------------------------------------------
+    // Types
+    //--------------------------------------------------------------------------------
+
+    typedef std::function<void (const ThinkTask &)> Function;
+
+    //--------------------------------------------------------------------------------
+    // Properties
+    //--------------------------------------------------------------------------------
+
+    bool Finished() const { return finished_; }
+    bool Cancelled() const { return cancelled_; }
+
+    //--------------------------------------------------------------------------------
+    // Methods
+    //--------------------------------------------------------------------------------
+
+    void Cancel();
+    void Wait() const;
+
+    //--------------------------------------------------------------------------------
+    // Constructors, destructor and operators
+    //--------------------------------------------------------------------------------
+
+    ThinkTask(const Function & job);
+    virtual ~ThinkTask();
+
+protected:
+    ThinkTask();
+    virtual void run();
+
+private:
+    //--------------------------------------------------------------------------------
+    // Fields
+    //--------------------------------------------------------------------------------
+
+    Function job_;
+    volatile bool cancelled_;
+    volatile bool finished_;
+
+    ThinkTask(const ThinkTask & source);
+    ThinkTask & operator =(const ThinkTask & source);
+};
+
+/**
+ * This class represents a job of the think service that returns a result.
+ */
+template <class T>
+class ThinkJob : public ThinkTask {
+public:
+    typedef std::function<T (const ThinkTask &)> Function;
+
+    const T & Result() const { return result_; }
+
+    ThinkJob(const Function & job) : job_(job), result_() {}
+    virtual ~ThinkJob() {}
+
+protected:
+    virtual void run() { result_ = job_(*this); }
+
+private:
+    Function job_;
+    T result_;
+};
+
+/**
+ * This type represents a shared think task.
+ */
+typedef std::shared_ptr<ThinkTask> SharedThinkTask;
+
+/**
+ * This singleton class represents the service that thinks the moves of the machine
+ * in the background. The tasks are executed in a pool of threads sized to the
+ * processors of the machine, so the main loop doesn't wait for the searches.
+ */
+class ThinkService {
+public:
+    //--------------------------------------------------------------------------------
+    // Properties
+    //--------------------------------------------------------------------------------
+
+    int Workers() const { return static_cast<int>(workers_.size()); }
+
+    //--------------------------------------------------------------------------------
+    // Methods
+    //--------------------------------------------------------------------------------
+
+    void Initialize();
+    void Initialize(int workers);
+    void Release();
+
+    SharedThinkTask Submit(const ThinkTask::Function & job);
+
+    template <class T>
+    std::shared_ptr<ThinkJob<T>> Submit(const typename ThinkJob<T>::Function & job) {
+        std::shared_ptr<ThinkJob<T>> task(new ThinkJob<T>(job));
+        enqueue(task);
+        return task;
+    }
+
+    //--------------------------------------------------------------------------------
+    // Singleton pattern
+    //--------------------------------------------------------------------------------
+
+    static ThinkService * Instance();
+    static ThinkService & Reference();
+    ~ThinkService();
+
+private:
+    //--------------------------------------------------------------------------------
+    // Fields
+    //--------------------------------------------------------------------------------
+
+    std::vector<sf::Thread *> workers_;
+    std::vector<SharedThinkTask> current_;
+    std::deque<SharedThinkTask> tasks_;
+    sf::Mutex mutex_;
+    volatile bool running_;
+
+    //--------------------------------------------------------------------------------
+    // Methods
+    //--------------------------------------------------------------------------------
+
+    void enqueue(const SharedThinkTask & task);
+    void work(int index);
+
+    //--------------------------------------------------------------------------------
+    // Singleton pattern
+    //--------------------------------------------------------------------------------
+
+    static ThinkService * instance_;
+    ThinkService();
+};
+
+#endif
@@ -61,6 +61,9 @@
 #include <stdlib.h>
 #include <System/CoreManager.h>
 #include <Games/SaveManager.h>
+#include <Games/Chess/ChessBenchmark.h>
+#include <Games/Reversi/ReversiBenchmark.h>
+#include <Games/Puzzle/PuzzleBenchmark.h>
 
 #if defined(WIN32) && defined(NDEBUG)
 #define WIN32_LEAN_AND_MEAN
@@ -68,6 +71,12 @@
 #endif
 
 int main(int argc, char ** argv) {
+    int result = EXIT_SUCCESS;
+    if (ChessBenchmark::Execute(argc, argv, result) ||
+        ReversiBenchmark::Execute(argc, argv, result) ||
+        PuzzleBenchmark::Execute(argc, argv, result)) {
+        return result;
+    }
 #if defined(WIN32) && defined(NDEBUG)
     FreeConsole();
 #endif